@@ -18,6 +18,9 @@
 #include <utility/trace.h>
 #include <utility/math.h>
 #include <memories/nandflash/SkipBlockNandFlash.h>
+#if defined(NANDFLASH_DMA)
+#include <dma/dma.h>
+#endif
 
 #include <string.h>
 
@@ -152,6 +155,11 @@ int main()
     // Reconfigure bus width
     BOARD_ConfigureNandFlash(nfBusWidth);
 
+#if defined(NANDFLASH_DMA)
+    // Page data is moved by the DMA controller
+    RawNandFlash_ConfigureDma(&skipBlockNf.ecc.raw, DMA_CHANNEL_0);
+#endif
+
     TRACE_INFO("\tNandflash driver initialized\n\r");
 
     // Get device parameters
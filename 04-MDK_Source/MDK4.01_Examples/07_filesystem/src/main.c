@@ -93,8 +93,8 @@ typedef unsigned long   DWORD;
 /// Size of the RAM Disk in bytes.
 #define RAMDISK_SIZE        (10*1024*1024)
 
-/// Size of the MSD IO buffer in bytes (2K, more the better).
-#define MSD_BUFFER_SIZE     (4*BLOCK_SIZE)
+/// Size of the MSD IO buffer in bytes (two 8K chunks, more the better).
+#define MSD_BUFFER_SIZE     (32*BLOCK_SIZE)
 
 /// Name of the test file.
 #define FILE_1              "test.bin"
@@ -152,7 +152,7 @@ Media medias[MAX_LUNS];
 static MSDLun luns[MAX_LUNS];
 
 /// LUN read/write buffer.
-static unsigned char msdBuffer[BLOCK_SIZE];
+static unsigned char msdBuffer[MSD_BUFFER_SIZE];
 
 /// Time Tick 1ms
 static unsigned int timeTick;
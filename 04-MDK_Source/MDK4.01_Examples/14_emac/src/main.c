@@ -373,6 +373,8 @@ int main(void)
             printf(" .rx_eof = %d\n\r", stats.rx_eof);
             printf(" .rx_ovrs = %d\n\r", stats.rx_ovrs);
             printf(" .rx_bnas = %d\n\r", stats.rx_bnas);
+            printf(" .rx_resource_errs = %d\n\r", stats.rx_resource_errs);
+            printf(" .rx_overrun_frames = %d\n\r", stats.rx_overrun_frames);
         }
 
         // Process packets
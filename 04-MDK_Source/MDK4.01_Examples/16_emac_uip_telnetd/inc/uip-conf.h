@@ -146,6 +146,38 @@ typedef unsigned short uip_stats_t;
  */
 #define UIP_CONF_LLH_LEN         14
 
+/**
+ * Use the checksum functions of uip_arch.c, optimised for 32-bit CPUs.
+ *
+ * \hideinitializer
+ */
+#define UIP_ARCH_CHKSUM          1
+
+/**
+ * Send buffers on or off, letting connections that attach one keep
+ * several segments in flight.
+ *
+ * \hideinitializer
+ */
+#define UIP_CONF_SENDBUF         1
+
+/**
+ * Size of the send window of a buffered connection, in segments.
+ *
+ * \hideinitializer
+ */
+#define UIP_CONF_SENDBUF_SEGMENTS 4
+
+/**
+ * ARP table size, pinning of the default router's entry and queueing
+ * of the packet that triggers an ARP request.
+ *
+ * \hideinitializer
+ */
+#define UIP_CONF_ARPTAB_SIZE     256
+#define UIP_CONF_ARP_PIN_DRADDR  1
+#define UIP_CONF_ARP_QUEUE       1
+
 /**
  * Broadcast support.
  *
@@ -168,6 +200,8 @@ typedef unsigned short uip_stats_t;
   #undef UIP_CONF_BROADCAST
   #define UIP_CONF_BROADCAST 1
  #endif
+/* Keep the lease in the backup domain across resets */
+#define DHCPC_CONF_LEASE_STORE 1
 #include "dhcpc.h"
 #endif
 
@@ -190,6 +190,21 @@ int main(void)
             }
         }
 
+#if UIP_SENDBUF
+        // uIP sends one segment per call: keep polling the buffered
+        // connections until their send window is full.
+        for(i = 0; i < UIP_CONNS; i++) {
+            while(uip_sendbuf_ready(&uip_conns[i])) {
+                uip_poll_conn(&uip_conns[i]);
+                if(uip_len == 0) {
+                    break;
+                }
+                uip_arp_out();
+                tapdev_send();
+            }
+        }
+#endif /* UIP_SENDBUF */
+
         // Display Statistics
         if ( USART_IsDataAvailable((AT91S_USART *)AT91C_BASE_DBGU) ) {
 
@@ -208,6 +223,8 @@ int main(void)
             printf(" .rx_eof = %d\n\r", stats.rx_eof);
             printf(" .rx_ovrs = %d\n\r", stats.rx_ovrs);
             printf(" .rx_bnas = %d\n\r", stats.rx_bnas);
+            printf(" .rx_resource_errs = %d\n\r", stats.rx_resource_errs);
+            printf(" .rx_overrun_frames = %d\n\r", stats.rx_overrun_frames);
         }
     }
 
@@ -37,4 +37,6 @@
 typedef int clock_time_t;
 #define CLOCK_CONF_SECOND 1000
 
+unsigned int clock_time_us(void);
+
 #endif /* __CLOCK_ARCH_H__ */
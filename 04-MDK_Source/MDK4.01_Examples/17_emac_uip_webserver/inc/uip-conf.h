@@ -146,6 +146,67 @@ typedef unsigned short uip_stats_t;
  */
 #define UIP_CONF_LLH_LEN         14
 
+/**
+ * Use the checksum functions of uip_arch.c, optimised for 32-bit CPUs.
+ *
+ * \hideinitializer
+ */
+#define UIP_ARCH_CHKSUM          1
+
+/**
+ * Send buffers on or off, letting connections that attach one keep
+ * several segments in flight.
+ *
+ * \hideinitializer
+ */
+#define UIP_CONF_SENDBUF         1
+
+/**
+ * Size of the send window of a buffered connection, in segments.
+ *
+ * \hideinitializer
+ */
+#define UIP_CONF_SENDBUF_SEGMENTS 4
+
+/**
+ * ARP table size, pinning of the default router's entry and queueing
+ * of the packet that triggers an ARP request.
+ *
+ * \hideinitializer
+ */
+#define UIP_CONF_ARPTAB_SIZE     256
+#define UIP_CONF_ARP_PIN_DRADDR  1
+#define UIP_CONF_ARP_QUEUE       1
+
+/**
+ * Web server: serve files missing from the ROM image from FAT volume
+ * 0, which needs the FatFs sources, a fatfs_config.h and a media
+ * driver in the project.
+ *
+ * \hideinitializer
+ */
+#define HTTPD_CONF_FS_FATFS      0
+
+/**
+ * Web server: number of files of the FAT volume sent at once, each
+ * with a FatFs FIL of about 550 bytes. They are shared by all
+ * connections; one per connection would take 22 KB here.
+ *
+ * \hideinitializer
+ */
+#define HTTPD_CONF_FS_FATFS_FILES 2
+
+/**
+ * Web server: size and number of the buffers for pipelined requests.
+ * They are shared by all connections and take 4 * 512 = 2 KB of RAM;
+ * one buffer per connection would take UIP_CONF_MAX_CONNECTIONS times
+ * the size, 20 KB here.
+ *
+ * \hideinitializer
+ */
+#define HTTPD_CONF_PIPELINE_SIZE 512
+#define HTTPD_CONF_PIPELINE_BUFFERS 4
+
 /**
  * Broadcast support.
  *
@@ -157,7 +218,23 @@ typedef unsigned short uip_stats_t;
 /* Here we include the header file for the application(s) we use in
    our project. */
 
+/* The optional applications: the switches come first, since each
+   block below depends on the others. */
+
+/* DHCP client */
 //#define UIP_DHCP_on
+/* TFTP server, uploads to DDRAM */
+//#define UIP_TFTPD_on
+/* Capture the frames into a ring, served as /capture.pcap */
+//#define UIP_PCAP_on
+
+#if defined(UIP_DHCP_on) && defined(UIP_TFTPD_on)
+/* Both serve UDP and keep no per-connection state: main.c hands each
+   packet to its application */
+typedef u8_t uip_udp_appstate_t;
+#define UIP_UDP_APPCALL udp_appcall
+void udp_appcall(void);
+#endif
 
 #ifdef UIP_DHCP_on
  #if !UIP_CONF_UDP
@@ -168,9 +245,23 @@ typedef unsigned short uip_stats_t;
   #undef UIP_CONF_BROADCAST
   #define UIP_CONF_BROADCAST 1
  #endif
+/* Keep the lease in the backup domain across resets */
+#define DHCPC_CONF_LEASE_STORE 1
 #include "dhcpc.h"
 #endif
 
+#ifdef UIP_TFTPD_on
+ #if !UIP_CONF_UDP
+  #undef UIP_CONF_UDP
+  #define UIP_CONF_UDP 1
+ #endif
+#include "tftpd.h"
+#endif
+
+#ifdef UIP_PCAP_on
+#define HTTPD_CONF_FS_PCAP 1
+#endif
+
 #include "webserver.h"
 
 #endif /* __UIP_CONF_H__ */
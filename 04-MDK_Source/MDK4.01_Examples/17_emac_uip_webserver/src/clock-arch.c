@@ -54,7 +54,7 @@
 //-----------------------------------------------------------------------------
 
 /// clock tick count
-static unsigned int clockTick;
+static volatile unsigned int clockTick;
 
 //-----------------------------------------------------------------------------
 ///        Local functions
@@ -114,4 +114,22 @@ clock_time(void)
 {
     return clockTick;
 }
+
+//-----------------------------------------------------------------------------
+/// Read for clock time (us), wrapping every 71 minutes
+//-----------------------------------------------------------------------------
+unsigned int
+clock_time_us(void)
+{
+    unsigned int tick, cv;
+
+    // Read again if the tick has changed meanwhile
+    do {
+        tick = clockTick;
+        cv = AT91C_BASE_TC0->TC_CV;
+    } while (tick != clockTick);
+
+    return tick * (1000000 / CLOCK_CONF_SECOND)
+           + cv * (1000000 / CLOCK_CONF_SECOND) / AT91C_BASE_TC0->TC_RC;
+}
 /*---------------------------------------------------------------------------*/
@@ -16,6 +16,13 @@
 #include "uip_arp.h"
 #include "tapdev.h"
 #include "timer.h"
+#ifdef __TFTPD_H__
+#include <memories/MEDDdram.h>
+#endif
+#if HTTPD_FS_PCAP
+#include <emac/emac.h>
+#include <pcap/pcap.h>
+#endif
 
 //-----------------------------------------------------------------------------
 //         Local Define
@@ -24,6 +31,34 @@
 /// uIP buffer : The ETH header
 #define BUF ((struct uip_eth_hdr *)&uip_buf[0])
 
+#ifdef __TFTPD_H__
+/// TFTP uploads land in the upper half of the DDRAM, above the program
+#define TFTP_MEDIA_ADDRESS  (AT91C_DDR2 + 0x04000000)
+/// Size of the TFTP upload area
+#define TFTP_MEDIA_SIZE     0x02000000
+/// Block size of the TFTP upload area
+#define TFTP_MEDIA_BLOCK    512
+#endif
+
+#if HTTPD_FS_PCAP
+/// Bytes kept of each captured frame: the headers up to TCP options
+#define PCAP_SNAP_LENGTH    128
+#endif
+
+//-----------------------------------------------------------------------------
+//         Local variables
+//-----------------------------------------------------------------------------
+
+#ifdef __TFTPD_H__
+/// Media the TFTP server writes
+static Media tftpMedia;
+#endif
+
+#if HTTPD_FS_PCAP
+/// Capture ring, in DDRAM with the program
+static unsigned char pcapBuffer[1024 * 1024];
+#endif
+
 //-----------------------------------------------------------------------------
 //         Global functions
 //-----------------------------------------------------------------------------
@@ -76,6 +111,24 @@ void dhcpc_configured(void *s)
 }
 #endif /* __DHCPC_H__ */
 
+#if defined(__DHCPC_H__) && defined(__TFTPD_H__)
+//-----------------------------------------------------------------------------
+/// Global function for uIP to pass UDP packets, dispatched on local port
+//-----------------------------------------------------------------------------
+void udp_appcall(void)
+{
+    // DHCP client port
+    if (uip_udp_conn->lport == HTONS(68)) {
+
+        dhcpc_appcall();
+    }
+    else {
+
+        tftpd_appcall();
+    }
+}
+#endif
+
 //-----------------------------------------------------------------------------
 /// Initialize demo application
 //-----------------------------------------------------------------------------
@@ -85,6 +138,21 @@ static void app_init(void)
     printf("webserver\n\r");
     httpd_init();
 
+#if HTTPD_FS_PCAP
+    printf("P: Capture to %s\n\r", HTTPD_FS_PCAP_NAME);
+    PCAP_Init(pcapBuffer, sizeof(pcapBuffer), PCAP_SNAP_LENGTH, clock_time_us);
+    EMAC_Set_CaptureCb(PCAP_Capture);
+#endif
+
+#ifdef __TFTPD_H__
+    printf("P: TFTPD Init\n\r");
+    MEDDdram_Initialize(&tftpMedia,
+                        TFTP_MEDIA_BLOCK,
+                        TFTP_MEDIA_ADDRESS / TFTP_MEDIA_BLOCK,
+                        TFTP_MEDIA_SIZE / TFTP_MEDIA_BLOCK);
+    tftpd_init(&tftpMedia);
+#endif
+
 #ifdef __DHCPC_H__
     printf("P: DHCPC Init\n\r");
     dhcpc_init(MacAddress.addr, 6);
@@ -100,6 +168,9 @@ int main(void)
     uip_ipaddr_t ipaddr;
     struct timer periodic_timer, arp_timer;
     unsigned int i;
+#ifdef __TFTPD_H__
+    struct uip_udp_conn *pUdpConn;
+#endif
 
     // System devices initialize
     tapdev_init();
@@ -190,6 +261,34 @@ int main(void)
             }
         }
 
+#if UIP_SENDBUF
+        // uIP sends one segment per call: keep polling the buffered
+        // connections until their send window is full.
+        for(i = 0; i < UIP_CONNS; i++) {
+            while(uip_sendbuf_ready(&uip_conns[i])) {
+                uip_poll_conn(&uip_conns[i]);
+                if(uip_len == 0) {
+                    break;
+                }
+                uip_arp_out();
+                tapdev_send();
+            }
+        }
+#endif /* UIP_SENDBUF */
+
+#ifdef __TFTPD_H__
+        // Send the TFTP ACK held back for a buffer as soon as the media
+        // has written it, not at the next periodic timer
+        pUdpConn = tftpd_pending();
+        if(pUdpConn != NULL) {
+            uip_udp_periodic_conn(pUdpConn);
+            if(uip_len > 0) {
+                uip_arp_out();
+                tapdev_send();
+            }
+        }
+#endif
+
         // Display Statistics
         if ( USART_IsDataAvailable((AT91S_USART *)AT91C_BASE_DBGU) ) {
 
@@ -208,6 +307,8 @@ int main(void)
             printf(" .rx_eof = %d\n\r", stats.rx_eof);
             printf(" .rx_ovrs = %d\n\r", stats.rx_ovrs);
             printf(" .rx_bnas = %d\n\r", stats.rx_bnas);
+            printf(" .rx_resource_errs = %d\n\r", stats.rx_resource_errs);
+            printf(" .rx_overrun_frames = %d\n\r", stats.rx_overrun_frames);
         }
     }
 
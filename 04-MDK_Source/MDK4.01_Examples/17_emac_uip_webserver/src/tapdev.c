@@ -51,6 +51,7 @@
 #include "uip.h"
 #include "uip_arp.h"
 #include "tapdev.h"
+#include "timer.h"
 
 
 #include "uip.h"
@@ -69,6 +70,9 @@ static const Pin emacPins[] = {BOARD_EMAC_RUN_PINS};
 /// The DM9161 driver instance
 static Macb gMacb;
 
+/// PHY link polling period
+static struct timer linkTimer;
+
 //-----------------------------------------------------------------------------
 /// Emac interrupt handler
 //-----------------------------------------------------------------------------
@@ -77,12 +81,29 @@ static void ISR_Emac(void)
     EMAC_Handler();
 }
 
+//-----------------------------------------------------------------------------
+/// PHY link change callback
+//-----------------------------------------------------------------------------
+static void LinkChanged(unsigned char link,
+                        unsigned char speed,
+                        unsigned char fullDuplex)
+{
+    if (link) {
+
+        printf("P: Link detected, %s Mbps %s duplex\n\r",
+               speed ? "100" : "10", fullDuplex ? "full" : "half");
+    }
+    else {
+
+        printf("P: Link lost\n\r");
+    }
+}
+
 /*---------------------------------------------------------------------------*/
 void
 tapdev_init(void)
 {
     Macb       *pMacb = &gMacb;
-    unsigned int errCount = 0;
 
     TRACE_CONFIGURE(DBGU_STANDARD, 115200, BOARD_MCK);
     printf("-- Basic EMAC uIP Project %s --\n\r", SOFTPACK_VERSION);
@@ -127,18 +148,13 @@ tapdev_init(void)
         return;
     }
 
-    // Auto Negotiate
-    if (!MACB_AutoNegotiate(pMacb)) {
+    // Auto Negotiate, tapdev_read() follows the link from now on
+    if (!MACB_StartAutoNegotiate(pMacb, LinkChanged)) {
 
         printf("P: Auto Negotiate ERROR!\n\r");
         return;
     }
-
-    while( MACB_GetLinkSpeed(pMacb, 1) == 0 ) {
-
-        errCount++;
-    }
-    printf("P: Link detected\n\r");
+    timer_set(&linkTimer, CLOCK_SECOND / 10);
 
 
 }
@@ -150,6 +166,13 @@ unsigned int
 tapdev_read(void)
 {
     unsigned int pkt_len = 0;
+
+    if (timer_expired(&linkTimer)) {
+
+        timer_reset(&linkTimer);
+        MACB_PollLink(&gMacb);
+    }
+
     if( EMAC_RX_OK != EMAC_Poll( (unsigned char*)uip_buf,
                                   UIP_CONF_BUFFER_SIZE,
                                   &pkt_len) ) {
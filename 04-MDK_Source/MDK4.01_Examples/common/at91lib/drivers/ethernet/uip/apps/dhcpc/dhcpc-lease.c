@@ -0,0 +1,183 @@
+/**************************************************************************************
+* File Name          : dhcpc-lease.c
+* Description        : DHCP lease store of the at91 examples: the lease is kept in
+*                      the backup domain, which stays powered through resets
+**************************************************************************************/
+
+//-----------------------------------------------------------------------------
+//         Headers
+//-----------------------------------------------------------------------------
+
+#include <board.h>
+#include <utility/trace.h>
+#include <string.h>
+#include "uip.h"
+
+// uip-conf.h includes dhcpc.h when the DHCP client is built
+#ifdef __DHCPC_H__
+#if DHCPC_LEASE_STORE
+
+//-----------------------------------------------------------------------------
+// GPBR0 and GPBR2 hold the address and the router, GPBR3 the netmask prefix
+// length in its top 6 bits and the expiry time, counted in seconds by the RTT,
+// in the others. GPBR1 holds a check word computed over the three, which tells
+// a stored lease from the random contents the registers have after the backup
+// domain is powered up. The server id is not kept: the INIT-REBOOT request
+// does not carry it.
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+//         Local Define
+//-----------------------------------------------------------------------------
+
+/// RTT prescaler for 1 Hz from the 32.768 kHz slow clock
+#define LEASE_RTT_PRESCALER  0x8000
+/// Expiry time in GPBR3
+#define LEASE_EXPIRY_MASK    0x03FFFFFF
+/// Prefix length in GPBR3
+#define LEASE_PREFIX_SHIFT   26
+/// Seed of the check word
+#define LEASE_MAGIC          0x4C454153
+
+//-----------------------------------------------------------------------------
+//         Local functions
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/// Read the RTT, which counts asynchronously to the master clock
+//-----------------------------------------------------------------------------
+static unsigned int LeaseNow(void)
+{
+    unsigned int now;
+
+    do {
+        now = AT91C_BASE_RTTC->RTTC_RTVR;
+    } while (now != AT91C_BASE_RTTC->RTTC_RTVR);
+
+    return now;
+}
+
+//-----------------------------------------------------------------------------
+/// Compute the check word of a lease: the FNV-1a hash of its words, seeded
+/// with LEASE_MAGIC
+/// \param address Value of GPBR0
+/// \param router Value of GPBR2
+/// \param expiry Value of GPBR3
+//-----------------------------------------------------------------------------
+static unsigned int LeaseCheck(unsigned int address,
+                               unsigned int router,
+                               unsigned int expiry)
+{
+    unsigned int words[3];
+    unsigned int hash = LEASE_MAGIC;
+    unsigned int i;
+
+    words[0] = address;
+    words[1] = router;
+    words[2] = expiry;
+    for (i = 0; i < 12; i++) {
+
+        hash = (hash ^ ((words[i / 4] >> ((i % 4) * 8)) & 0xFF)) * 16777619;
+    }
+
+    return hash;
+}
+
+//-----------------------------------------------------------------------------
+//         Global functions
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/// Global function for uIP DHCPC to use, get the lease saved before reset
+/// \param s Pointer to DHCP state instance to fill
+/// \return 1 if the lease has not expired, 0 otherwise
+//-----------------------------------------------------------------------------
+int dhcpc_lease_load(struct dhcpc_state *s)
+{
+    unsigned int address = AT91C_BASE_SYS->SYS_GPBR[0];
+    unsigned int router = AT91C_BASE_SYS->SYS_GPBR[2];
+    unsigned int expiry = AT91C_BASE_SYS->SYS_GPBR[3];
+    unsigned int prefix = expiry >> LEASE_PREFIX_SHIFT;
+    unsigned int mask, left;
+    u8_t * pAddr;
+
+    if (AT91C_BASE_SYS->SYS_GPBR[1] != LeaseCheck(address, router, expiry)) {
+
+        return 0;
+    }
+
+    // Setting the RTT mode restarts it: a lease saved against another
+    // time base is no use
+    if ((AT91C_BASE_RTTC->RTTC_RTMR & AT91C_RTTC_RTPRES) != LEASE_RTT_PRESCALER) {
+
+        AT91C_BASE_RTTC->RTTC_RTMR = LEASE_RTT_PRESCALER | AT91C_RTTC_RTTRST;
+        dhcpc_lease_store(0);
+        return 0;
+    }
+
+    left = (expiry - LeaseNow()) & LEASE_EXPIRY_MASK;
+    if (prefix == 0 || prefix > 32
+        || left == 0 || left > (LEASE_EXPIRY_MASK >> 1)) {
+
+        return 0;
+    }
+
+    memcpy(s->ipaddr, &address, 4);
+    memcpy(s->default_router, &router, 4);
+
+    mask = 0xFFFFFFFF << (32 - prefix);
+    pAddr = (u8_t *)s->netmask;
+    pAddr[0] = mask >> 24;
+    pAddr[1] = mask >> 16;
+    pAddr[2] = mask >> 8;
+    pAddr[3] = mask;
+
+    s->lease_time[0] = HTONS(left >> 16);
+    s->lease_time[1] = HTONS(left & 0xFFFF);
+
+    TRACE_INFO("DHCP lease restored, %u s left\n\r", left);
+    return 1;
+}
+
+//-----------------------------------------------------------------------------
+/// Global function for uIP DHCPC to use, save or forget the lease
+/// \param s Pointer to DHCP state instance, 0 to forget the lease
+//-----------------------------------------------------------------------------
+void dhcpc_lease_store(const struct dhcpc_state *s)
+{
+    unsigned int prefix = 0, lease, address, router, expiry, i;
+    const u8_t * pAddr;
+
+    // A reset while the registers are written leaves no valid lease
+    AT91C_BASE_SYS->SYS_GPBR[1] = ~LeaseCheck(AT91C_BASE_SYS->SYS_GPBR[0],
+                                              AT91C_BASE_SYS->SYS_GPBR[2],
+                                              AT91C_BASE_SYS->SYS_GPBR[3]);
+    if (s == 0) {
+
+        return;
+    }
+
+    pAddr = (const u8_t *)s->netmask;
+    for (i = 0; i < 32 && (pAddr[i / 8] & (0x80 >> (i % 8))); i++) {
+
+        prefix++;
+    }
+    lease = (ntohs(s->lease_time[0]) << 16) | ntohs(s->lease_time[1]);
+    if (lease > (LEASE_EXPIRY_MASK >> 1)) {
+
+        lease = LEASE_EXPIRY_MASK >> 1;
+    }
+
+    memcpy(&address, s->ipaddr, 4);
+    memcpy(&router, s->default_router, 4);
+    expiry = (prefix << LEASE_PREFIX_SHIFT)
+             | ((LeaseNow() + lease) & LEASE_EXPIRY_MASK);
+
+    AT91C_BASE_SYS->SYS_GPBR[0] = address;
+    AT91C_BASE_SYS->SYS_GPBR[2] = router;
+    AT91C_BASE_SYS->SYS_GPBR[3] = expiry;
+    AT91C_BASE_SYS->SYS_GPBR[1] = LeaseCheck(address, router, expiry);
+}
+
+#endif /* DHCPC_LEASE_STORE */
+#endif /* __DHCPC_H__ */
@@ -43,6 +43,7 @@
 #define STATE_SENDING         1
 #define STATE_OFFER_RECEIVED  2
 #define STATE_CONFIG_RECEIVED 3
+#define STATE_REBOOTING       4
 
 static struct dhcpc_state s;
 
@@ -188,7 +189,13 @@ send_request(void)
   create_msg(m);
   
   end = add_msg_type(&m->options[4], DHCPREQUEST);
-  end = add_server_id(end);
+  if(s.state == STATE_REBOOTING) {
+    /* INIT-REBOOT: no server id and no ciaddr, even though the cached
+       address is already in use (RFC 2131, 4.3.2). */
+    memset(m->ciaddr, 0, sizeof(m->ciaddr));
+  } else {
+    end = add_server_id(end);
+  }
   end = add_req_ipaddr(end);
   end = add_end(end);
   
@@ -247,7 +254,52 @@ parse_msg(void)
 static
 PT_THREAD(handle_dhcp(void))
 {
+#if DHCPC_LEASE_STORE
+  u8_t type;
+  uip_ipaddr_t addr;
+#endif /* DHCPC_LEASE_STORE */
+
   PT_BEGIN(&s.pt);
+
+#if DHCPC_LEASE_STORE
+  if(s.state == STATE_REBOOTING) {
+    s.ticks = CLOCK_SECOND;
+
+    do {
+      send_request();
+      timer_set(&s.timer, s.ticks);
+      PT_YIELD_UNTIL(&s.pt, uip_newdata() || timer_expired(&s.timer));
+
+      if(uip_newdata()) {
+        type = parse_msg();
+        if(type == DHCPACK) {
+          s.state = STATE_CONFIG_RECEIVED;
+          break;
+        }
+        if(type == DHCPNAK) {
+          break;
+        }
+      }
+
+      s.ticks *= 2;
+    } while(s.ticks < (CLOCK_SECOND << DHCPC_REBOOT_TRIES));
+
+    if(s.state == STATE_CONFIG_RECEIVED) {
+      goto configured;
+    }
+
+    /* The cached lease is not ours any more: drop it and the address
+       configured from it, then start over from DISCOVER. */
+    dhcpc_lease_store(NULL);
+    uip_ipaddr(addr, 0,0,0,0);
+    uip_sethostaddr(addr);
+    uip_setdraddr(addr);
+    uip_setnetmask(addr);
+
+    /* The NAK is still in uip_appdata: start over from the next call. */
+    PT_YIELD_UNTIL(&s.pt, !uip_newdata());
+  }
+#endif /* DHCPC_LEASE_STORE */
   
   /* try_again:*/
   s.state = STATE_SENDING;
@@ -286,6 +338,11 @@ PT_THREAD(handle_dhcp(void))
       PT_RESTART(&s.pt);
     }
   } while(s.state != STATE_CONFIG_RECEIVED);
+
+#if DHCPC_LEASE_STORE
+ configured:
+  dhcpc_lease_store(&s);
+#endif /* DHCPC_LEASE_STORE */
   
 #if 0
   printf("Got IP address %d.%d.%d.%d\n",
@@ -322,7 +379,7 @@ PT_THREAD(handle_dhcp(void))
 void
 dhcpc_init(const void *mac_addr, int mac_len)
 {
-#if 0
+#if UIP_UDP
   uip_ipaddr_t addr;
   
   s.mac_addr = mac_addr;
@@ -335,7 +392,17 @@ dhcpc_init(const void *mac_addr, int mac_len)
     uip_udp_bind(s.conn, HTONS(DHCPC_CLIENT_PORT));
   }
   PT_INIT(&s.pt);
-#endif
+
+#if DHCPC_LEASE_STORE
+  /* Use the stored lease straight away; handle_dhcp() confirms it
+     with the server, or takes it back. */
+  memset(s.dnsaddr, 0, sizeof(s.dnsaddr));
+  if(dhcpc_lease_load(&s)) {
+    s.state = STATE_REBOOTING;
+    dhcpc_configured(&s);
+  }
+#endif /* DHCPC_LEASE_STORE */
+#endif /* UIP_UDP */
 }
 /*---------------------------------------------------------------------------*/
 void
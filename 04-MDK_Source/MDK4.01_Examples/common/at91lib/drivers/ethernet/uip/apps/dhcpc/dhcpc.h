@@ -36,6 +36,31 @@
 #include "timer.h"
 #include "pt.h"
 
+/**
+ * Keep the lease across resets.
+ *
+ * When set, the application provides dhcpc_lease_load() and
+ * dhcpc_lease_store(); dhcpc-lease.c implements them with the backup
+ * registers of the at91 chips. A lease found at dhcpc_init() is configured
+ * right away and confirmed with an INIT-REBOOT REQUEST; the client
+ * falls back to DISCOVER on a NAK or when no server answers.
+ */
+#ifdef DHCPC_CONF_LEASE_STORE
+#define DHCPC_LEASE_STORE DHCPC_CONF_LEASE_STORE
+#else /* DHCPC_CONF_LEASE_STORE */
+#define DHCPC_LEASE_STORE 0
+#endif /* DHCPC_CONF_LEASE_STORE */
+
+/**
+ * Number of INIT-REBOOT REQUESTs sent, 1, 2, 4... seconds apart,
+ * before falling back to DISCOVER.
+ */
+#ifdef DHCPC_CONF_REBOOT_TRIES
+#define DHCPC_REBOOT_TRIES DHCPC_CONF_REBOOT_TRIES
+#else /* DHCPC_CONF_REBOOT_TRIES */
+#define DHCPC_REBOOT_TRIES 3
+#endif /* DHCPC_CONF_REBOOT_TRIES */
+
 struct dhcpc_state {
   struct pt pt;
   char state;
@@ -61,8 +86,30 @@ void dhcpc_appcall(void);
 
 void dhcpc_configured(const struct dhcpc_state *s);
 
+#if DHCPC_LEASE_STORE
+/*
+ * Fill in ipaddr, default_router, netmask and lease_time (the seconds
+ * left) of s from non-volatile memory. serverid need not be restored:
+ * the INIT-REBOOT request does not carry it. Returns 0 when there is
+ * no lease or it has expired.
+ */
+int dhcpc_lease_load(struct dhcpc_state *s);
+
+/*
+ * Save the lease just acknowledged, lease_time seconds from now, or
+ * forget the stored lease when s is NULL.
+ */
+void dhcpc_lease_store(const struct dhcpc_state *s);
+#endif /* DHCPC_LEASE_STORE */
+
+/* With another UDP application, the application defines
+   UIP_UDP_APPCALL and uip_udp_appstate_t, and passes the packets of
+   port 68 on to dhcpc_appcall(). The client keeps its state in a
+   static variable, not in the connection. */
+#ifndef UIP_UDP_APPCALL
 typedef struct dhcpc_state uip_udp_appstate_t;
 #define UIP_UDP_APPCALL dhcpc_appcall
+#endif /* UIP_UDP_APPCALL */
 
 
 #endif /* __DHCPC_H__ */
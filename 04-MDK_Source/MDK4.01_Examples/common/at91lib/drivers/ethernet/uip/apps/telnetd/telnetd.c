@@ -161,6 +161,27 @@ senddata(void)
 {
   static char *bufptr, *lineptr;
   static int buflen, linelen;
+
+#if UIP_SENDBUF
+  /* With a send buffer attached, the lines are queued as long as they
+     fit and released right away, since uIP retransmits from the
+     buffer. */
+  if(uip_conn->sbuf != NULL) {
+    while(s.lines[0] != NULL) {
+      linelen = strlen(s.lines[0]);
+      if(linelen > TELNETD_CONF_LINELEN) {
+	linelen = TELNETD_CONF_LINELEN;
+      }
+      if(linelen > uip_sendbuf_space(uip_conn)) {
+	break;
+      }
+      uip_sendbuf_write(uip_conn, s.lines[0], linelen);
+      s.numsent = 1;
+      acked();
+    }
+    return;
+  }
+#endif /* UIP_SENDBUF */
   
   bufptr = uip_appdata;
   buflen = 0;
@@ -315,6 +336,9 @@ telnetd_appcall(void)
     }
     s.bufptr = 0;
     s.state = STATE_NORMAL;
+#if UIP_SENDBUF
+    uip_sendbuf_attach();
+#endif /* UIP_SENDBUF */
 
     shell_start();
   }
@@ -56,6 +56,8 @@ struct telnetd_state {
 
 typedef struct telnetd_state uip_tcp_appstate_t;
 
+void telnetd_init(void);
+
 #ifndef UIP_APPCALL
 #define UIP_APPCALL     telnetd_appcall
 #endif
@@ -0,0 +1,561 @@
+/**
+ * \addtogroup tftpd
+ * @{
+ */
+
+/**
+ * \file
+ *         TFTP server, write requests only
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "uip.h"
+#include "tftpd.h"
+#include "timer.h"
+
+#if TFTPD_FS_FATFS
+#include "fatfs_config.h"
+#if _FATFS_TINY != 1
+#include <drivers/fat/fatfs/src/ff.h>
+#else
+#include <drivers/fat/fatfs/src/tff.h>
+#endif
+#endif /* TFTPD_FS_FATFS */
+
+#if UIP_UDP
+
+#define TFTP_PORT      69
+
+#define TFTP_RRQ        1
+#define TFTP_WRQ        2
+#define TFTP_DATA       3
+#define TFTP_ACK        4
+#define TFTP_ERROR      5
+#define TFTP_OACK       6
+
+#define TFTP_ERR_UNDEF     0
+#define TFTP_ERR_ACCESS    2
+#define TFTP_ERR_FULL      3
+#define TFTP_ERR_ILLEGAL   4
+
+#define TFTP_HDR_LEN        4
+#define TFTP_BLKSIZE      512
+#define TFTP_BLKSIZE_MIN    8
+
+/* Largest block a single uIP buffer holds. */
+#define TFTP_BLKSIZE_MAX (UIP_BUFSIZE - UIP_LLH_LEN - UIP_IPUDPH_LEN - \
+                          TFTP_HDR_LEN)
+
+#define STATE_IDLE      0
+#define STATE_RECEIVING 1
+#define STATE_CLOSING   2
+
+struct tftpd_state {
+  struct uip_udp_conn *listen;
+  struct uip_udp_conn *conn;    /* The transfer, from its own port. */
+  struct uip_udp_conn *reject;  /* Refuses requests while busy. */
+  struct timer timer;
+  unsigned long offset;         /* Byte address of the filling buffer. */
+  unsigned long size;           /* Bytes received. */
+  unsigned int fill;            /* Bytes in the filling buffer. */
+  u16_t blksize;
+  u16_t windowsize;
+  u16_t block;                  /* Last block received in order. */
+  u16_t unacked;                /* Blocks received since the last ACK. */
+  u8_t state;
+  u8_t retries;
+  u8_t cur;                     /* Filling buffer. */
+  u8_t last;                    /* Short block seen: the upload is complete. */
+  u8_t gap;                     /* A block was missed since the last ACK. */
+  u8_t ackpending;              /* ACK held back for a free buffer. */
+  u8_t oacklen;
+  char oack[64];                /* Options acknowledged, resent until block 1. */
+};
+
+static struct tftpd_state s;
+
+/* The buffer not filling is being written while this is set. The
+   media may clear it from its completion interrupt. */
+static volatile u8_t writing, writeerror;
+
+static u8_t buffers[2][TFTPD_BUFFER_SIZE];
+
+#if TFTPD_FS_FATFS
+static FIL fil;
+
+/* Written by whole sectors, which FatFs sends to the disk directly. */
+#define BLOCK_SIZE 512
+#else /* TFTPD_FS_FATFS */
+static Media *media;
+
+#define BLOCK_SIZE media->blockSize
+#endif /* TFTPD_FS_FATFS */
+
+#define UDPIPBUF ((struct uip_udpip_hdr *)&uip_buf[UIP_LLH_LEN])
+/*---------------------------------------------------------------------------*/
+static u16_t
+get16(const u8_t *p)
+{
+  return (p[0] << 8) | p[1];
+}
+/*---------------------------------------------------------------------------*/
+static void
+put16(u8_t *p, u16_t v)
+{
+  p[0] = v >> 8;
+  p[1] = v & 0xff;
+}
+/*---------------------------------------------------------------------------*/
+static int
+optcmp(const char *a, const char *b)
+{
+  while(*b != 0) {
+    if((*a | 0x20) != *b) {
+      return 1;
+    }
+    ++a;
+    ++b;
+  }
+  return *a;
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_error(u16_t code, const char *msg)
+{
+  u8_t *p = (u8_t *)uip_appdata;
+
+  put16(p, TFTP_ERROR);
+  put16(p + 2, code);
+  strcpy((char *)p + 4, msg);
+  uip_udp_send(TFTP_HDR_LEN + strlen(msg) + 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_ack(void)
+{
+  u8_t *p = (u8_t *)uip_appdata;
+
+  if(s.block == 0 && s.oacklen > 0) {
+    put16(p, TFTP_OACK);
+    memcpy(p + 2, s.oack, s.oacklen);
+    uip_udp_send(2 + s.oacklen);
+  } else {
+    put16(p, TFTP_ACK);
+    put16(p + 2, s.block);
+    uip_udp_send(TFTP_HDR_LEN);
+  }
+  s.unacked = 0;
+  s.gap = 0;
+  timer_set(&s.timer, TFTPD_TIMEOUT * CLOCK_SECOND);
+}
+/*---------------------------------------------------------------------------*/
+static void
+close_transfer(u8_t keep)
+{
+#if TFTPD_FS_FATFS
+  f_close(&fil);
+#else /* TFTPD_FS_FATFS */
+  MED_Flush(media);
+#endif /* TFTPD_FS_FATFS */
+  /* The connection goes on a later poll: a packet sent now takes its
+     port from it. It lingers to acknowledge the last block again if
+     our ACK is lost, or else goes on the next poll. */
+  s.state = STATE_CLOSING;
+  s.ackpending = 0;
+  if(!keep) {
+    s.last = 0;
+    timer_set(&s.timer, 0);
+  }
+}
+/*---------------------------------------------------------------------------*/
+#if !TFTPD_FS_FATFS
+static void
+write_done(void *arg, unsigned char status,
+           unsigned int transferred, unsigned int remaining)
+{
+  if(status != MED_STATUS_SUCCESS) {
+    writeerror = 1;
+  }
+  writing = 0;
+}
+#endif /* !TFTPD_FS_FATFS */
+/*---------------------------------------------------------------------------*/
+/* Start writing the whole blocks of the filling buffer and switch to
+   the other one, which must be free, moving the rest of the data
+   there. At the end of the upload, everything is written. */
+static u8_t
+flush(void)
+{
+  u8_t *buf = buffers[s.cur];
+  unsigned int len = s.fill;
+#if TFTPD_FS_FATFS
+  UINT written;
+#endif /* TFTPD_FS_FATFS */
+
+  if(!s.last) {
+    len -= len % BLOCK_SIZE;
+    memcpy(buffers[s.cur ^ 1], buf + len, s.fill - len);
+  }
+#if TFTPD_FS_FATFS
+  if(f_write(&fil, buf, len, &written) != FR_OK || written != len) {
+    return 0;
+  }
+#else /* TFTPD_FS_FATFS */
+  if(len % BLOCK_SIZE != 0) {
+    /* Pad the tail of the image to a whole media block. */
+    memset(buf + len, 0xff, BLOCK_SIZE - len % BLOCK_SIZE);
+  }
+  writing = 1;
+  if(MED_Write(media, s.offset / BLOCK_SIZE, buf,
+               (len + BLOCK_SIZE - 1) / BLOCK_SIZE, write_done, 0)
+     != MED_STATUS_SUCCESS) {
+    writing = 0;
+    return 0;
+  }
+#endif /* TFTPD_FS_FATFS */
+  s.offset += len;
+  s.fill -= len;
+  s.cur ^= 1;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Acknowledge the blocks received so far, opening the next window
+   once the filling buffer has room for all of it. */
+static void
+acknowledge(void)
+{
+  s.ackpending = 0;
+  if(writeerror) {
+    send_error(TFTP_ERR_FULL, "Write error");
+    close_transfer(0);
+    return;
+  }
+  if(s.last ||
+     s.fill + (unsigned long)s.windowsize * s.blksize > TFTPD_BUFFER_SIZE) {
+    if(s.fill > 0) {
+      if(writing) {
+        s.ackpending = 1;
+        return;
+      }
+      if(!flush()) {
+        send_error(TFTP_ERR_FULL, "Write error");
+        close_transfer(0);
+        return;
+      }
+    }
+    /* Do not report the upload done before it is written. */
+    if(s.last && writing) {
+      s.ackpending = 1;
+      return;
+    }
+  }
+  send_ack();
+  if(s.last) {
+    close_transfer(1);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Check the file name of a write request and get ready to store it.
+   Returns a TFTP error code, or -1 on success. */
+static int
+open_target(const char *name, unsigned long tsize)
+{
+#if TFTPD_FS_FATFS
+  if(f_open(&fil, name, FA_CREATE_ALWAYS | FA_WRITE) != FR_OK) {
+    return TFTP_ERR_ACCESS;
+  }
+  s.offset = 0;
+#else /* TFTPD_FS_FATFS */
+  char *end;
+  unsigned long capacity = media->size * media->blockSize;
+
+  s.offset = strtoul(name, &end, 0);
+  if(*name == 0 || *end != 0 || s.offset % media->blockSize != 0 ||
+     s.offset >= capacity) {
+    return TFTP_ERR_ACCESS;
+  }
+  if(tsize > capacity - s.offset) {
+    return TFTP_ERR_FULL;
+  }
+#endif /* TFTPD_FS_FATFS */
+  return -1;
+}
+/*---------------------------------------------------------------------------*/
+/* Refuse a request that arrives during a transfer, so that the client
+   stops sending it again. The error goes out of a connection of its
+   own, removed on its next poll. A request sent again by the client
+   of the transfer is ignored: the transfer answers it. */
+static void
+reject_request(void)
+{
+  if(uip_ipaddr_cmp(&UDPIPBUF->srcipaddr, &s.conn->ripaddr) &&
+     UDPIPBUF->srcport == s.conn->rport) {
+    return;
+  }
+  if(s.reject == NULL) {
+    s.reject = uip_udp_new(&UDPIPBUF->srcipaddr, UDPIPBUF->srcport);
+    if(s.reject == NULL) {
+      return;
+    }
+  } else {
+    uip_ipaddr_copy(&s.reject->ripaddr, &UDPIPBUF->srcipaddr);
+    s.reject->rport = UDPIPBUF->srcport;
+  }
+  uip_udp_conn = s.reject;
+  send_error(TFTP_ERR_UNDEF, "Busy");
+}
+/*---------------------------------------------------------------------------*/
+/* Serve a request sent to port 69. The reply goes out of the new
+   connection, whose port identifies the transfer. */
+static void
+handle_request(void)
+{
+  char *p = (char *)uip_appdata;
+  char *end = p + uip_datalen();
+  char *name, *opt, *val;
+  unsigned long blksize = 0, windowsize = 0, tsize = 0;
+  u8_t tsizeopt = 0;
+  int err;
+
+  if(uip_datalen() < 4 || end[-1] != 0) {
+    return;
+  }
+  if(s.state == STATE_RECEIVING) {
+    reject_request();
+    return;
+  }
+  if(s.state == STATE_CLOSING) {
+    /* Done with the last transfer, or with a refused request. */
+    uip_udp_remove(s.conn);
+    s.state = STATE_IDLE;
+  }
+  s.conn = uip_udp_new(&UDPIPBUF->srcipaddr, UDPIPBUF->srcport);
+  if(s.conn == NULL) {
+    return;
+  }
+  uip_udp_conn = s.conn;
+
+  /* Until the transfer starts, the connection only carries an error
+     and goes away on its next poll. */
+  s.state = STATE_CLOSING;
+  s.last = 0;
+  timer_set(&s.timer, 0);
+
+  if(get16((u8_t *)p) != TFTP_WRQ) {
+    send_error(TFTP_ERR_ILLEGAL, "Write only");
+    return;
+  }
+#if !TFTPD_FS_FATFS
+  if(media == NULL) {
+    send_error(TFTP_ERR_UNDEF, "No media");
+    return;
+  }
+#endif /* !TFTPD_FS_FATFS */
+
+  /* Options follow the file name and the mode, which is ignored: the
+     data is stored as sent. */
+  name = p + 2;
+  opt = name + strlen(name) + 1;
+  if(opt < end) {
+    opt += strlen(opt) + 1;
+  }
+  while(opt < end) {
+    val = opt + strlen(opt) + 1;
+    if(val >= end) {
+      break;
+    }
+    if(optcmp(opt, "blksize") == 0) {
+      blksize = strtoul(val, NULL, 10);
+    } else if(optcmp(opt, "windowsize") == 0) {
+      windowsize = strtoul(val, NULL, 10);
+    } else if(optcmp(opt, "tsize") == 0) {
+      tsize = strtoul(val, NULL, 10);
+      tsizeopt = 1;
+    }
+    opt = val + strlen(val) + 1;
+  }
+
+  err = open_target(name, tsize);
+  if(err >= 0) {
+    send_error(err, err == TFTP_ERR_FULL ? "Too big" : "Bad target");
+    return;
+  }
+
+  /* Grant what fits the uIP buffer, and a window that fits one write
+     buffer after the partial block carried over by flush(). */
+  s.oacklen = 0;
+  s.blksize = TFTP_BLKSIZE;
+  if(blksize > 0) {
+    if(blksize < TFTP_BLKSIZE_MIN) {
+      blksize = TFTP_BLKSIZE_MIN;
+    } else if(blksize > TFTP_BLKSIZE_MAX) {
+      blksize = TFTP_BLKSIZE_MAX;
+    }
+    if(blksize > TFTPD_BUFFER_SIZE - BLOCK_SIZE) {
+      blksize = TFTPD_BUFFER_SIZE - BLOCK_SIZE;
+    }
+    s.blksize = blksize;
+    s.oacklen += sprintf(s.oack + s.oacklen, "blksize%c%u", 0,
+                         s.blksize) + 1;
+  }
+  s.windowsize = 1;
+  if(windowsize > 0) {
+    if(windowsize > TFTPD_WINDOWSIZE) {
+      windowsize = TFTPD_WINDOWSIZE;
+    }
+    if(windowsize > (TFTPD_BUFFER_SIZE - BLOCK_SIZE) / s.blksize) {
+      windowsize = (TFTPD_BUFFER_SIZE - BLOCK_SIZE) / s.blksize;
+    }
+    s.windowsize = windowsize;
+    s.oacklen += sprintf(s.oack + s.oacklen, "windowsize%c%u", 0,
+                         s.windowsize) + 1;
+  }
+  if(tsizeopt) {
+    s.oacklen += sprintf(s.oack + s.oacklen, "tsize%c%lu", 0,
+                         (unsigned long)tsize) + 1;
+  }
+
+  s.size = 0;
+  s.fill = 0;
+  s.block = 0;
+  s.retries = 0;
+  writeerror = 0;
+  s.state = STATE_RECEIVING;
+  acknowledge();
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_data(void)
+{
+  u8_t *p = (u8_t *)uip_appdata;
+  u16_t op = get16(p);
+  u16_t block = get16(p + 2);
+  u16_t len = uip_datalen() - TFTP_HDR_LEN;
+
+  if(uip_datalen() < TFTP_HDR_LEN) {
+    return;
+  }
+  if(op == TFTP_ERROR) {
+    if(s.state == STATE_RECEIVING) {
+      close_transfer(0);
+    }
+    return;
+  }
+  if(op != TFTP_DATA) {
+    send_error(TFTP_ERR_ILLEGAL, "Data expected");
+    return;
+  }
+
+  if(s.state == STATE_CLOSING) {
+    /* Our last ACK was lost. */
+    if(s.last && block == s.block) {
+      send_ack();
+    }
+    return;
+  }
+
+  if(block == (u16_t)(s.block + 1) && !s.ackpending) {
+    if(len > s.blksize) {
+      send_error(TFTP_ERR_ILLEGAL, "Block too big");
+      close_transfer(0);
+      return;
+    }
+    memcpy(&buffers[s.cur][s.fill], p + TFTP_HDR_LEN, len);
+    s.fill += len;
+    s.size += len;
+    s.block = block;
+    s.retries = 0;
+    s.gap = 0;
+    if(len < s.blksize) {
+      s.last = 1;
+    }
+    if(s.last || ++s.unacked >= s.windowsize) {
+      acknowledge();
+    }
+  } else if(block != s.block && !s.gap && !s.ackpending) {
+    /* A block went missing: have the client resume after the last
+       one received in order, once per window (RFC 7440). */
+    s.gap = 1;
+    acknowledge();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_poll(void)
+{
+  if(s.ackpending) {
+    acknowledge();
+    return;
+  }
+  if(!timer_expired(&s.timer)) {
+    return;
+  }
+  if(s.state == STATE_CLOSING) {
+    uip_udp_remove(s.conn);
+    s.state = STATE_IDLE;
+  } else if(++s.retries > TFTPD_RETRIES) {
+    send_error(TFTP_ERR_UNDEF, "Timeout");
+    close_transfer(0);
+  } else {
+    acknowledge();
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+tftpd_appcall(void)
+{
+  if(uip_udp_conn == s.reject) {
+    if(uip_poll()) {
+      uip_udp_remove(s.reject);
+      s.reject = NULL;
+    }
+  } else if(uip_udp_conn == s.listen) {
+    if(uip_newdata()) {
+      handle_request();
+    }
+  } else if(s.state != STATE_IDLE && uip_udp_conn == s.conn) {
+    if(uip_newdata()) {
+      handle_data();
+    } else if(uip_poll()) {
+      handle_poll();
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+struct uip_udp_conn *
+tftpd_pending(void)
+{
+  if(s.state == STATE_RECEIVING && s.ackpending && !writing) {
+    return s.conn;
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+void
+#if TFTPD_FS_FATFS
+tftpd_init(void)
+#else /* TFTPD_FS_FATFS */
+tftpd_init(Media *m)
+#endif /* TFTPD_FS_FATFS */
+{
+#if !TFTPD_FS_FATFS
+  /* A media block and a default TFTP block must fit a write buffer. */
+  if(m->blockSize + TFTP_BLKSIZE > TFTPD_BUFFER_SIZE) {
+    m = NULL;
+  }
+  media = m;
+#endif /* !TFTPD_FS_FATFS */
+  s.state = STATE_IDLE;
+  s.reject = NULL;
+  s.listen = uip_udp_new(NULL, 0);
+  if(s.listen != NULL) {
+    uip_udp_bind(s.listen, HTONS(TFTP_PORT));
+  }
+}
+/*---------------------------------------------------------------------------*/
+#endif /* UIP_UDP */
+
+/** @} */
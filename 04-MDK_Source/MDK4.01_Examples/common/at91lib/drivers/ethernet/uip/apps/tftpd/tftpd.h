@@ -0,0 +1,98 @@
+/**
+ * \addtogroup apps
+ * @{
+ */
+
+/**
+ * \defgroup tftpd TFTP server
+ * @{
+ *
+ * A TFTP server that receives files (WRQ) straight into a Media, or
+ * into files of FAT volume 0, for firmware and asset uploads.
+ *
+ * The blksize (RFC 2348), windowsize (RFC 7440) and tsize (RFC 2349)
+ * options are supported. Blocks are gathered in one of two buffers;
+ * the full buffer is written while the other one receives the next
+ * windows, and the ACK that opens a window is held back only when no
+ * buffer is free for it.
+ */
+
+/**
+ * \file
+ *         Header file for the TFTP server
+ */
+
+#ifndef __TFTPD_H__
+#define __TFTPD_H__
+
+#include "uipopt.h"
+
+/* Set TFTPD_CONF_FS_FATFS to 1 to write uploads into files of FAT
+   volume 0, mounted by the application. Otherwise they are written
+   into the Media given to tftpd_init(), at the byte offset sent as
+   file name: "tftp -m binary <board> -c put image.bin 0x100000". */
+#ifdef TFTPD_CONF_FS_FATFS
+#define TFTPD_FS_FATFS TFTPD_CONF_FS_FATFS
+#else /* TFTPD_CONF_FS_FATFS */
+#define TFTPD_FS_FATFS 0
+#endif /* TFTPD_CONF_FS_FATFS */
+
+/* Size of each of the two write buffers, a multiple of the media
+   block size. It also bounds the window: windowsize * blksize. A
+   media whose block leaves no room for a 512 byte TFTP block is
+   refused by tftpd_init(), and the requests are answered with an
+   error. */
+#ifdef TFTPD_CONF_BUFFER_SIZE
+#define TFTPD_BUFFER_SIZE TFTPD_CONF_BUFFER_SIZE
+#else /* TFTPD_CONF_BUFFER_SIZE */
+#define TFTPD_BUFFER_SIZE 16384
+#endif /* TFTPD_CONF_BUFFER_SIZE */
+
+/* Largest windowsize granted to a client. */
+#ifdef TFTPD_CONF_WINDOWSIZE
+#define TFTPD_WINDOWSIZE TFTPD_CONF_WINDOWSIZE
+#else /* TFTPD_CONF_WINDOWSIZE */
+#define TFTPD_WINDOWSIZE 16
+#endif /* TFTPD_CONF_WINDOWSIZE */
+
+/* Number of times the last ACK is sent again, TFTPD_TIMEOUT seconds
+   apart, before the transfer is given up. */
+#ifdef TFTPD_CONF_RETRIES
+#define TFTPD_RETRIES TFTPD_CONF_RETRIES
+#else /* TFTPD_CONF_RETRIES */
+#define TFTPD_RETRIES 5
+#endif /* TFTPD_CONF_RETRIES */
+
+#ifdef TFTPD_CONF_TIMEOUT
+#define TFTPD_TIMEOUT TFTPD_CONF_TIMEOUT
+#else /* TFTPD_CONF_TIMEOUT */
+#define TFTPD_TIMEOUT 2
+#endif /* TFTPD_CONF_TIMEOUT */
+
+#if TFTPD_FS_FATFS
+void tftpd_init(void);
+#else /* TFTPD_FS_FATFS */
+#include <memories/Media.h>
+
+void tftpd_init(Media *media);
+#endif /* TFTPD_FS_FATFS */
+
+void tftpd_appcall(void);
+
+/* The connection whose ACK waits for a buffer that is now written, or
+   NULL. The application polls it with uip_udp_periodic_conn() from its
+   main loop, rather than leaving the window stalled until the next
+   periodic timer. */
+struct uip_udp_conn *tftpd_pending(void);
+
+/* With another UDP application, the application defines
+   UIP_UDP_APPCALL and passes the packets of the other ports on to
+   tftpd_appcall(). The server keeps no per-connection state. */
+#ifndef UIP_UDP_APPCALL
+typedef u8_t uip_udp_appstate_t;
+#define UIP_UDP_APPCALL tftpd_appcall
+#endif /* UIP_UDP_APPCALL */
+
+#endif /* __TFTPD_H__ */
+/** @} */
+/** @} */
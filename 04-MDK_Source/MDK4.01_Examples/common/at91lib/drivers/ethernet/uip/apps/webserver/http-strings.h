@@ -13,8 +13,14 @@ extern const char http_crnl[3];
 extern const char http_index_html[12];
 extern const char http_404_html[10];
 extern const char http_referer[9];
-extern const char http_header_200[84];
-extern const char http_header_404[91];
+extern const char http_header_200[65];
+extern const char http_header_404[72];
+extern const char http_header_304[75];
+extern const char http_if_none_match[16];
+extern const char http_accept_encoding[17];
+extern const char http_gzip[5];
+extern const char http_connection_close[20];
+extern const char http_content_length[17];
 extern const char http_content_type_plain[29];
 extern const char http_content_type_html[28];
 extern const char http_content_type_css [27];
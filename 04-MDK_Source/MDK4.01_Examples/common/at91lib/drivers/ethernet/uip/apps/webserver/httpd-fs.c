@@ -36,11 +36,17 @@
 #include "httpd.h"
 #include "httpd-fs.h"
 #include "httpd-fsdata.h"
+#include "http-strings.h"
+
+#include <string.h>
 
 #ifndef NULL
 #define NULL 0
 #endif /* NULL */
 
+#define ISO_nl 0x0a
+#define ISO_cr 0x0d
+
 #define HTTPD_FSDATA
 #include "httpd-fsdata.c"
 
@@ -48,6 +54,16 @@
 static u16_t count[HTTPD_FS_NUMFILES];
 #endif /* HTTPD_FS_STATISTICS */
 
+#if HTTPD_FS_FATFS
+static FATFS fatfs;
+
+/* The pool of open files of the FAT volume. */
+static struct {
+  struct httpd_fs_file *owner;
+  FIL fil;
+} fils[HTTPD_FS_FATFS_FILES];
+#endif /* HTTPD_FS_FATFS */
+
 /*-----------------------------------------------------------------------------------*/
 static u8_t
 httpd_fs_strcmp(const char *str1, const char *str2)
@@ -56,10 +72,10 @@ httpd_fs_strcmp(const char *str1, const char *str2)
   i = 0;
  loop:
 
-  if(str2[i] == 0 ||
-     str1[i] == '\r' ||
-     str1[i] == '\n') {
-    return 0;
+  if(str1[i] == 0 ||
+     str1[i] == ISO_cr ||
+     str1[i] == ISO_nl) {
+    return str2[i] != 0;
   }
 
   if(str1[i] != str2[i]) {
@@ -71,32 +87,171 @@ httpd_fs_strcmp(const char *str1, const char *str2)
   goto loop;
 }
 /*-----------------------------------------------------------------------------------*/
+/* FNV-1a hash of a name, which ends at a NUL or line break. */
+static unsigned long
+httpd_fs_hash(const char *name)
+{
+  unsigned long h = 2166136261UL;
+
+  while(*name != 0 && *name != ISO_cr && *name != ISO_nl) {
+    h = ((h ^ (unsigned char)*name++) * 16777619UL) & 0xffffffffUL;
+  }
+  return h;
+}
+/*-----------------------------------------------------------------------------------*/
+/* Slot of a name in httpd_fsdata_files[], or -1. This must match the
+   perfect hash built by tools/makefsdata. */
+static int
+httpd_fs_find(const char *name)
+{
+  unsigned long h;
+  int i;
+
+  h = httpd_fs_hash(name);
+  h ^= httpd_fsdata_disp[h % HTTPD_FS_DISPSIZE];
+  h = (h * 2654435761UL) & 0xffffffffUL;
+  h ^= h >> 16;
+  i = (int)(h % HTTPD_FS_NUMFILES);
+
+  if(httpd_fs_strcmp(name, httpd_fsdata_files[i].name) != 0) {
+    return -1;
+  }
+  return i;
+}
+/*-----------------------------------------------------------------------------------*/
+#if HTTPD_FS_FATFS
+static void
+httpd_fs_release(struct httpd_fs_file *file)
+{
+  int i;
+
+  for(i = 0; i < HTTPD_FS_FATFS_FILES; ++i) {
+    if(fils[i].owner == file) {
+      f_close(&fils[i].fil);
+      fils[i].owner = NULL;
+    }
+  }
+}
+#endif /* HTTPD_FS_FATFS */
+/*-----------------------------------------------------------------------------------*/
 int
-httpd_fs_open(const char *name, struct httpd_fs_file *file)
+httpd_fs_open(const char *name, struct httpd_fs_file *file, u8_t gzip)
 {
-#if HTTPD_FS_STATISTICS
-  u16_t i = 0;
-#endif /* HTTPD_FS_STATISTICS */
   struct httpd_fsdata_file_noconst *f;
+  int i;
 
-  for(f = (struct httpd_fsdata_file_noconst *)HTTPD_FS_ROOT;
-      f != NULL;
-      f = (struct httpd_fsdata_file_noconst *)f->next) {
+#if HTTPD_FS_FATFS
+  httpd_fs_release(file);
+#endif /* HTTPD_FS_FATFS */
 
-    if(httpd_fs_strcmp(name, f->name) == 0) {
-      file->data = f->data;
-      file->len = f->len;
+#if HTTPD_FS_PCAP
+  file->pcapsize = 0;
+  if(httpd_fs_strcmp(name, HTTPD_FS_PCAP_NAME) == 0) {
+    /* The frames captured so far; the capture goes on meanwhile. */
+    file->data = NULL;
+    file->len = file->pcapsize = PCAP_Open(&file->pcap);
+    file->hdr = (char *)http_content_type_binary;
+    file->etag = NULL;
+    return 1;
+  }
+#endif /* HTTPD_FS_PCAP */
+
+  i = httpd_fs_find(name);
+  if(i >= 0) {
+    f = (struct httpd_fsdata_file_noconst *)&httpd_fsdata_files[i];
+    file->data = f->data;
+    file->len = f->len;
+    file->hdr = f->hdr;
+    file->etag = f->etag;
+    if(gzip && f->gzdata != NULL) {
+      file->data = f->gzdata;
+      file->len = f->gzlen;
+      file->hdr = f->gzhdr;
+      file->etag = f->gzetag;
+    }
 #if HTTPD_FS_STATISTICS
-      ++count[i];
+    ++count[i];
 #endif /* HTTPD_FS_STATISTICS */
+    return 1;
+  }
+
+#if HTTPD_FS_FATFS
+  /* The request path is used as is: "/dir/file" on drive 0. */
+  for(i = 0; i < HTTPD_FS_FATFS_FILES; ++i) {
+    if(fils[i].owner == NULL) {
+      if(f_open(&fils[i].fil, name, FA_OPEN_EXISTING | FA_READ) != FR_OK) {
+        return 0;
+      }
+      fils[i].owner = file;
+      file->fil = &fils[i].fil;
+      file->data = NULL;
+      file->len = file->fil->fsize;
+      file->hdr = NULL;
+      file->etag = NULL;
       return 1;
     }
-#if HTTPD_FS_STATISTICS
-    ++i;
-#endif /* HTTPD_FS_STATISTICS */
+  }
+#endif /* HTTPD_FS_FATFS */
+  return 0;
+}
+/*-----------------------------------------------------------------------------------*/
+int
+httpd_fs_read(struct httpd_fs_file *file, void *buf, int len)
+{
+#if HTTPD_FS_FATFS
+  DWORD offset;
+  UINT n;
+#endif /* HTTPD_FS_FATFS */
 
+  if(len > file->len) {
+    len = file->len;
   }
+  if(file->data != NULL) {
+    memcpy(buf, file->data, len);
+    return len;
+  }
+
+#if HTTPD_FS_PCAP
+  if(file->pcapsize != 0) {
+    return PCAP_Read(&file->pcap, file->pcapsize - file->len, buf, len);
+  }
+#endif /* HTTPD_FS_PCAP */
+
+#if HTTPD_FS_FATFS
+  /* Only seek when the data is read again for a retransmission;
+     sequential reads continue from the file pointer. */
+  offset = file->fil->fsize - file->len;
+  if(file->fil->fptr != offset &&
+     f_lseek(file->fil, offset) != FR_OK) {
+    return 0;
+  }
+  if(f_read(file->fil, buf, len, &n) != FR_OK) {
+    return 0;
+  }
+  return n;
+#else /* HTTPD_FS_FATFS */
   return 0;
+#endif /* HTTPD_FS_FATFS */
+}
+/*-----------------------------------------------------------------------------------*/
+void
+httpd_fs_close(struct httpd_fs_file *file)
+{
+#if HTTPD_FS_PCAP
+  if(file->pcapsize != 0) {
+    /* Keep the frames for the next request if the client has not got
+       them all. */
+    if(file->len == 0) {
+      PCAP_Close(&file->pcap);
+    }
+    file->pcapsize = 0;
+    return;
+  }
+#endif /* HTTPD_FS_PCAP */
+#if HTTPD_FS_FATFS
+  httpd_fs_release(file);
+#endif /* HTTPD_FS_FATFS */
+  file->len = 0;
 }
 /*-----------------------------------------------------------------------------------*/
 void
@@ -108,24 +263,21 @@ httpd_fs_init(void)
     count[i] = 0;
   }
 #endif /* HTTPD_FS_STATISTICS */
+#if HTTPD_FS_FATFS
+  memset(&fatfs, 0, sizeof(fatfs));
+  f_mount(0, &fatfs);
+#endif /* HTTPD_FS_FATFS */
 }
 /*-----------------------------------------------------------------------------------*/
 #if HTTPD_FS_STATISTICS
 u16_t httpd_fs_count
 (char *name)
 {
-  struct httpd_fsdata_file_noconst *f;
-  u16_t i;
+  int i;
 
-  i = 0;
-  for(f = (struct httpd_fsdata_file_noconst *)HTTPD_FS_ROOT;
-      f != NULL;
-      f = (struct httpd_fsdata_file_noconst *)f->next) {
-
-    if(httpd_fs_strcmp(name, f->name) == 0) {
-      return count[i];
-    }
-    ++i;
+  i = httpd_fs_find(name);
+  if(i >= 0) {
+    return count[i];
   }
   return 0;
 }
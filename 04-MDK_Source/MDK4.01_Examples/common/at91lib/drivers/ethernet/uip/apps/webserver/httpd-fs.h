@@ -37,14 +37,79 @@
 
 #define HTTPD_FS_STATISTICS 1
 
+/* Set HTTPD_CONF_FS_FATFS to 1 to serve files that are not in the
+   ROM image from FAT volume 0. The application initializes the
+   media before calling httpd_init(), which mounts the volume. */
+#ifdef HTTPD_CONF_FS_FATFS
+#define HTTPD_FS_FATFS HTTPD_CONF_FS_FATFS
+#else /* HTTPD_CONF_FS_FATFS */
+#define HTTPD_FS_FATFS 0
+#endif /* HTTPD_CONF_FS_FATFS */
+
+/* Number of files of the FAT volume sent at once. Each takes a FIL,
+   sector buffer included, from a pool shared by the connections; a
+   request for another one gets the 404 page while they are all
+   taken. */
+#ifdef HTTPD_CONF_FS_FATFS_FILES
+#define HTTPD_FS_FATFS_FILES HTTPD_CONF_FS_FATFS_FILES
+#else /* HTTPD_CONF_FS_FATFS_FILES */
+#define HTTPD_FS_FATFS_FILES 2
+#endif /* HTTPD_CONF_FS_FATFS_FILES */
+
+/* Set HTTPD_CONF_FS_PCAP to 1 to serve the frames captured by the
+   EMAC into the pcap ring as HTTPD_FS_PCAP_NAME. The frames sent are
+   freed from the ring once the whole file has been sent. */
+#ifdef HTTPD_CONF_FS_PCAP
+#define HTTPD_FS_PCAP HTTPD_CONF_FS_PCAP
+#else /* HTTPD_CONF_FS_PCAP */
+#define HTTPD_FS_PCAP 0
+#endif /* HTTPD_CONF_FS_PCAP */
+
+#define HTTPD_FS_PCAP_NAME "/capture.pcap"
+
+#if HTTPD_FS_PCAP
+#include <pcap/pcap.h>
+#endif /* HTTPD_FS_PCAP */
+
+#if HTTPD_FS_FATFS
+#include "fatfs_config.h"
+#if _FATFS_TINY != 1
+#include <drivers/fat/fatfs/src/ff.h>
+#else
+#include <drivers/fat/fatfs/src/tff.h>
+#endif
+#endif /* HTTPD_FS_FATFS */
+
 struct httpd_fs_file {
-  char *data;
-  int len;
+  char *data;       /* NULL for a file streamed from the FAT volume
+                       or the pcap ring. */
+  int len;          /* Number of bytes left to send. */
+  char *hdr;        /* Precomputed response headers or NULL. */
+  char *etag;       /* Entity tag or NULL. */
+#if HTTPD_FS_FATFS
+  FIL *fil;         /* From the pool, for a file of the FAT volume. */
+#endif /* HTTPD_FS_FATFS */
+#if HTTPD_FS_PCAP
+  PcapReader pcap;
+  int pcapsize;     /* Size of the capture file, 0 for other files. */
+#endif /* HTTPD_FS_PCAP */
 };
 
 /* file must be allocated by caller and will be filled in
-   by the function. */
-int httpd_fs_open(const char *name, struct httpd_fs_file *file);
+   by the function. The ROM image is searched first. If gzip is
+   non-zero, the gzip compressed copy of a ROM file is opened when
+   there is one. */
+int httpd_fs_open(const char *name, struct httpd_fs_file *file, u8_t gzip);
+
+/* Copy up to len bytes from the current position of the file, i.e.
+   the first of the file->len bytes still to send, into buf. The
+   position only moves when the caller updates file->len, so the same
+   data can be read again for a retransmission. */
+int httpd_fs_read(struct httpd_fs_file *file, void *buf, int len);
+
+/* Give back what the file holds. It may be called again, or on a
+   file that was never opened. */
+void httpd_fs_close(struct httpd_fs_file *file);
 
 #ifdef HTTPD_FS_STATISTICS
 #if HTTPD_FS_STATISTICS == 1
@@ -37,11 +37,18 @@
 
 #include "uip.h"
 
+/* The files are stored in the slots of a perfect hash table, see
+   tools/makefsdata. */
 struct httpd_fsdata_file {
-  const struct httpd_fsdata_file *next;
   const char *name;
   const char *data;
   const int len;
+  const char *hdr;     /* Response headers, up to the empty line. */
+  const char *etag;    /* NULL for scripts. */
+  const char *gzdata;  /* Gzip compressed copy of data, or NULL. */
+  const int gzlen;
+  const char *gzhdr;
+  const char *gzetag;
 #ifdef HTTPD_FS_STATISTICS
 #if HTTPD_FS_STATISTICS == 1
   u16_t count;
@@ -50,10 +57,15 @@ struct httpd_fsdata_file {
 };
 
 struct httpd_fsdata_file_noconst {
-  struct httpd_fsdata_file *next;
   char *name;
   char *data;
   int len;
+  char *hdr;
+  char *etag;
+  char *gzdata;
+  int gzlen;
+  char *gzhdr;
+  char *gzetag;
 #ifdef HTTPD_FS_STATISTICS
 #if HTTPD_FS_STATISTICS == 1
   u16_t count;
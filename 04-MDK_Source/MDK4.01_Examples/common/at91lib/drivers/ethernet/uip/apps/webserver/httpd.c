@@ -61,10 +61,12 @@
 #include "httpd-cgi.h"
 #include "http-strings.h"
 
+#include <stdio.h>
 #include <string.h>
 
 #define STATE_WAITING 0
 #define STATE_OUTPUT  1
+#define STATE_CLOSED  2
 
 #define ISO_nl      0x0a
 #define ISO_space   0x20
@@ -74,19 +76,95 @@
 #define ISO_slash   0x2f
 #define ISO_colon   0x3a
 
+/* The pool of buffers for pipelined requests. */
+static struct {
+  struct httpd_state *owner;
+  char data[HTTPD_PIPELINE_SIZE];
+} pipebufs[HTTPD_PIPELINE_BUFFERS];
 
+/*---------------------------------------------------------------------------*/
+static void
+release_pipebuf(struct httpd_state *s)
+{
+  int i;
+
+  for(i = 0; i < HTTPD_PIPELINE_BUFFERS; ++i) {
+    if(pipebufs[i].owner == s) {
+      pipebufs[i].owner = NULL;
+    }
+  }
+  s->pipebuf = NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Keep the rest of the input, and the new segment if newdata is set,
+   in the pipeline buffer of the connection. A buffer is taken from
+   the pool if the connection has none; without one, or if the data
+   does not fit, the connection is closed after the current
+   response. */
+static void
+stash_requests(struct httpd_state *s, u8_t newdata)
+{
+  int i;
+
+  if(s->sin.readlen == 0 && !(newdata && uip_newdata())) {
+    return;
+  }
+  for(i = 0; s->pipebuf == NULL && i < HTTPD_PIPELINE_BUFFERS; ++i) {
+    if(pipebufs[i].owner == NULL) {
+      pipebufs[i].owner = s;
+      s->pipebuf = pipebufs[i].data;
+    }
+  }
+  if(s->pipebuf == NULL) {
+    /* Drop the requests. */
+    PSOCK_STASH(&s->sin, s->inputbuf, 0, newdata);
+    s->keepalive = 0;
+  } else if(PSOCK_STASH(&s->sin, s->pipebuf, HTTPD_PIPELINE_SIZE,
+			 newdata) > 0) {
+    s->keepalive = 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Check if the value of an Accept-Encoding header accepts gzip, i.e.
+   lists it without a zero quality value. A value too long for the
+   input buffer may be cut before gzip, which then is not used. */
+static char
+accepts_gzip(char *value)
+{
+  char *ptr;
+
+  ptr = strstr(value, http_gzip);
+  if(ptr == NULL) {
+    return 0;
+  }
+  ptr += 4;
+  while(*ptr == ISO_space) {
+    ++ptr;
+  }
+  if(strncmp(ptr, ";q=0", 4) != 0) {
+    return 1;
+  }
+  ptr += 4;
+  if(*ptr == ISO_period) {
+    do {
+      ++ptr;
+    } while(*ptr == '0');
+  }
+  return *ptr >= '1' && *ptr <= '9';
+}
 /*---------------------------------------------------------------------------*/
 static unsigned short
 generate_part_of_file(void *state)
 {
   struct httpd_state *s = (struct httpd_state *)state;
 
-  if(s->file.len > uip_mss()) {
-    s->len = uip_mss();
-  } else {
-    s->len = s->file.len;
+  /* Only called while bytes remain to be sent. */
+  s->len = httpd_fs_read(&s->file, uip_appdata, uip_mss());
+  if(s->len == 0) {
+    /* The file could not be read: the client would wait forever for
+       the rest of the Content-Length. */
+    uip_abort();
   }
-  memcpy(uip_appdata, s->file.data, s->len);
   
   return s->len;
 }
@@ -96,11 +174,18 @@ PT_THREAD(send_file(struct httpd_state *s))
 {
   PSOCK_BEGIN(&s->sout);
   
-  do {
+  /* An empty file sends nothing after the headers. */
+  while(s->file.len > 0) {
     PSOCK_GENERATOR_SEND(&s->sout, generate_part_of_file, s);
+    if(s->len == 0) {
+      break;
+    }
     s->file.len -= s->len;
-    s->file.data += s->len;
-  } while(s->file.len > 0);
+    if(s->file.data != NULL) {
+      s->file.data += s->len;
+    }
+  }
+  httpd_fs_close(&s->file);
       
   PSOCK_END(&s->sout);
 }
@@ -140,7 +225,7 @@ PT_THREAD(handle_script(struct httpd_state *s))
       s->scriptptr = s->file.data + 3;
       s->scriptlen = s->file.len - 3;
       if(*(s->scriptptr - 1) == ISO_colon) {
-	httpd_fs_open(s->scriptptr + 1, &s->file);
+	httpd_fs_open(s->scriptptr + 1, &s->file, 0);
 	PT_WAIT_THREAD(&s->scriptpt, send_file(s));
       } else {
 	PT_WAIT_THREAD(&s->scriptpt,
@@ -193,6 +278,28 @@ PT_THREAD(send_headers(struct httpd_state *s, const char *statushdr))
 
   PSOCK_SEND_STR(&s->sout, statushdr);
 
+  ptr = strrchr(s->filename, ISO_period);
+  if(ptr != NULL && strncmp(http_shtml, ptr, 6) == 0 &&
+     s->file.data != NULL) {
+    /* The length of a scripted page is not known in advance, so the
+       end of the connection delimits it. */
+    s->keepalive = 0;
+  } else if(statushdr != http_header_304) {
+    /* The request has been parsed, so inputbuf is free. */
+    sprintf(s->inputbuf, "%s%d\r\n", http_content_length, s->file.len);
+    PSOCK_SEND_STR(&s->sout, s->inputbuf);
+  }
+  if(!s->keepalive) {
+    PSOCK_SEND_STR(&s->sout, http_connection_close);
+  }
+
+  if(s->file.hdr != NULL) {
+    /* Content type, encoding and entity tag of a ROM file were
+       generated along with it. */
+    PSOCK_SEND_STR(&s->sout, s->file.hdr);
+    PSOCK_EXIT(&s->sout);
+  }
+
   ptr = strrchr(s->filename, ISO_period);
   if(ptr == NULL) {
     PSOCK_SEND_STR(&s->sout, http_content_type_binary);
@@ -220,20 +327,27 @@ PT_THREAD(handle_output(struct httpd_state *s))
   
   PT_BEGIN(&s->outputpt);
  
-  if(!httpd_fs_open(s->filename, &s->file)) {
-    httpd_fs_open(http_404_html, &s->file);
+  if(!httpd_fs_open(s->filename, &s->file, s->gzip)) {
+    httpd_fs_open(http_404_html, &s->file, s->gzip);
     strcpy(s->filename, http_404_html);
     PT_WAIT_THREAD(&s->outputpt,
 		   send_headers(s,
 		   http_header_404));
     PT_WAIT_THREAD(&s->outputpt,
 		   send_file(s));
+  } else if(s->file.etag != NULL && strcmp(s->etag, s->file.etag) == 0) {
+    /* The client's cached copy is current. */
+    httpd_fs_close(&s->file);
+    PT_WAIT_THREAD(&s->outputpt,
+		   send_headers(s,
+		   http_header_304));
   } else {
     PT_WAIT_THREAD(&s->outputpt,
 		   send_headers(s,
 		   http_header_200));
     ptr = strchr(s->filename, ISO_period);
-    if(ptr != NULL && strncmp(ptr, http_shtml, 6) == 0) {
+    if(ptr != NULL && strncmp(ptr, http_shtml, 6) == 0 &&
+       s->file.data != NULL) {
       PT_INIT(&s->scriptpt);
       PT_WAIT_THREAD(&s->outputpt, handle_script(s));
     } else {
@@ -241,7 +355,12 @@ PT_THREAD(handle_output(struct httpd_state *s))
 		     send_file(s));
     }
   }
-  PSOCK_CLOSE(&s->sout);
+  if(s->keepalive) {
+    s->state = STATE_WAITING;
+  } else {
+    s->state = STATE_CLOSED;
+    PSOCK_CLOSE(&s->sout);
+  }
   PT_END(&s->outputpt);
 }
 /*---------------------------------------------------------------------------*/
@@ -250,36 +369,63 @@ PT_THREAD(handle_input(struct httpd_state *s))
 {
   PSOCK_BEGIN(&s->sin);
 
-  PSOCK_READTO(&s->sin, ISO_space);
+  while(1) {
+    PSOCK_READTO(&s->sin, ISO_space);
 
   
-  if(strncmp(s->inputbuf, http_get, 4) != 0) {
-    PSOCK_CLOSE_EXIT(&s->sin);
-  }
-  PSOCK_READTO(&s->sin, ISO_space);
+    if(strncmp(s->inputbuf, http_get, 4) != 0) {
+      PSOCK_CLOSE_EXIT(&s->sin);
+    }
+    PSOCK_READTO(&s->sin, ISO_space);
 
-  if(s->inputbuf[0] != ISO_slash) {
-    PSOCK_CLOSE_EXIT(&s->sin);
-  }
+    if(s->inputbuf[0] != ISO_slash) {
+      PSOCK_CLOSE_EXIT(&s->sin);
+    }
 
-  if(s->inputbuf[1] == ISO_space) {
-    strncpy(s->filename, http_index_html, sizeof(s->filename));
-  } else {
-    s->inputbuf[PSOCK_DATALEN(&s->sin) - 1] = 0;
-    strncpy(s->filename, &s->inputbuf[0], sizeof(s->filename));
-  }
+    if(s->inputbuf[1] == ISO_space) {
+      strncpy(s->filename, http_index_html, sizeof(s->filename));
+    } else {
+      s->inputbuf[PSOCK_DATALEN(&s->sin) - 1] = 0;
+      strncpy(s->filename, &s->inputbuf[0], sizeof(s->filename));
+    }
 
-  /*  httpd_log_file(uip_conn->ripaddr, s->filename);*/
-  
-  s->state = STATE_OUTPUT;
+    /*  httpd_log_file(uip_conn->ripaddr, s->filename);*/
 
-  while(1) {
+    /* HTTP/1.1 connections persist unless the client says otherwise. */
     PSOCK_READTO(&s->sin, ISO_nl);
+    s->keepalive = (strncmp(s->inputbuf, http_11, 8) == 0);
+    s->etag[0] = 0;
+    s->gzip = 0;
 
-    if(strncmp(s->inputbuf, http_referer, 8) == 0) {
-      s->inputbuf[PSOCK_DATALEN(&s->sin) - 2] = 0;
-      /*      httpd_log(&s->inputbuf[9]);*/
-    }
+    /* Read the header lines up to the empty line that ends the
+       request. */
+    do {
+      PSOCK_READTO(&s->sin, ISO_nl);
+
+      if(strncmp(s->inputbuf, http_connection_close, 17) == 0) {
+	s->keepalive = 0;
+      }
+      if(strncmp(s->inputbuf, http_if_none_match, 15) == 0) {
+	s->inputbuf[PSOCK_DATALEN(&s->sin) - 2] = 0;
+	strncpy(s->etag, &s->inputbuf[15], sizeof(s->etag) - 1);
+	s->etag[sizeof(s->etag) - 1] = 0;
+      }
+      if(strncmp(s->inputbuf, http_accept_encoding, 16) == 0) {
+	s->inputbuf[PSOCK_DATALEN(&s->sin)] = 0;
+	s->gzip = accepts_gzip(&s->inputbuf[16]);
+      }
+      if(strncmp(s->inputbuf, http_referer, 8) == 0) {
+	s->inputbuf[PSOCK_DATALEN(&s->sin) - 2] = 0;
+	/*      httpd_log(&s->inputbuf[9]);*/
+      }
+    } while(PSOCK_DATALEN(&s->sin) > 2);
+
+    /* Whatever follows in the segment is the next pipelined request:
+       keep it until the response to this one has been sent. */
+    stash_requests(s, 0);
+
+    s->state = STATE_OUTPUT;
+    PSOCK_WAIT_UNTIL(&s->sin, s->state == STATE_WAITING);
   }
   
   PSOCK_END(&s->sin);
@@ -288,9 +434,30 @@ PT_THREAD(handle_input(struct httpd_state *s))
 static void
 handle_connection(struct httpd_state *s)
 {
+  if(s->state == STATE_OUTPUT && uip_newdata()) {
+    /* A pipelined request arrived while a response is being sent. */
+    stash_requests(s, 1);
+  }
+
   handle_input(s);
   if(s->state == STATE_OUTPUT) {
     handle_output(s);
+    if(s->state == STATE_WAITING) {
+      /* The response is complete: start on the next request right
+	 away if it has already been received. */
+      handle_input(s);
+      if(s->state == STATE_OUTPUT) {
+	handle_output(s);
+      }
+    }
+  }
+
+  /* Give the pipeline buffer back once its requests have been read. */
+  if(s->pipebuf != NULL &&
+     (s->sin.readlen == 0 ||
+      s->sin.readptr < (u8_t *)s->pipebuf ||
+      s->sin.readptr >= (u8_t *)s->pipebuf + HTTPD_PIPELINE_SIZE)) {
+    release_pipebuf(s);
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -300,11 +467,22 @@ httpd_appcall(void)
   struct httpd_state *s = (struct httpd_state *)&(uip_conn->appstate);
 
   if(uip_closed() || uip_aborted() || uip_timedout()) {
+    httpd_fs_close(&s->file);
+    release_pipebuf(s);
   } else if(uip_connected()) {
+    /* The connection may reuse the state of one that was aborted. */
+    httpd_fs_close(&s->file);
+    release_pipebuf(s);
+#if UIP_SENDBUF
+    /* Keep several segments of the response in flight when a send
+       buffer is available. */
+    uip_sendbuf_attach();
+#endif /* UIP_SENDBUF */
     PSOCK_INIT(&s->sin, s->inputbuf, sizeof(s->inputbuf) - 1);
     PSOCK_INIT(&s->sout, s->inputbuf, sizeof(s->inputbuf) - 1);
     PT_INIT(&s->outputpt);
     s->state = STATE_WAITING;
+    s->keepalive = 0;
     /*    timer_set(&s->timer, CLOCK_SECOND * 100);*/
     s->timer = 0;
     handle_connection(s);
@@ -312,6 +490,8 @@ httpd_appcall(void)
     if(uip_poll()) {
       ++s->timer;
       if(s->timer >= 20) {
+	httpd_fs_close(&s->file);
+	release_pipebuf(s);
 	uip_abort();
       }
     } else {
@@ -332,6 +512,7 @@ httpd_appcall(void)
 void
 httpd_init(void)
 {
+  httpd_fs_init();
   uip_listen(HTONS(80));
 }
 /*---------------------------------------------------------------------------*/
@@ -38,19 +38,43 @@
 #include "psock.h"
 #include "httpd-fs.h"
 
+/* Size and number of the buffers that keep pipelined requests
+   received while a response is being sent. The buffers are shared by
+   all connections, and a connection only holds one while it has
+   requests waiting, so they take HTTPD_PIPELINE_BUFFERS *
+   HTTPD_PIPELINE_SIZE bytes of RAM whatever the number of
+   connections. A connection whose pipelined requests do not fit, or
+   that finds no free buffer, is closed after the current response,
+   and the client sends them again on a new connection. */
+#ifdef HTTPD_CONF_PIPELINE_SIZE
+#define HTTPD_PIPELINE_SIZE HTTPD_CONF_PIPELINE_SIZE
+#else /* HTTPD_CONF_PIPELINE_SIZE */
+#define HTTPD_PIPELINE_SIZE 256
+#endif /* HTTPD_CONF_PIPELINE_SIZE */
+
+#ifdef HTTPD_CONF_PIPELINE_BUFFERS
+#define HTTPD_PIPELINE_BUFFERS HTTPD_CONF_PIPELINE_BUFFERS
+#else /* HTTPD_CONF_PIPELINE_BUFFERS */
+#define HTTPD_PIPELINE_BUFFERS 4
+#endif /* HTTPD_CONF_PIPELINE_BUFFERS */
+
 struct httpd_state {
   unsigned char timer;
   struct psock sin, sout;
   struct pt outputpt, scriptpt;
   char inputbuf[50];
   char filename[20];
+  char etag[12];
   char state;
+  char keepalive;
+  char gzip;
   struct httpd_fs_file file;
   int len;
   char *scriptptr;
   int scriptlen;
   
   unsigned short count;
+  char *pipebuf;
 };
 
 void httpd_init(void);
@@ -173,6 +173,19 @@ data_acked(register struct psock *s)
   return 0;
 }
 /*---------------------------------------------------------------------------*/
+#if UIP_SENDBUF
+static char
+data_buffered(register struct psock *s)
+{
+  u16_t len;
+
+  len = uip_sendbuf_write(uip_conn, s->sendptr, s->sendlen);
+  s->sendptr += len;
+  s->sendlen -= len;
+  return s->sendlen == 0;
+}
+#endif /* UIP_SENDBUF */
+/*---------------------------------------------------------------------------*/
 PT_THREAD(psock_send(register struct psock *s, const char *buf,
 		     unsigned int len))
 {
@@ -190,6 +203,15 @@ PT_THREAD(psock_send(register struct psock *s, const char *buf,
 
   s->state = STATE_NONE;
 
+#if UIP_SENDBUF
+  /* With a send buffer attached, the data is done with once it has
+     been queued: uIP takes care of sending and retransmitting it. */
+  if(uip_conn->sbuf != NULL) {
+    PT_WAIT_UNTIL(&s->psockpt, data_buffered(s));
+    PT_EXIT(&s->psockpt);
+  }
+#endif /* UIP_SENDBUF */
+
   /* We loop here until all data is sent. The s->sendlen variable is
      updated by the data_sent() function. */
   while(s->sendlen > 0) {
@@ -222,6 +244,17 @@ PT_THREAD(psock_generator_send(register struct psock *s,
     PT_EXIT(&s->psockpt);
   }
 
+#if UIP_SENDBUF
+  /* With a send buffer attached, wait until a full segment fits in it
+     and queue the generated data right away, before the uip_appdata
+     buffer is reused. */
+  if(uip_conn->sbuf != NULL) {
+    PT_WAIT_UNTIL(&s->psockpt, uip_sendbuf_space(uip_conn) >= uip_mss());
+    uip_sendbuf_write(uip_conn, uip_appdata, generate(arg));
+    PT_EXIT(&s->psockpt);
+  }
+#endif /* UIP_SENDBUF */
+
   /* Call the generator function to generate the data in the
      uip_appdata buffer. */
   s->sendlen = generate(arg);
@@ -324,6 +357,38 @@ PT_THREAD(psock_readbuf(register struct psock *psock))
   PT_END(&psock->psockpt);
 }
 /*---------------------------------------------------------------------------*/
+u16_t
+psock_stash(register struct psock *psock, char *buf, u16_t size,
+	    u8_t newdata)
+{
+  u16_t len, n, lost;
+
+  lost = 0;
+  len = psock->readlen;
+  if(len > size) {
+    lost = len - size;
+    len = size;
+  }
+  memmove(buf, psock->readptr, len);
+
+  if(newdata && uip_newdata()) {
+    n = uip_datalen();
+    if(n > size - len) {
+      lost += n - (size - len);
+      n = size - len;
+    }
+    memcpy(buf + len, uip_appdata, n);
+    len += n;
+    /* The segment has been consumed: do not hand it out again if the
+       stashed data runs out before the application returns. */
+    psock->state = STATE_READ;
+  }
+
+  psock->readptr = (u8_t *)buf;
+  psock->readlen = len;
+  return lost;
+}
+/*---------------------------------------------------------------------------*/
 void
 psock_init(register struct psock *psock, char *buffer, unsigned int buffersize)
 {
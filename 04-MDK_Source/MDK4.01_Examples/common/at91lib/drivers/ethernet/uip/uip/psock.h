@@ -282,6 +282,36 @@ PT_THREAD(psock_readto(struct psock *psock, unsigned char c));
 
 u16_t psock_datalen(struct psock *psock);
 
+/**
+ * Keep unread incoming data for a later read.
+ *
+ * uIP does not buffer incoming data: whatever the PSOCK_READ
+ * functions have not consumed when the application returns is
+ * lost. This macro moves the unread part of the current segment to
+ * the front of a buffer that belongs to the application, and with
+ * newdata set also appends a segment that arrived while the
+ * protosocket was not reading. The next PSOCK_READTO() or
+ * PSOCK_READ() continues from that buffer.
+ *
+ * \param psock (struct psock *) A pointer to the protosocket.
+ *
+ * \param buf (char *) The buffer, which must stay valid until it has
+ * been read.
+ *
+ * \param size (u16_t) The size of the buffer.
+ *
+ * \param newdata (u8_t) Non-zero if the current uip_appdata segment
+ * has not been handed to the protosocket yet.
+ *
+ * \return The number of bytes that did not fit and were dropped.
+ *
+ * \hideinitializer
+ */
+#define PSOCK_STASH(psock, buf, size, newdata)	\
+  psock_stash(psock, buf, size, newdata)
+
+u16_t psock_stash(struct psock *psock, char *buf, u16_t size, u8_t newdata);
+
 /**
  * Exit the protosocket's protothread.
  *
@@ -157,6 +157,13 @@ u16_t uip_len, uip_slen;
 				depending on the maximum packet
 				size. */
 
+#if UIP_ARCH_CHKSUM
+u16_t uip_sappchksum, uip_sappchksum_len;
+                             /* Checksum of the uip_slen bytes of
+				data copied by uip_send(), valid when
+				uip_sappchksum_len is not 0. */
+#endif /* UIP_ARCH_CHKSUM */
+
 u8_t uip_flags;     /* The uip_flags variable is used for
 				communication between the TCP/IP stack
 				and the application program. */
@@ -168,7 +175,12 @@ struct uip_conn uip_conns[UIP_CONNS];
 				connections. */
 u16_t uip_listenports[UIP_LISTENPORTS];
                              /* The uip_listenports list all currently
-				listning ports. */
+				listning ports. It is a hash table with
+				linear probing, 0 marking free slots. */
+static struct uip_conn *uip_connhash[UIP_CONNHASH_SIZE];
+                             /* Chains of TCP connections, hashed on
+				their ports and remote address, used to
+				demultiplex incoming segments. */
 #if UIP_UDP
 struct uip_udp_conn *uip_udp_conn;
 struct uip_udp_conn uip_udp_conns[UIP_UDP_CONNS];
@@ -183,6 +195,13 @@ void uip_setipid(u16_t id) { ipid = id; }
 static u8_t iss[4];          /* The iss variable is used for the TCP
 				initial sequence number. */
 
+#if UIP_SENDBUF
+static struct uip_sendbuf sendbufs[UIP_SENDBUF_CONNS];
+static u8_t sendbuf_data[UIP_SENDBUF_CONNS][UIP_SENDBUF_SIZE];
+                             /* The pool of send buffers, see
+				uip_sendbuf_attach(). */
+#endif /* UIP_SENDBUF */
+
 #if UIP_ACTIVE_OPEN
 static u16_t lastport;       /* Keeps track of the last port used for
 				a new connection. */
@@ -223,6 +242,21 @@ static u16_t tmp16;
 
 
 /* Macros. */
+#if UIP_SENDBUF
+/* Once the application has closed a buffered connection, it is not
+   invoked again while the remaining data drains. */
+#define UIP_TCP_APPCALL() do {						\
+    if(uip_connr->sbuf == NULL || !uip_connr->sbuf->closing) {		\
+      UIP_APPCALL();							\
+    }									\
+  } while(0)
+/* A buffered connection that is probing a zero window is not timed
+   out. */
+#define UIP_PERSISTING(conn) ((conn)->sbuf != NULL && (conn)->sbuf->wnd == 0)
+#else /* UIP_SENDBUF */
+#define UIP_TCP_APPCALL() UIP_APPCALL()
+#define UIP_PERSISTING(conn) 0
+#endif /* UIP_SENDBUF */
 #define BUF ((struct uip_tcpip_hdr *)&uip_buf[UIP_LLH_LEN])
 #define FBUF ((struct uip_tcpip_hdr *)&uip_reassbuf[0])
 #define ICMPBUF ((struct uip_icmpip_hdr *)&uip_buf[UIP_LLH_LEN])
@@ -381,9 +415,22 @@ uip_init(void)
   for(c = 0; c < UIP_LISTENPORTS; ++c) {
     uip_listenports[c] = 0;
   }
+  for(c = 0; c < UIP_CONNHASH_SIZE; ++c) {
+    uip_connhash[c] = NULL;
+  }
   for(c = 0; c < UIP_CONNS; ++c) {
     uip_conns[c].tcpstateflags = UIP_CLOSED;
+    uip_conns[c].lport = 0;
+#if UIP_SENDBUF
+    uip_conns[c].sbuf = NULL;
+#endif /* UIP_SENDBUF */
+  }
+#if UIP_SENDBUF
+  for(c = 0; c < UIP_SENDBUF_CONNS; ++c) {
+    sendbufs[c].conn = NULL;
+    sendbufs[c].data = sendbuf_data[c];
   }
+#endif /* UIP_SENDBUF */
 #if UIP_ACTIVE_OPEN
   lastport = 1024;
 #endif /* UIP_ACTIVE_OPEN */
@@ -400,6 +447,45 @@ uip_init(void)
   /*  uip_hostaddr[0] = uip_hostaddr[1] = 0;*/
 #endif /* UIP_FIXEDADDR */
 
+}
+/*---------------------------------------------------------------------------*/
+static u16_t
+uip_connhash_index(u16_t lport, u16_t rport, u16_t *ripaddr)
+{
+  u16_t h;
+
+  h = lport ^ rport ^ ripaddr[0] ^ ripaddr[1];
+  return (u16_t)(h ^ (h >> 8)) % UIP_CONNHASH_SIZE;
+}
+/*---------------------------------------------------------------------------*/
+/* A connection stays in its hash chain after it has been closed, and
+   is only taken out when the uip_conns entry is reused. The lport of
+   an entry that has never been used is 0. */
+static void
+uip_connhash_remove(struct uip_conn *conn)
+{
+  struct uip_conn **pp;
+
+  if(conn->lport == 0) {
+    return;
+  }
+  pp = &uip_connhash[uip_connhash_index(conn->lport, conn->rport,
+					(u16_t *)conn->ripaddr)];
+  while(*pp != conn) {
+    pp = &(*pp)->hnext;
+  }
+  *pp = conn->hnext;
+}
+/*---------------------------------------------------------------------------*/
+static void
+uip_connhash_insert(struct uip_conn *conn)
+{
+  struct uip_conn **pp;
+
+  pp = &uip_connhash[uip_connhash_index(conn->lport, conn->rport,
+					(u16_t *)conn->ripaddr)];
+  conn->hnext = *pp;
+  *pp = conn;
 }
 /*---------------------------------------------------------------------------*/
 #if UIP_ACTIVE_OPEN
@@ -456,13 +542,18 @@ uip_connect(uip_ipaddr_t *ripaddr, u16_t rport)
   
   conn->len = 1;   /* TCP length of the SYN is one. */
   conn->nrtx = 0;
+#if UIP_SENDBUF
+  conn->sbuf = NULL;
+#endif /* UIP_SENDBUF */
   conn->timer = 1; /* Send the SYN next time around. */
   conn->rto = UIP_RTO;
   conn->sa = 0;
   conn->sv = 16;   /* Initial value of the RTT variance. */
+  uip_connhash_remove(conn);
   conn->lport = htons(lastport);
   conn->rport = rport;
   uip_ipaddr_copy(&conn->ripaddr, ripaddr);
+  uip_connhash_insert(conn);
   
   return conn;
 }
@@ -514,28 +605,246 @@ uip_udp_new(uip_ipaddr_t *ripaddr, u16_t rport)
 }
 #endif /* UIP_UDP */
 /*---------------------------------------------------------------------------*/
+static u16_t
+uip_listen_index(u16_t port)
+{
+  return (u16_t)(port ^ (port >> 8)) % UIP_LISTENPORTS;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the slot of a listening port, or UIP_LISTENPORTS. */
+static u16_t
+uip_listen_find(u16_t port)
+{
+  u16_t i, n;
+
+  i = uip_listen_index(port);
+  for(n = 0; n < UIP_LISTENPORTS && uip_listenports[i] != 0; ++n) {
+    if(uip_listenports[i] == port) {
+      return i;
+    }
+    if(++i == UIP_LISTENPORTS) {
+      i = 0;
+    }
+  }
+  return UIP_LISTENPORTS;
+}
+/*---------------------------------------------------------------------------*/
 void
 uip_unlisten(u16_t port)
 {
-  for(c = 0; c < UIP_LISTENPORTS; ++c) {
-    if(uip_listenports[c] == port) {
-      uip_listenports[c] = 0;
-      return;
+  u16_t i, j, k;
+
+  i = uip_listen_find(port);
+  if(i == UIP_LISTENPORTS) {
+    return;
+  }
+  /* Shift the following ports of the probe sequence back into the
+     hole, unless their home slot lies cyclically in ]i, j]. */
+  j = i;
+  for(;;) {
+    if(++j == UIP_LISTENPORTS) {
+      j = 0;
+    }
+    if(j == i || uip_listenports[j] == 0) {
+      break;
     }
+    k = uip_listen_index(uip_listenports[j]);
+    if((i <= j) ? (i < k && k <= j) : (i < k || k <= j)) {
+      continue;
+    }
+    uip_listenports[i] = uip_listenports[j];
+    i = j;
   }
+  uip_listenports[i] = 0;
 }
 /*---------------------------------------------------------------------------*/
 void
 uip_listen(u16_t port)
 {
-  for(c = 0; c < UIP_LISTENPORTS; ++c) {
-    if(uip_listenports[c] == 0) {
-      uip_listenports[c] = port;
+  u16_t i, n;
+
+  if(uip_listen_find(port) != UIP_LISTENPORTS) {
+    return;
+  }
+  i = uip_listen_index(port);
+  for(n = 0; n < UIP_LISTENPORTS; ++n) {
+    if(uip_listenports[i] == 0) {
+      uip_listenports[i] = port;
       return;
     }
+    if(++i == UIP_LISTENPORTS) {
+      i = 0;
+    }
   }
 }
 /*---------------------------------------------------------------------------*/
+#if UIP_SENDBUF
+u8_t
+uip_sendbuf_attach(void)
+{
+  register struct uip_sendbuf *sb;
+
+  /* A buffer is free when its connection has been closed, or has been
+     reused for a new connection since. */
+  for(c = 0; c < UIP_SENDBUF_CONNS; ++c) {
+    sb = &sendbufs[c];
+    if(sb->conn == NULL ||
+       sb->conn->sbuf != sb ||
+       sb->conn->tcpstateflags == UIP_CLOSED) {
+      sb->conn = uip_conn;
+      sb->head = sb->count = 0;
+      sb->wnd = uip_conn->mss;
+      sb->closing = 0;
+      sb->finrcvd = 0;
+      uip_conn->sbuf = sb;
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+u16_t
+uip_sendbuf_write(struct uip_conn *conn, const void *data, u16_t len)
+{
+  register struct uip_sendbuf *sb = conn->sbuf;
+  u16_t tail, n;
+
+  if(len > UIP_SENDBUF_SIZE - sb->count) {
+    len = UIP_SENDBUF_SIZE - sb->count;
+  }
+  tail = sb->head + sb->count;
+  if(tail >= UIP_SENDBUF_SIZE) {
+    tail -= UIP_SENDBUF_SIZE;
+  }
+  n = UIP_SENDBUF_SIZE - tail;
+  if(n > len) {
+    n = len;
+  }
+  memcpy(&sb->data[tail], data, n);
+  memcpy(&sb->data[0], (const u8_t *)data + n, len - n);
+  sb->count += len;
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+u8_t
+uip_sendbuf_ready(struct uip_conn *conn)
+{
+  register struct uip_sendbuf *sb = conn->sbuf;
+
+  return sb != NULL &&
+    (conn->tcpstateflags & UIP_TS_MASK) == UIP_ESTABLISHED &&
+    sb->count > conn->len &&
+    conn->len < sb->wnd;
+}
+/*---------------------------------------------------------------------------*/
+/* Copy the next segment of queued data into uip_sappdata and add it
+   to the data in flight. Returns the length of the segment. */
+static u16_t
+sendbuf_fill(register struct uip_conn *conn)
+{
+  register struct uip_sendbuf *sb = conn->sbuf;
+  u16_t off, n, n1;
+#if UIP_ARCH_CHKSUM
+  u16_t sum, sum2;
+#endif /* UIP_ARCH_CHKSUM */
+
+  if(!uip_sendbuf_ready(conn)) {
+    return 0;
+  }
+  n = sb->count - conn->len;
+  if(n > sb->wnd - conn->len) {
+    n = sb->wnd - conn->len;
+  }
+  if(n > conn->mss) {
+    n = conn->mss;
+  }
+
+  off = sb->head + conn->len;
+  if(off >= UIP_SENDBUF_SIZE) {
+    off -= UIP_SENDBUF_SIZE;
+  }
+  n1 = UIP_SENDBUF_SIZE - off;
+  if(n1 > n) {
+    n1 = n;
+  }
+#if UIP_ARCH_CHKSUM
+  /* Sum the segment while copying it. The part that wrapped around
+     starts at an odd offset when n1 is odd, and its sum must then be
+     byte swapped. */
+  sum = uip_chksum_copy(uip_sappdata, &sb->data[off], n1);
+  if(n > n1) {
+    sum2 = uip_chksum_copy((u8_t *)uip_sappdata + n1, &sb->data[0], n - n1);
+    if(n1 & 1) {
+      sum2 = (sum2 << 8) | (sum2 >> 8);
+    }
+    sum += sum2;
+    if(sum < sum2) {
+      ++sum;
+    }
+  }
+  uip_sappchksum = sum;
+  uip_sappchksum_len = n;
+#else /* UIP_ARCH_CHKSUM */
+  memcpy(uip_sappdata, &sb->data[off], n1);
+  memcpy((u8_t *)uip_sappdata + n1, &sb->data[0], n - n1);
+#endif /* UIP_ARCH_CHKSUM */
+
+  conn->len += n;
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+/* Send the next queued byte beyond a zero window, so that the ACK of
+   the peer tells when the window opens again. Returns the length of
+   the probe. */
+static u16_t
+sendbuf_probe(register struct uip_conn *conn)
+{
+  u16_t n;
+
+  conn->sbuf->wnd = 1;
+  n = sendbuf_fill(conn);
+  conn->sbuf->wnd = 0;
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+/* Release the bytes acknowledged by the incoming segment. Any ACK
+   that covers part of the buffered data is accepted, including data
+   that was in flight before a retransmission shrunk conn->len.
+   Returns the number of bytes acknowledged. */
+static u16_t
+sendbuf_acked(register struct uip_conn *conn)
+{
+  register struct uip_sendbuf *sb = conn->sbuf;
+  unsigned long acked;
+
+  acked = (((unsigned long)BUF->ackno[0] << 24) |
+	   ((unsigned long)BUF->ackno[1] << 16) |
+	   ((unsigned long)BUF->ackno[2] << 8) |
+	   (unsigned long)BUF->ackno[3]) -
+    (((unsigned long)conn->snd_nxt[0] << 24) |
+     ((unsigned long)conn->snd_nxt[1] << 16) |
+     ((unsigned long)conn->snd_nxt[2] << 8) |
+     (unsigned long)conn->snd_nxt[3]);
+  acked &= 0xffffffffUL;
+  if(acked == 0 || acked > sb->count) {
+    return 0;
+  }
+
+  conn->snd_nxt[0] = BUF->ackno[0];
+  conn->snd_nxt[1] = BUF->ackno[1];
+  conn->snd_nxt[2] = BUF->ackno[2];
+  conn->snd_nxt[3] = BUF->ackno[3];
+
+  sb->head += (u16_t)acked;
+  if(sb->head >= UIP_SENDBUF_SIZE) {
+    sb->head -= UIP_SENDBUF_SIZE;
+  }
+  sb->count -= (u16_t)acked;
+  conn->len = (u16_t)acked < conn->len? conn->len - (u16_t)acked: 0;
+  return (u16_t)acked;
+}
+#endif /* UIP_SENDBUF */
+/*---------------------------------------------------------------------------*/
 /* XXX: IP fragment reassembly: not well-tested. */
 
 #if UIP_REASSEMBLY && !UIP_CONF_IPV6
@@ -690,6 +999,14 @@ uip_process(u8_t flag)
 #endif /* UIP_UDP */
   
   uip_sappdata = uip_appdata = &uip_buf[UIP_IPTCPH_LEN + UIP_LLH_LEN];
+#if UIP_ARCH_CHKSUM
+  uip_sappchksum_len = 0;
+#endif /* UIP_ARCH_CHKSUM */
+#if UIP_SENDBUF
+  /* The sequence number of a segment from a send buffer is derived
+     from uip_slen, which must therefore be 0 unless data is sent. */
+  uip_slen = 0;
+#endif /* UIP_SENDBUF */
 
   /* Check if we were invoked because of a poll request for a
      particular connection. */
@@ -697,9 +1014,17 @@ uip_process(u8_t flag)
     if((uip_connr->tcpstateflags & UIP_TS_MASK) == UIP_ESTABLISHED &&
        !uip_outstanding(uip_connr)) {
 	uip_flags = UIP_POLL;
-	UIP_APPCALL();
+	UIP_TCP_APPCALL();
 	goto appsend;
     }
+#if UIP_SENDBUF
+    /* A buffered connection may send while data is in flight. */
+    if(uip_sendbuf_ready(uip_connr)) {
+      uip_flags = UIP_POLL;
+      UIP_TCP_APPCALL();
+      goto appsend;
+    }
+#endif /* UIP_SENDBUF */
     goto drop;
     
     /* Check if we were invoked because of the perodic timer fireing. */
@@ -738,7 +1063,8 @@ uip_process(u8_t flag)
 	 in which case we retransmit. */
       if(uip_outstanding(uip_connr)) {
 	if(uip_connr->timer-- == 0) {
-	  if(uip_connr->nrtx == UIP_MAXRTX ||
+	  if((uip_connr->nrtx == UIP_MAXRTX &&
+	      !UIP_PERSISTING(uip_connr)) ||
 	     ((uip_connr->tcpstateflags == UIP_SYN_SENT ||
 	       uip_connr->tcpstateflags == UIP_SYN_RCVD) &&
 	      uip_connr->nrtx == UIP_MAXSYNRTX)) {
@@ -782,6 +1108,22 @@ uip_process(u8_t flag)
 #endif /* UIP_ACTIVE_OPEN */
 	    
 	  case UIP_ESTABLISHED:
+#if UIP_SENDBUF
+	    /* A buffered connection goes back to the oldest
+	       unacknowledged byte and resends one segment from the
+	       buffer, or one byte if the window is closed. The rest
+	       follows as the ACKs come in. */
+	    if(uip_connr->sbuf != NULL) {
+	      uip_flags = 0;
+	      uip_connr->len = 0;
+	      if(uip_connr->sbuf->wnd == 0) {
+		uip_slen = sendbuf_probe(uip_connr);
+	      } else {
+		uip_slen = sendbuf_fill(uip_connr);
+	      }
+	      goto sendbuf_send;
+	    }
+#endif /* UIP_SENDBUF */
 	    /* In the ESTABLISHED state, we call upon the application
                to do the actual retransmit after which we jump into
                the code for sending out the packet (the apprexmit
@@ -799,10 +1141,25 @@ uip_process(u8_t flag)
 	  }
 	}
       } else if((uip_connr->tcpstateflags & UIP_TS_MASK) == UIP_ESTABLISHED) {
+#if UIP_SENDBUF
+	/* Data queued behind a zero window with nothing in flight:
+	   the retransmission timer acts as the persist timer, and the
+	   window is probed when it expires. */
+	if(UIP_PERSISTING(uip_connr) && uip_connr->sbuf->count > 0 &&
+	   uip_connr->timer-- == 0) {
+	  uip_connr->timer = UIP_RTO << (uip_connr->nrtx > 4?
+					 4:
+					 uip_connr->nrtx);
+	  ++(uip_connr->nrtx);
+	  uip_flags = 0;
+	  uip_slen = sendbuf_probe(uip_connr);
+	  goto sendbuf_send;
+	}
+#endif /* UIP_SENDBUF */
 	/* If there was no need for a retransmission, we poll the
            application for new data. */
 	uip_flags = UIP_POLL;
-	UIP_APPCALL();
+	UIP_TCP_APPCALL();
 	goto appsend;
       }
     }
@@ -1185,9 +1542,13 @@ uip_process(u8_t flag)
   
   
   /* Demultiplex this segment. */
-  /* First check any active connections. */
-  for(uip_connr = &uip_conns[0]; uip_connr <= &uip_conns[UIP_CONNS - 1];
-      ++uip_connr) {
+  /* First check any active connections, in the hash chain of the
+     segment's ports and source address. */
+  for(uip_connr = uip_connhash[uip_connhash_index(BUF->destport,
+						  BUF->srcport,
+						  BUF->srcipaddr)];
+      uip_connr != NULL;
+      uip_connr = uip_connr->hnext) {
     if(uip_connr->tcpstateflags != UIP_CLOSED &&
        BUF->destport == uip_connr->lport &&
        BUF->srcport == uip_connr->rport &&
@@ -1204,11 +1565,9 @@ uip_process(u8_t flag)
     goto reset;
   }
   
-  tmp16 = BUF->destport;
   /* Next, check listening connections. */
-  for(c = 0; c < UIP_LISTENPORTS; ++c) {
-    if(tmp16 == uip_listenports[c])
-      goto found_listen;
+  if(uip_listen_find(BUF->destport) != UIP_LISTENPORTS) {
+    goto found_listen;
   }
   
   /* No matching connection found, so we send a RST packet. */
@@ -1305,9 +1664,14 @@ uip_process(u8_t flag)
   uip_connr->sa = 0;
   uip_connr->sv = 4;
   uip_connr->nrtx = 0;
+#if UIP_SENDBUF
+  uip_connr->sbuf = NULL;
+#endif /* UIP_SENDBUF */
+  uip_connhash_remove(uip_connr);
   uip_connr->lport = BUF->destport;
   uip_connr->rport = BUF->srcport;
   uip_ipaddr_copy(uip_connr->ripaddr, BUF->srcipaddr);
+  uip_connhash_insert(uip_connr);
   uip_connr->tcpstateflags = UIP_SYN_RCVD;
 
   uip_connr->snd_nxt[0] = iss[0];
@@ -1420,19 +1784,34 @@ uip_process(u8_t flag)
      the outstanding data, calculate RTT estimations, and reset the
      retransmission timer. */
   if((BUF->flags & TCP_ACK) && uip_outstanding(uip_connr)) {
-    uip_add32(uip_connr->snd_nxt, uip_connr->len);
-
-    if(BUF->ackno[0] == uip_acc32[0] &&
-       BUF->ackno[1] == uip_acc32[1] &&
-       BUF->ackno[2] == uip_acc32[2] &&
-       BUF->ackno[3] == uip_acc32[3]) {
-      /* Update sequence number. */
-      uip_connr->snd_nxt[0] = uip_acc32[0];
-      uip_connr->snd_nxt[1] = uip_acc32[1];
-      uip_connr->snd_nxt[2] = uip_acc32[2];
-      uip_connr->snd_nxt[3] = uip_acc32[3];
-	
+#if UIP_SENDBUF
+    /* A buffered connection in ESTABLISHED accepts ACKs for part of
+       the data in flight. */
+    if(uip_connr->sbuf != NULL &&
+       (uip_connr->tcpstateflags & UIP_TS_MASK) == UIP_ESTABLISHED) {
+      c = sendbuf_acked(uip_connr) != 0;
+    } else
+#endif /* UIP_SENDBUF */
+    {
+      uip_add32(uip_connr->snd_nxt, uip_connr->len);
+
+      c = BUF->ackno[0] == uip_acc32[0] &&
+	BUF->ackno[1] == uip_acc32[1] &&
+	BUF->ackno[2] == uip_acc32[2] &&
+	BUF->ackno[3] == uip_acc32[3];
+      if(c) {
+	/* Update sequence number. */
+	uip_connr->snd_nxt[0] = uip_acc32[0];
+	uip_connr->snd_nxt[1] = uip_acc32[1];
+	uip_connr->snd_nxt[2] = uip_acc32[2];
+	uip_connr->snd_nxt[3] = uip_acc32[3];
+
+	/* Reset length of outstanding data. */
+	uip_connr->len = 0;
+      }
+    }
 
+    if(c) {
       /* Do RTT estimation, unless we have done retransmissions. */
       if(uip_connr->nrtx == 0) {
 	signed char m;
@@ -1452,9 +1831,14 @@ uip_process(u8_t flag)
       uip_flags = UIP_ACKDATA;
       /* Reset the retransmission timer. */
       uip_connr->timer = uip_connr->rto;
-
-      /* Reset length of outstanding data. */
-      uip_connr->len = 0;
+#if UIP_SENDBUF
+      /* The retransmission counter of a buffered connection is not
+	 reset in appsend, since it may be polled with data in
+	 flight. */
+      if(uip_connr->sbuf != NULL) {
+	uip_connr->nrtx = 0;
+      }
+#endif /* UIP_SENDBUF */
     }
     
   }
@@ -1558,6 +1942,25 @@ uip_process(u8_t flag)
     sequence numbers will be screwed up. */
 
     if(BUF->flags & TCP_FIN && !(uip_connr->tcpstateflags & UIP_STOPPED)) {
+#if UIP_SENDBUF
+      /* A buffered connection with data left acknowledges the FIN
+	 and passes on the data that came with it. The FIN itself is
+	 processed in appsend once the buffer has drained. */
+      if(uip_connr->sbuf != NULL && uip_connr->sbuf->count > 0) {
+	uip_add_rcv_nxt(1 + uip_len);
+	uip_connr->sbuf->finrcvd = 1;
+	if(uip_len > 0) {
+	  uip_flags |= UIP_NEWDATA;
+	}
+	if(uip_flags & (UIP_NEWDATA | UIP_ACKDATA)) {
+	  UIP_TCP_APPCALL();
+	}
+	/* Make appsend acknowledge the FIN even if it has no data to
+	   send. */
+	uip_flags |= UIP_NEWDATA;
+	goto appsend;
+      }
+#endif /* UIP_SENDBUF */
       if(uip_outstanding(uip_connr)) {
 	goto drop;
       }
@@ -1624,6 +2027,21 @@ uip_process(u8_t flag)
       tmp16 = uip_connr->initialmss;
     }
     uip_connr->mss = tmp16;
+#if UIP_SENDBUF
+    /* A buffered connection fills the whole window advertised by the
+       peer, within the limits of its buffer. When the window closes,
+       the persist timer is started; when it opens again, the probes
+       sent meanwhile no longer count as retransmissions. */
+    if(uip_connr->sbuf != NULL) {
+      tmp16 = ((u16_t)BUF->wnd[0] << 8) + (u16_t)BUF->wnd[1];
+      if(tmp16 == 0 && uip_connr->sbuf->wnd != 0) {
+	uip_connr->timer = uip_connr->rto;
+      } else if(tmp16 != 0 && uip_connr->sbuf->wnd == 0) {
+	uip_connr->nrtx = 0;
+      }
+      uip_connr->sbuf->wnd = tmp16;
+    }
+#endif /* UIP_SENDBUF */
 
     /* If this packet constitutes an ACK for outstanding data (flagged
        by the UIP_ACKDATA flag, we should call the application since it
@@ -1643,7 +2061,7 @@ uip_process(u8_t flag)
        send, uip_len must be set to 0. */
     if(uip_flags & (UIP_NEWDATA | UIP_ACKDATA)) {
       uip_slen = 0;
-      UIP_APPCALL();
+      UIP_TCP_APPCALL();
 
     appsend:
       
@@ -1654,6 +2072,33 @@ uip_process(u8_t flag)
 	goto tcp_send_nodata;
       }
 
+#if UIP_SENDBUF
+      /* A close of a buffered connection is deferred until all its
+	 data has been acknowledged. */
+      if(uip_connr->sbuf != NULL) {
+	if(uip_flags & UIP_CLOSE) {
+	  uip_connr->sbuf->closing = 1;
+	}
+	if(uip_connr->sbuf->count > 0) {
+	  uip_flags &= ~UIP_CLOSE;
+	} else if(uip_connr->sbuf->finrcvd) {
+	  /* The buffer has drained after the peer closed the
+	     connection: process its FIN now, as if it had just
+	     arrived. */
+	  if(!uip_connr->sbuf->closing) {
+	    uip_flags = UIP_CLOSE;
+	    UIP_APPCALL();
+	  }
+	  uip_connr->len = 1;
+	  uip_connr->tcpstateflags = UIP_LAST_ACK;
+	  uip_connr->nrtx = 0;
+	  goto tcp_send_finack;
+	} else if(uip_connr->sbuf->closing) {
+	  uip_flags |= UIP_CLOSE;
+	}
+      }
+#endif /* UIP_SENDBUF */
+
       if(uip_flags & UIP_CLOSE) {
 	uip_slen = 0;
 	uip_connr->len = 1;
@@ -1663,6 +2108,27 @@ uip_process(u8_t flag)
 	goto tcp_send_nodata;
       }
 
+#if UIP_SENDBUF
+      /* A buffered connection sends the next segment from its
+	 buffer, if the window allows. */
+      if(uip_connr->sbuf != NULL) {
+	uip_slen = sendbuf_fill(uip_connr);
+      sendbuf_send:
+	uip_appdata = uip_sappdata;
+	if(uip_slen > 0) {
+	  uip_len = uip_slen + UIP_TCPIP_HLEN;
+	  BUF->flags = TCP_ACK | TCP_PSH;
+	  goto tcp_send_noopts;
+	}
+	if(uip_flags & UIP_NEWDATA) {
+	  uip_len = UIP_TCPIP_HLEN;
+	  BUF->flags = TCP_ACK;
+	  goto tcp_send_noopts;
+	}
+	goto drop;
+      }
+#endif /* UIP_SENDBUF */
+
       /* If uip_slen > 0, the application has data to be sent. */
       if(uip_slen > 0) {
 
@@ -1804,10 +2270,26 @@ uip_process(u8_t flag)
   BUF->ackno[2] = uip_connr->rcv_nxt[2];
   BUF->ackno[3] = uip_connr->rcv_nxt[3];
   
-  BUF->seqno[0] = uip_connr->snd_nxt[0];
-  BUF->seqno[1] = uip_connr->snd_nxt[1];
-  BUF->seqno[2] = uip_connr->snd_nxt[2];
-  BUF->seqno[3] = uip_connr->snd_nxt[3];
+#if UIP_SENDBUF
+  /* On a buffered connection, snd_nxt is the oldest unacknowledged
+     byte and the uip_slen bytes being sent are the last ones counted
+     in ->len. Segments without data carry the sequence number of the
+     next new byte. */
+  if(uip_connr->sbuf != NULL &&
+     (uip_connr->tcpstateflags & UIP_TS_MASK) == UIP_ESTABLISHED) {
+    uip_add32(uip_connr->snd_nxt, uip_connr->len - uip_slen);
+    BUF->seqno[0] = uip_acc32[0];
+    BUF->seqno[1] = uip_acc32[1];
+    BUF->seqno[2] = uip_acc32[2];
+    BUF->seqno[3] = uip_acc32[3];
+  } else
+#endif /* UIP_SENDBUF */
+  {
+    BUF->seqno[0] = uip_connr->snd_nxt[0];
+    BUF->seqno[1] = uip_connr->snd_nxt[1];
+    BUF->seqno[2] = uip_connr->snd_nxt[2];
+    BUF->seqno[3] = uip_connr->snd_nxt[3];
+  }
 
   BUF->proto = UIP_PROTO_TCP;
   
@@ -1890,8 +2372,18 @@ uip_send(const void *data, int len)
   if(len > 0) {
     uip_slen = len;
     if(data != uip_sappdata) {
+#if UIP_ARCH_CHKSUM
+      uip_sappchksum = uip_chksum_copy(uip_sappdata, data, uip_slen);
+      uip_sappchksum_len = uip_slen;
+#else /* UIP_ARCH_CHKSUM */
       memcpy(uip_sappdata, (data), uip_slen);
+#endif /* UIP_ARCH_CHKSUM */
     }
+#if UIP_ARCH_CHKSUM
+    else {
+      uip_sappchksum_len = 0;
+    }
+#endif /* UIP_ARCH_CHKSUM */
   }
 }
 /** @} */
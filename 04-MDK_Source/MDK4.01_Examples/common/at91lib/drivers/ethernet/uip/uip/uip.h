@@ -537,6 +537,78 @@ struct uip_conn *uip_connect(uip_ipaddr_t *ripaddr, u16_t port);
  */
 void uip_send(const void *data, int len);
 
+#if UIP_SENDBUF
+/**
+ * Attach a send buffer to the current connection.
+ *
+ * This function takes a buffer from the send buffer pool and attaches
+ * it to the current connection, which must just have been connected
+ * (uip_connected() is true). From then on, the application queues its
+ * data with uip_sendbuf_write() instead of uip_send(). uIP keeps up to
+ * UIP_SENDBUF_SIZE bytes in flight, retransmits them from the buffer
+ * and releases them as they are acknowledged, so the application is
+ * never invoked with the uip_rexmit() flag. The uip_acked() flag tells
+ * that buffer space has been freed.
+ *
+ * A close requested with uip_close() is deferred until all buffered
+ * data has been acknowledged; the application is not invoked again in
+ * the meantime. A FIN from the peer is acknowledged when it arrives,
+ * but the application only sees uip_closed() once the buffer has
+ * drained. The buffer returns to the pool when the connection is
+ * closed.
+ *
+ * When the peer advertises a zero window, the queued data waits and
+ * the window is probed with one byte on each expiry of the
+ * retransmission timer, with exponential backoff. The connection is
+ * not timed out while the window stays closed.
+ *
+ * \return Non-zero if a buffer was attached, zero if the pool is
+ * exhausted, in which case the connection keeps using uip_send().
+ */
+u8_t uip_sendbuf_attach(void);
+
+/**
+ * Queue data in the send buffer of a connection.
+ *
+ * The data is copied into the buffer and sent out by uIP as the send
+ * window allows. This function can be called from the application
+ * function, or from outside of it followed by uip_poll_conn() to get
+ * the data going.
+ *
+ * \param conn A pointer to a connection with a send buffer attached.
+ *
+ * \param data A pointer to the data which is to be queued.
+ *
+ * \param len The number of bytes to queue.
+ *
+ * \return The number of bytes actually queued, which is less than len
+ * if the buffer is full.
+ */
+u16_t uip_sendbuf_write(struct uip_conn *conn, const void *data, u16_t len);
+
+/**
+ * Check if a buffered connection has queued data that the send window
+ * allows to go out now.
+ *
+ * uIP sends at most one segment each time it processes a
+ * connection. The device driver loop should call uip_poll_conn() on a
+ * connection, and send out the resulting packet, for as long as this
+ * function returns true, in order to fill the window.
+ *
+ * \param conn A pointer to the uip_conn structure for the connection.
+ */
+u8_t uip_sendbuf_ready(struct uip_conn *conn);
+
+/**
+ * The number of free bytes in the send buffer of a connection.
+ *
+ * \param conn A pointer to a connection with a send buffer attached.
+ *
+ * \hideinitializer
+ */
+#define uip_sendbuf_space(conn) (UIP_SENDBUF_SIZE - (conn)->sbuf->count)
+#endif /* UIP_SENDBUF */
+
 /**
  * The length of any incoming data that is currently avaliable (if avaliable)
  * in the uip_appdata buffer.
@@ -1140,6 +1212,27 @@ extern u16_t uip_urglen, uip_surglen;
 #endif /* UIP_URGDATA > 0 */
 
 
+#if UIP_SENDBUF
+/**
+ * \internal
+ *
+ * A send buffer from the pool. The data is kept in a ring starting
+ * with the oldest unacknowledged byte: the first len bytes of the
+ * owning connection are in flight, the rest is waiting to be sent.
+ */
+struct uip_sendbuf {
+  struct uip_conn *conn; /**< The connection using the buffer. */
+  u16_t head;            /**< Offset of the oldest unacknowledged byte. */
+  u16_t count;           /**< Number of bytes held in the buffer. */
+  u16_t wnd;             /**< The window advertised by the peer. */
+  u8_t closing;          /**< Set when the application has closed the
+			    connection. */
+  u8_t finrcvd;          /**< Set when the peer has closed the
+			    connection while data was buffered. */
+  u8_t *data;            /**< The UIP_SENDBUF_SIZE bytes of the ring. */
+};
+#endif /* UIP_SENDBUF */
+
 /**
  * Representation of a uIP TCP connection.
  *
@@ -1175,6 +1268,12 @@ struct uip_conn {
   u8_t timer;         /**< The retransmission timer. */
   u8_t nrtx;          /**< The number of retransmissions for the last
 			 segment sent. */
+#if UIP_SENDBUF
+  struct uip_sendbuf *sbuf; /**< The send buffer attached to the
+			       connection, or NULL. */
+#endif /* UIP_SENDBUF */
+  struct uip_conn *hnext; /**< \internal Next connection in the same
+			     demultiplexing hash chain. */
 
   /** The application state. */
   uip_tcp_appstate_t appstate;
@@ -0,0 +1,323 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support 
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2008, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * ----------------------------------------------------------------------------
+ */
+
+/*
+ * Checksum functions of uIP for 32-bit CPUs, used when UIP_ARCH_CHKSUM
+ * is set to 1 in uip-conf.h. They replace the generic functions of
+ * uip.c, which sum the data one byte pair at a time.
+ *
+ * The data is summed 32 bits at a time into a 64-bit accumulator, which
+ * the compiler turns into an add with carry on ARM, so no carry test is
+ * needed in the loops. The 16-bit words are summed in CPU byte order and
+ * the result is swapped once at the end; data starting on an odd address
+ * is handled by summing its first byte apart.
+ *
+ * uip_chksum_copy() copies the data given to uip_send() into the packet
+ * buffer and sums it in the same pass. The sum is kept by uip_send() and
+ * used by uip_tcpchksum() and uip_udpchksum() instead of reading the data
+ * again.
+ */
+
+#include "uip.h"
+#include "uip_arch.h"
+
+#include <string.h>
+
+#if UIP_ARCH_CHKSUM
+
+#define BUF ((struct uip_tcpip_hdr *)&uip_buf[UIP_LLH_LEN])
+
+/*---------------------------------------------------------------------------*/
+/* Folds a 32-bit one's complement sum to 16 bits. */
+static u16_t
+fold(unsigned int acc)
+{
+  acc = (acc >> 16) + (acc & 0xffff);
+  acc += acc >> 16;
+  return (u16_t)acc;
+}
+/*---------------------------------------------------------------------------*/
+/* Folds a 64-bit one's complement sum to 32 bits. */
+static unsigned int
+fold64(unsigned long long acc)
+{
+  acc = (acc >> 32) + (acc & 0xffffffff);
+  acc += acc >> 32;
+  return (unsigned int)acc;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Converts the sum of CPU order words to the sum of network order words
+ * in host byte order, as returned by chksum(). When the data started on
+ * an odd address, the first byte has been left out of the sum.
+ */
+static u16_t
+to_host(unsigned int acc, u8_t odd, u8_t first)
+{
+  u16_t sum = fold(acc);
+
+#if UIP_BYTE_ORDER == UIP_BIG_ENDIAN
+  if(odd) {
+#else /* UIP_BYTE_ORDER == UIP_BIG_ENDIAN */
+  if(!odd) {
+#endif /* UIP_BYTE_ORDER == UIP_BIG_ENDIAN */
+    sum = (sum << 8) | (sum >> 8);
+  }
+  if(odd) {
+    sum = fold((unsigned int)sum + ((unsigned int)first << 8));
+  }
+  return sum;
+}
+/*---------------------------------------------------------------------------*/
+/* Sums the last byte of the data, the high byte of a network word. */
+static unsigned int
+last_byte(const u8_t *data)
+{
+#if UIP_BYTE_ORDER == UIP_BIG_ENDIAN
+  return (unsigned int)data[0] << 8;
+#else /* UIP_BYTE_ORDER == UIP_BIG_ENDIAN */
+  return data[0];
+#endif /* UIP_BYTE_ORDER == UIP_BIG_ENDIAN */
+}
+/*---------------------------------------------------------------------------*/
+/* Sums the CPU order words of data starting on an even address. */
+static unsigned int
+sum_words(const u8_t *data, u16_t len)
+{
+  unsigned long long acc = 0;
+  const unsigned int *p;
+
+  if(((unsigned long)data & 2) && len >= 2) {
+    acc += *(const u16_t *)data;
+    data += 2;
+    len -= 2;
+  }
+
+  p = (const unsigned int *)data;
+  while(len >= 32) {
+    acc += p[0];
+    acc += p[1];
+    acc += p[2];
+    acc += p[3];
+    acc += p[4];
+    acc += p[5];
+    acc += p[6];
+    acc += p[7];
+    p += 8;
+    len -= 32;
+  }
+  while(len >= 4) {
+    acc += *p++;
+    len -= 4;
+  }
+
+  data = (const u8_t *)p;
+  if(len >= 2) {
+    acc += *(const u16_t *)data;
+    data += 2;
+    len -= 2;
+  }
+  if(len) {
+    acc += last_byte(data);
+  }
+  return fold64(acc);
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Copies data and sums its CPU order words. The source and destination
+ * start on even addresses, with the same alignment on 32 bits.
+ */
+static unsigned int
+copy_sum_words(u8_t *dst, const u8_t *src, u16_t len)
+{
+  unsigned long long acc = 0;
+  unsigned int *d;
+  const unsigned int *s;
+  unsigned int w0, w1, w2, w3;
+
+  if(((unsigned long)src & 2) && len >= 2) {
+    *(u16_t *)dst = *(const u16_t *)src;
+    acc += *(const u16_t *)src;
+    src += 2;
+    dst += 2;
+    len -= 2;
+  }
+
+  d = (unsigned int *)dst;
+  s = (const unsigned int *)src;
+  while(len >= 16) {
+    w0 = s[0];
+    w1 = s[1];
+    w2 = s[2];
+    w3 = s[3];
+    d[0] = w0;
+    d[1] = w1;
+    d[2] = w2;
+    d[3] = w3;
+    acc += w0;
+    acc += w1;
+    acc += w2;
+    acc += w3;
+    s += 4;
+    d += 4;
+    len -= 16;
+  }
+  while(len >= 4) {
+    w0 = *s++;
+    *d++ = w0;
+    acc += w0;
+    len -= 4;
+  }
+
+  dst = (u8_t *)d;
+  src = (const u8_t *)s;
+  if(len >= 2) {
+    *(u16_t *)dst = *(const u16_t *)src;
+    acc += *(const u16_t *)src;
+    src += 2;
+    dst += 2;
+    len -= 2;
+  }
+  if(len) {
+    *dst = *src;
+    acc += last_byte(src);
+  }
+  return fold64(acc);
+}
+/*---------------------------------------------------------------------------*/
+static u16_t
+chksum(u16_t sum, const u8_t *data, u16_t len)
+{
+  u8_t odd;
+
+  if(len == 0) {
+    return sum;
+  }
+
+  odd = (unsigned long)data & 1;
+  return fold((unsigned int)sum +
+              to_host(sum_words(data + odd, len - odd), odd, data[0]));
+}
+/*---------------------------------------------------------------------------*/
+u16_t
+uip_chksum(u16_t *data, u16_t len)
+{
+  return htons(chksum(0, (u8_t *)data, len));
+}
+/*---------------------------------------------------------------------------*/
+u16_t
+uip_chksum_copy(void *dst, const void *src, u16_t len)
+{
+  const u8_t *s = (const u8_t *)src;
+  u8_t *d = (u8_t *)dst;
+  u8_t odd;
+
+  /* The words can only be copied when both buffers have the same
+     alignment. */
+  if((((unsigned long)d ^ (unsigned long)s) & 3) != 0) {
+    memcpy(d, s, len);
+    return chksum(0, d, len);
+  }
+  if(len == 0) {
+    return 0;
+  }
+
+  odd = (unsigned long)s & 1;
+  if(odd) {
+    d[0] = s[0];
+  }
+  return to_host(copy_sum_words(d + odd, s + odd, len - odd), odd, s[0]);
+}
+/*---------------------------------------------------------------------------*/
+u16_t
+uip_ipchksum(void)
+{
+  u16_t sum;
+
+  sum = chksum(0, &uip_buf[UIP_LLH_LEN], UIP_IPH_LEN);
+  return (sum == 0) ? 0xffff : htons(sum);
+}
+/*---------------------------------------------------------------------------*/
+static u16_t
+upper_layer_chksum(u8_t proto, u16_t hdrlen)
+{
+  u16_t upper_layer_len;
+  u16_t sum;
+
+#if UIP_CONF_IPV6
+  upper_layer_len = (((u16_t)(BUF->len[0]) << 8) + BUF->len[1]);
+#else /* UIP_CONF_IPV6 */
+  upper_layer_len = (((u16_t)(BUF->len[0]) << 8) + BUF->len[1]) - UIP_IPH_LEN;
+#endif /* UIP_CONF_IPV6 */
+
+  /* First sum pseudoheader. */
+
+  /* IP protocol and length fields. This addition cannot carry. */
+  sum = upper_layer_len + proto;
+  /* Sum IP source and destination addresses. */
+  sum = chksum(sum, (u8_t *)&BUF->srcipaddr[0], 2 * sizeof(uip_ipaddr_t));
+
+  /* When the data has been summed by uip_send(), only sum the header. The
+     header length is even, so the data sum can be added as is. */
+  if(uip_sappchksum_len != 0 &&
+     upper_layer_len == hdrlen + uip_sappchksum_len &&
+     &uip_buf[UIP_IPH_LEN + UIP_LLH_LEN + hdrlen] == uip_sappdata) {
+    sum = chksum(sum, &uip_buf[UIP_IPH_LEN + UIP_LLH_LEN], hdrlen);
+    sum = fold((unsigned int)sum + uip_sappchksum);
+  } else {
+    /* Sum TCP header and data. */
+    sum = chksum(sum, &uip_buf[UIP_IPH_LEN + UIP_LLH_LEN], upper_layer_len);
+  }
+
+  return (sum == 0) ? 0xffff : htons(sum);
+}
+/*---------------------------------------------------------------------------*/
+#if UIP_CONF_IPV6
+u16_t
+uip_icmp6chksum(void)
+{
+  return upper_layer_chksum(UIP_PROTO_ICMP6, 0);
+}
+#endif /* UIP_CONF_IPV6 */
+/*---------------------------------------------------------------------------*/
+u16_t
+uip_tcpchksum(void)
+{
+  return upper_layer_chksum(UIP_PROTO_TCP, (BUF->tcpoffset >> 4) << 2);
+}
+/*---------------------------------------------------------------------------*/
+#if UIP_UDP_CHECKSUMS
+u16_t
+uip_udpchksum(void)
+{
+  return upper_layer_chksum(UIP_PROTO_UDP, UIP_UDPH_LEN);
+}
+#endif /* UIP_UDP_CHECKSUMS */
+/*---------------------------------------------------------------------------*/
+#endif /* UIP_ARCH_CHKSUM */
@@ -132,6 +132,29 @@ u16_t uip_tcpchksum(void);
 
 u16_t uip_udpchksum(void);
 
+#if UIP_ARCH_CHKSUM
+/**
+ * Copy data and calculate its checksum in the same pass.
+ *
+ * Used by uip_send() when UIP_ARCH_CHKSUM is set, the result is kept
+ * in uip_sappchksum so that the data is not read again when the TCP
+ * or UDP checksum is calculated.
+ *
+ * \param dst A pointer to the destination buffer.
+ *
+ * \param src A pointer to the data to copy.
+ *
+ * \param len The length of the data.
+ *
+ * \return The checksum of the data in host byte order, not
+ * complemented.
+ */
+u16_t uip_chksum_copy(void *dst, const void *src, u16_t len);
+
+extern u16_t uip_sappchksum, uip_sappchksum_len;
+extern void *uip_sappdata;
+#endif /* UIP_ARCH_CHKSUM */
+
 /** @} */
 /** @} */
 
@@ -96,10 +96,19 @@ struct ethip_hdr {
 
 #define ARP_HWTYPE_ETH 1
 
+/* The ARP table is a hash table with open addressing and linear
+   probing. It is filled to at most 3/4 of UIP_ARPTAB_SIZE, so that
+   lookups stay short and always end on an unused entry. */
+#if UIP_ARPTAB_SIZE < 2
+#error UIP_ARPTAB_SIZE must be at least 2
+#endif
+#define ARPTAB_MAXUSED (UIP_ARPTAB_SIZE - (UIP_ARPTAB_SIZE + 3) / 4)
+
 struct arp_entry {
   u16_t ipaddr[2];
   struct uip_eth_addr ethaddr;
-  u8_t time;
+  u8_t time;                   /* When the mapping was last learnt. */
+  u8_t used;                   /* When the mapping was last used. */
 };
 
 static const struct uip_eth_addr broadcast_ethaddr =
@@ -107,11 +116,28 @@ static const struct uip_eth_addr broadcast_ethaddr =
 static const u16_t broadcast_ipaddr[2] = {0xffff,0xffff};
 
 static struct arp_entry arp_table[UIP_ARPTAB_SIZE];
+static u16_t arptab_used;
 static u16_t ipaddr[2];
-static u8_t i, c;
+static u16_t i;
 
 static u8_t arptime;
-static u8_t tmpage;
+
+#if UIP_ARP_QUEUE
+/* The last IP packet that could not be sent because its next hop was
+   not in the ARP table. It is sent when the ARP reply comes in. */
+static u8_t arp_queue[UIP_BUFSIZE];
+static u16_t arp_queue_len;
+static u16_t arp_queue_ipaddr[2];
+static u8_t arp_queue_time;
+#endif /* UIP_ARP_QUEUE */
+
+#if UIP_ARP_PIN_DRADDR
+#define ARP_PINNED(tabptr) uip_ipaddr_cmp((tabptr)->ipaddr, uip_draddr)
+#else /* UIP_ARP_PIN_DRADDR */
+#define ARP_PINNED(tabptr) 0
+#endif /* UIP_ARP_PIN_DRADDR */
+
+#define ARP_UNUSED(tabptr) (((tabptr)->ipaddr[0] | (tabptr)->ipaddr[1]) == 0)
 
 #define BUF   ((struct arp_hdr *)&uip_buf[0])
 #define IPBUF ((struct ethip_hdr *)&uip_buf[0])
@@ -127,6 +153,68 @@ uip_arp_init(void)
   for(i = 0; i < UIP_ARPTAB_SIZE; ++i) {
     memset(arp_table[i].ipaddr, 0, 4);
   }
+  arptab_used = 0;
+#if UIP_ARP_QUEUE
+  arp_queue_len = 0;
+#endif /* UIP_ARP_QUEUE */
+}
+/*-----------------------------------------------------------------------------------*/
+static u16_t
+arp_hash(u16_t *ipaddr)
+{
+  u16_t h;
+
+  /* Hosts on the same network mostly differ in the last byte of the
+     address, so fold the high byte down. */
+  h = ipaddr[0] ^ ipaddr[1];
+  return (u16_t)(h ^ (h >> 8)) % UIP_ARPTAB_SIZE;
+}
+/*-----------------------------------------------------------------------------------*/
+static struct arp_entry *
+arp_lookup(u16_t *ipaddr)
+{
+  register struct arp_entry *tabptr;
+  u16_t n;
+
+  n = arp_hash(ipaddr);
+  for(;;) {
+    tabptr = &arp_table[n];
+    if(ARP_UNUSED(tabptr)) {
+      return NULL;
+    }
+    if(uip_ipaddr_cmp(ipaddr, tabptr->ipaddr)) {
+      return tabptr;
+    }
+    if(++n == UIP_ARPTAB_SIZE) {
+      n = 0;
+    }
+  }
+}
+/*-----------------------------------------------------------------------------------*/
+static void
+arp_remove(u16_t n)
+{
+  u16_t j, k;
+
+  /* Shift the following entries of the probe sequence back into the
+     hole, unless their home position lies cyclically in ]n, j]. */
+  j = n;
+  for(;;) {
+    if(++j == UIP_ARPTAB_SIZE) {
+      j = 0;
+    }
+    if(ARP_UNUSED(&arp_table[j])) {
+      break;
+    }
+    k = arp_hash(arp_table[j].ipaddr);
+    if((n <= j) ? (n < k && k <= j) : (n < k || k <= j)) {
+      continue;
+    }
+    arp_table[n] = arp_table[j];
+    n = j;
+  }
+  memset(arp_table[n].ipaddr, 0, 4);
+  --arptab_used;
 }
 /*-----------------------------------------------------------------------------------*/
 /**
@@ -144,77 +232,73 @@ uip_arp_timer(void)
   struct arp_entry *tabptr;
   
   ++arptime;
-  for(i = 0; i < UIP_ARPTAB_SIZE; ++i) {
+  /* Removing an entry may shift a later one into its place, so the
+     same index is checked again. */
+  for(i = 0; i < UIP_ARPTAB_SIZE;) {
     tabptr = &arp_table[i];
-    if((tabptr->ipaddr[0] | tabptr->ipaddr[1]) != 0 &&
-       arptime - tabptr->time >= UIP_ARP_MAXAGE) {
-      memset(tabptr->ipaddr, 0, 4);
+    if(!ARP_UNUSED(tabptr) && !ARP_PINNED(tabptr) &&
+       (u8_t)(arptime - tabptr->time) >= UIP_ARP_MAXAGE) {
+      arp_remove(i);
+    } else {
+      ++i;
     }
   }
 
+#if UIP_ARP_QUEUE
+  /* Give up on a queued packet after one period. */
+  if(arp_queue_len > 0 && arp_queue_time != arptime) {
+    arp_queue_len = 0;
+  }
+#endif /* UIP_ARP_QUEUE */
 }
 /*-----------------------------------------------------------------------------------*/
 static void
 uip_arp_update(u16_t *ipaddr, struct uip_eth_addr *ethaddr)
 {
   register struct arp_entry *tabptr;
-  /* Walk through the ARP mapping table and try to find an entry to
-     update. If none is found, the IP -> MAC address mapping is
-     inserted in the ARP table. */
-  for(i = 0; i < UIP_ARPTAB_SIZE; ++i) {
-
-    tabptr = &arp_table[i];
-    /* Only check those entries that are actually in use. */
-    if(tabptr->ipaddr[0] != 0 &&
-       tabptr->ipaddr[1] != 0) {
-
-      /* Check if the source IP address of the incoming packet matches
-         the IP address in this ARP table entry. */
-      if(ipaddr[0] == tabptr->ipaddr[0] &&
-	 ipaddr[1] == tabptr->ipaddr[1]) {
-	 
-	/* An old entry found, update this and return. */
-	memcpy(tabptr->ethaddr.addr, ethaddr->addr, 6);
-	tabptr->time = arptime;
-
+  u16_t n;
+  u8_t age, maxage;
+
+  /* Look the IP address up in the hash table and update its mapping,
+     if there is one. */
+  tabptr = arp_lookup(ipaddr);
+  if(tabptr == NULL) {
+
+    /* If the table is full, throw away the least recently used
+       mapping that is not pinned. */
+    if(arptab_used >= ARPTAB_MAXUSED) {
+      maxage = 0;
+      n = UIP_ARPTAB_SIZE;
+      for(i = 0; i < UIP_ARPTAB_SIZE; ++i) {
+	tabptr = &arp_table[i];
+	age = arptime - tabptr->used;
+	if(!ARP_UNUSED(tabptr) && !ARP_PINNED(tabptr) &&
+	   (n == UIP_ARPTAB_SIZE || age > maxage)) {
+	  maxage = age;
+	  n = i;
+	}
+      }
+      if(n == UIP_ARPTAB_SIZE) {
 	return;
       }
+      arp_remove(n);
     }
-  }
 
-  /* If we get here, no existing ARP table entry was found, so we
-     create one. */
-
-  /* First, we try to find an unused entry in the ARP table. */
-  for(i = 0; i < UIP_ARPTAB_SIZE; ++i) {
-    tabptr = &arp_table[i];
-    if(tabptr->ipaddr[0] == 0 &&
-       tabptr->ipaddr[1] == 0) {
-      break;
-    }
-  }
-
-  /* If no unused entry is found, we try to find the oldest entry and
-     throw it away. */
-  if(i == UIP_ARPTAB_SIZE) {
-    tmpage = 0;
-    c = 0;
-    for(i = 0; i < UIP_ARPTAB_SIZE; ++i) {
-      tabptr = &arp_table[i];
-      if(arptime - tabptr->time > tmpage) {
-	tmpage = arptime - tabptr->time;
-	c = i;
+    /* Insert the mapping at the first unused entry of its probe
+       sequence. */
+    n = arp_hash(ipaddr);
+    while(!ARP_UNUSED(&arp_table[n])) {
+      if(++n == UIP_ARPTAB_SIZE) {
+	n = 0;
       }
     }
-    i = c;
-    tabptr = &arp_table[i];
+    tabptr = &arp_table[n];
+    memcpy(tabptr->ipaddr, ipaddr, 4);
+    ++arptab_used;
   }
 
-  /* Now, i is the ARP table entry which we will fill with the new
-     information. */
-  memcpy(tabptr->ipaddr, ipaddr, 4);
   memcpy(tabptr->ethaddr.addr, ethaddr->addr, 6);
-  tabptr->time = arptime;
+  tabptr->time = tabptr->used = arptime;
 }
 /*-----------------------------------------------------------------------------------*/
 /**
@@ -316,6 +400,19 @@ uip_arp_arpin(void)
        for us. */
     if(uip_ipaddr_cmp(BUF->dipaddr, uip_hostaddr)) {
       uip_arp_update(BUF->sipaddr, &BUF->shwaddr);
+#if UIP_ARP_QUEUE
+      /* If a packet was waiting for this reply, it is now sent. */
+      if(arp_queue_len > 0 &&
+	 uip_ipaddr_cmp(BUF->sipaddr, arp_queue_ipaddr)) {
+	memcpy(IPBUF->ethhdr.dest.addr, BUF->shwaddr.addr, 6);
+	memcpy(IPBUF->ethhdr.src.addr, uip_ethaddr.addr, 6);
+	IPBUF->ethhdr.type = HTONS(UIP_ETHTYPE_IP);
+	memcpy(&uip_buf[sizeof(struct uip_eth_hdr)],
+	       &arp_queue[sizeof(struct uip_eth_hdr)], arp_queue_len);
+	uip_len = arp_queue_len + sizeof(struct uip_eth_hdr);
+	arp_queue_len = 0;
+      }
+#endif /* UIP_ARP_QUEUE */
     }
     break;
   }
@@ -340,7 +437,9 @@ uip_arp_arpin(void)
  * destination IP address, the packet in the uip_buf[] is replaced by
  * an ARP request packet for the IP address. The IP packet is dropped
  * and it is assumed that they higher level protocols (e.g., TCP)
- * eventually will retransmit the dropped packet.
+ * eventually will retransmit the dropped packet. With UIP_ARP_QUEUE,
+ * the packet is kept instead and uip_arp_arpin() puts it back into
+ * uip_buf[] when the ARP reply arrives.
  *
  * If the destination IP address is not on the local network, the IP
  * address of the default router is used instead.
@@ -377,14 +476,19 @@ uip_arp_out(void)
       uip_ipaddr_copy(ipaddr, IPBUF->destipaddr);
     }
       
-    for(i = 0; i < UIP_ARPTAB_SIZE; ++i) {
-      tabptr = &arp_table[i];
-      if(uip_ipaddr_cmp(ipaddr, tabptr->ipaddr)) {
-	break;
-      }
-    }
+    tabptr = arp_lookup(ipaddr);
+
+    if(tabptr == NULL) {
+#if UIP_ARP_QUEUE
+      /* Keep the IP packet until the ARP reply comes in. A packet
+	 that was already waiting is replaced. */
+      memcpy(&arp_queue[sizeof(struct uip_eth_hdr)],
+	     &uip_buf[sizeof(struct uip_eth_hdr)], uip_len);
+      arp_queue_len = uip_len;
+      uip_ipaddr_copy(arp_queue_ipaddr, ipaddr);
+      arp_queue_time = arptime;
+#endif /* UIP_ARP_QUEUE */
 
-    if(i == UIP_ARPTAB_SIZE) {
       /* The destination address was not in our ARP table, so we
 	 overwrite the IP packet with an ARP request. */
 
@@ -410,6 +514,7 @@ uip_arp_out(void)
 
     /* Build an ethernet header. */
     memcpy(IPBUF->ethhdr.dest.addr, tabptr->ethaddr.addr, 6);
+    tabptr->used = arptime;
   }
   memcpy(IPBUF->ethhdr.src.addr, uip_ethaddr.addr, 6);
   
@@ -99,8 +99,10 @@ void uip_arp_arpin(void);
    address (or the IP address of the default router) is present. If no
    such table entry is found, the IP packet is overwritten with an ARP
    request and we rely on TCP to retransmit the packet that was
-   overwritten. In any case, the uip_len variable holds the length of
-   the Ethernet frame that should be transmitted. */
+   overwritten, unless UIP_ARP_QUEUE is set, in which case the packet
+   is sent out of uip_arp_arpin() when the ARP reply comes in. In any
+   case, the uip_len variable holds the length of the Ethernet frame
+   that should be transmitted. */
 void uip_arp_out(void);
 
 /* The uip_arp_timer() function should be called every ten seconds. It
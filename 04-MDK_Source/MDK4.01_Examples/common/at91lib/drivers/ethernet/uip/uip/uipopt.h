@@ -248,10 +248,26 @@
 #endif /* UIP_CONF_MAX_CONNECTIONS */
 
 
+/**
+ * The number of hash chains used to find the connection of an
+ * incoming TCP segment.
+ *
+ * Defaults to UIP_CONNS, which keeps the chains one connection long
+ * on average. Each chain requires a pointer.
+ *
+ * \hideinitializer
+ */
+#ifndef UIP_CONF_CONNHASH_SIZE
+#define UIP_CONNHASH_SIZE UIP_CONNS
+#else /* UIP_CONF_CONNHASH_SIZE */
+#define UIP_CONNHASH_SIZE UIP_CONF_CONNHASH_SIZE
+#endif /* UIP_CONF_CONNHASH_SIZE */
+
 /**
  * The maximum number of simultaneously listening TCP ports.
  *
- * Each listening TCP port requires 2 bytes of memory.
+ * Each listening TCP port requires 2 bytes of memory. The ports are
+ * kept in a hash table, so a few spare slots keep lookups short.
  *
  * \hideinitializer
  */
@@ -327,6 +343,57 @@
  */
 #define UIP_TIME_WAIT_TIMEOUT 120
 
+/**
+ * Determines if support for per-connection send buffers should be
+ * compiled in.
+ *
+ * A connection that attaches a send buffer with uip_sendbuf_attach()
+ * may have several segments in flight at once. Its data is queued
+ * with uip_sendbuf_write() and retransmitted by uIP from the buffer,
+ * so the application is never asked to regenerate it. Connections
+ * without a buffer keep the single-segment behaviour.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_SENDBUF
+#define UIP_SENDBUF UIP_CONF_SENDBUF
+#else /* UIP_CONF_SENDBUF */
+#define UIP_SENDBUF 0
+#endif /* UIP_CONF_SENDBUF */
+
+/**
+ * The number of send buffers in the pool.
+ *
+ * This is the number of connections that can use a send buffer at
+ * the same time. Each buffer requires UIP_SENDBUF_SIZE bytes of
+ * memory.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_SENDBUF_CONNS
+#define UIP_SENDBUF_CONNS UIP_CONF_SENDBUF_CONNS
+#else /* UIP_CONF_SENDBUF_CONNS */
+#define UIP_SENDBUF_CONNS 2
+#endif /* UIP_CONF_SENDBUF_CONNS */
+
+/**
+ * The send window of a buffered connection, counted in segments of
+ * UIP_TCP_MSS bytes.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_SENDBUF_SEGMENTS
+#define UIP_SENDBUF_SEGMENTS UIP_CONF_SENDBUF_SEGMENTS
+#else /* UIP_CONF_SENDBUF_SEGMENTS */
+#define UIP_SENDBUF_SEGMENTS 4
+#endif /* UIP_CONF_SENDBUF_SEGMENTS */
+
+/**
+ * The size of each send buffer, which is also the largest amount of
+ * unacknowledged data a buffered connection may have in flight.
+ */
+#define UIP_SENDBUF_SIZE (UIP_SENDBUF_SEGMENTS * UIP_TCP_MSS)
+
 
 /** @} */
 /*------------------------------------------------------------------------------*/
@@ -339,7 +406,10 @@
  * The size of the ARP table.
  *
  * This option should be set to a larger value if this uIP node will
- * have many connections from the local network.
+ * have many connections from the local network. The table is a hash
+ * table that holds up to 3/4 of UIP_ARPTAB_SIZE mappings; a power of
+ * two makes the hashing cheaper. When it is full, the least recently
+ * used mapping is replaced.
  *
  * \hideinitializer
  */
@@ -349,6 +419,37 @@
 #define UIP_ARPTAB_SIZE 8
 #endif
 
+/**
+ * Determines if the ARP table entry of the default router is pinned.
+ *
+ * A pinned entry is never aged out or replaced by another mapping,
+ * so that traffic to other networks does not stall on an ARP request
+ * when the local network has many hosts.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_ARP_PIN_DRADDR
+#define UIP_ARP_PIN_DRADDR UIP_CONF_ARP_PIN_DRADDR
+#else
+#define UIP_ARP_PIN_DRADDR 0
+#endif
+
+/**
+ * Determines if an IP packet to a host that is not in the ARP table
+ * is kept until the ARP reply comes in.
+ *
+ * Without it, the packet is replaced by the ARP request and the
+ * upper layer has to retransmit it. The queue holds a single packet
+ * and requires UIP_BUFSIZE bytes of memory.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_ARP_QUEUE
+#define UIP_ARP_QUEUE UIP_CONF_ARP_QUEUE
+#else
+#define UIP_ARP_QUEUE 0
+#endif
+
 /**
  * The maxium age of ARP table entries measured in 10ths of seconds.
  *
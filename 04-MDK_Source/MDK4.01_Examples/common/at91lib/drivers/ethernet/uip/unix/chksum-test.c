@@ -0,0 +1,239 @@
+/**************************************************************************************
+* File Name          : chksum-test.c
+* Description        : Host test of the 32-bit uIP checksum functions (uip_arch.c).
+*                      uip_chksum() and uip_chksum_copy() are compared with a
+*                      reference byte pair sum for every start alignment and for
+*                      every length up to a full frame, odd ones included; then
+*                      both are timed on frame sized buffers.
+*
+* Build and run, from this directory:
+*
+*   gcc -O2 -I. -I../uip -I../lib -I../apps/webserver -I../apps/telnetd
+*       -I../apps/hello-world -I../apps/dhcpc -o chksum-test
+*       chksum-test.c ../uip/uip_arch.c
+*   ./chksum-test
+*
+* The exit status is 0 when every sum matches the reference.
+**************************************************************************************/
+
+//-----------------------------------------------------------------------------
+//         Headers
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "uip.h"
+#include "uip_arch.h"
+
+#if !UIP_ARCH_CHKSUM
+#error UIP_ARCH_CHKSUM must be set in uip-conf.h
+#endif
+
+//-----------------------------------------------------------------------------
+//         Local Define
+//-----------------------------------------------------------------------------
+
+/// Longest buffer checked, a full Ethernet frame
+#define MAX_LENGTH      1514
+
+/// Alignments checked, on 64-bit hosts too
+#define NUM_OFFSETS     8
+
+/// Iterations of the benchmark
+#define BENCH_LOOPS     200000
+
+//-----------------------------------------------------------------------------
+//         Variables used by uip_arch.c, normally defined in uip.c
+//-----------------------------------------------------------------------------
+
+u8_t uip_buf[UIP_BUFSIZE + 2];
+u16_t uip_sappchksum, uip_sappchksum_len;
+void *uip_sappdata;
+
+u16_t htons(u16_t val)
+{
+    return HTONS(val);
+}
+
+//-----------------------------------------------------------------------------
+//         Internal variables
+//-----------------------------------------------------------------------------
+
+static unsigned long long srcBuffer[(MAX_LENGTH + NUM_OFFSETS) / 8 + 1];
+static unsigned long long dstBuffer[(MAX_LENGTH + NUM_OFFSETS) / 8 + 1];
+
+//-----------------------------------------------------------------------------
+//         Local functions
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/// Monotonic time in nanoseconds
+//-----------------------------------------------------------------------------
+static unsigned long long Now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+//-----------------------------------------------------------------------------
+/// Reference one's complement sum of the network order 16-bit words of data,
+/// as computed by the generic chksum() of uip.c
+//-----------------------------------------------------------------------------
+static u16_t RefChksum(const u8_t *data, u16_t len)
+{
+    unsigned int sum = 0;
+    u16_t i;
+
+    for (i = 0; i + 1 < len; i += 2) {
+
+        sum += ((unsigned int)data[i] << 8) | data[i + 1];
+    }
+    if (len & 1) {
+
+        sum += (unsigned int)data[len - 1] << 8;
+    }
+    while (sum >> 16) {
+
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+    return (u16_t)sum;
+}
+
+//-----------------------------------------------------------------------------
+/// Fills the source buffer. All ones bytes are frequent so that the carries
+/// of the 32-bit sums are exercised.
+//-----------------------------------------------------------------------------
+static void Fill(unsigned int pattern)
+{
+    u8_t *p = (u8_t *)srcBuffer;
+    unsigned int i;
+
+    srand(pattern);
+    for (i = 0; i < sizeof(srcBuffer); i++) {
+
+        p[i] = (pattern == 0) ? 0xff : (u8_t)((rand() & 3) ? 0xff : rand());
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Checks uip_chksum() and uip_chksum_copy() against the reference for every
+/// alignment and length. Returns the number of mismatches.
+//-----------------------------------------------------------------------------
+static unsigned int Check(void)
+{
+    const u8_t *src;
+    u8_t *dst;
+    unsigned int errors = 0;
+    unsigned int so, dof;
+    u16_t len;
+    u16_t ref;
+    u16_t sum;
+
+    for (so = 0; so < NUM_OFFSETS; so++) {
+
+        src = (const u8_t *)srcBuffer + so;
+        for (len = 0; len <= MAX_LENGTH; len++) {
+
+            ref = RefChksum(src, len);
+            sum = uip_chksum((u16_t *)src, len);
+            if (sum != htons(ref)) {
+
+                printf("uip_chksum: offset %u length %u: 0x%04x, expected 0x%04x\n",
+                       so, len, sum, htons(ref));
+                errors++;
+            }
+
+            // Same and different alignments of the destination
+            for (dof = 0; dof < 4; dof++) {
+
+                dst = (u8_t *)dstBuffer + ((so & ~3u) + dof);
+                memset(dstBuffer, 0x5a, sizeof(dstBuffer));
+                sum = uip_chksum_copy(dst, src, len);
+                if (sum != ref) {
+
+                    printf("uip_chksum_copy: offsets %u/%u length %u: 0x%04x, expected 0x%04x\n",
+                           so, (so & ~3u) + dof, len, sum, ref);
+                    errors++;
+                }
+                if (memcmp(dst, src, len) != 0) {
+
+                    printf("uip_chksum_copy: offsets %u/%u length %u: bad copy\n",
+                           so, (so & ~3u) + dof, len);
+                    errors++;
+                }
+            }
+        }
+    }
+    return errors;
+}
+
+//-----------------------------------------------------------------------------
+/// Times the reference and uip_arch.c sums of a frame sized buffer
+//-----------------------------------------------------------------------------
+static void Bench(void)
+{
+    const u8_t *src = (const u8_t *)srcBuffer;
+    volatile u16_t sink = 0;
+    unsigned long long start;
+    double ref, sum, copy, memory;
+    unsigned int i;
+
+    start = Now();
+    for (i = 0; i < BENCH_LOOPS; i++) {
+
+        sink += RefChksum(src, MAX_LENGTH);
+    }
+    ref = (double)(Now() - start) / BENCH_LOOPS;
+
+    start = Now();
+    for (i = 0; i < BENCH_LOOPS; i++) {
+
+        sink += uip_chksum((u16_t *)src, MAX_LENGTH);
+    }
+    sum = (double)(Now() - start) / BENCH_LOOPS;
+
+    start = Now();
+    for (i = 0; i < BENCH_LOOPS; i++) {
+
+        sink += uip_chksum_copy(dstBuffer, src, MAX_LENGTH);
+    }
+    copy = (double)(Now() - start) / BENCH_LOOPS;
+
+    start = Now();
+    for (i = 0; i < BENCH_LOOPS; i++) {
+
+        memcpy(dstBuffer, src, MAX_LENGTH);
+        sink += RefChksum((u8_t *)dstBuffer, MAX_LENGTH);
+    }
+    memory = (double)(Now() - start) / BENCH_LOOPS;
+
+    printf("%u bytes: reference %.0f ns, uip_chksum %.0f ns (x%.1f)\n",
+           MAX_LENGTH, ref, sum, ref / sum);
+    printf("%u bytes: memcpy + reference %.0f ns, uip_chksum_copy %.0f ns (x%.1f)\n",
+           MAX_LENGTH, memory, copy, memory / copy);
+}
+
+//-----------------------------------------------------------------------------
+//         Exported functions
+//-----------------------------------------------------------------------------
+
+int main(void)
+{
+    unsigned int errors = 0;
+    unsigned int pattern;
+
+    for (pattern = 0; pattern < 4; pattern++) {
+
+        Fill(pattern);
+        errors += Check();
+    }
+    printf("%u offsets x %u lengths x 4 patterns: %u errors\n",
+           NUM_OFFSETS, MAX_LENGTH + 1, errors);
+
+    Bench();
+    return errors ? 1 : 0;
+}
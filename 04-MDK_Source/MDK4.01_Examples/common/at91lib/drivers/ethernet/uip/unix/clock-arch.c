@@ -0,0 +1,43 @@
+/**************************************************************************************
+* File Name          : clock-arch.c
+* Description        : uIP clock for the host build, in milliseconds
+**************************************************************************************/
+
+//-----------------------------------------------------------------------------
+//         Headers
+//-----------------------------------------------------------------------------
+
+#include <sys/time.h>
+#include "clock-arch.h"
+
+//-----------------------------------------------------------------------------
+///        Internal variables
+//-----------------------------------------------------------------------------
+
+/// Time of clock_init()
+static struct timeval start;
+
+//-----------------------------------------------------------------------------
+///        Global functions
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/// Initialize for clock time operation
+//-----------------------------------------------------------------------------
+void clock_init(void)
+{
+    gettimeofday(&start, 0);
+}
+
+//-----------------------------------------------------------------------------
+/// Read for clock time (ms)
+//-----------------------------------------------------------------------------
+clock_time_t
+clock_time(void)
+{
+    struct timeval now;
+
+    gettimeofday(&now, 0);
+    return (clock_time_t)((now.tv_sec - start.tv_sec) * 1000
+                          + (now.tv_usec - start.tv_usec) / 1000);
+}
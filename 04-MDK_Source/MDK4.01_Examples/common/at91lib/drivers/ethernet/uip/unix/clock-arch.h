@@ -0,0 +1,12 @@
+/**************************************************************************************
+* File Name          : clock-arch.h
+* Description        : uIP clock for the host build
+**************************************************************************************/
+
+#ifndef __CLOCK_ARCH_H__
+#define __CLOCK_ARCH_H__
+
+typedef int clock_time_t;
+#define CLOCK_CONF_SECOND 1000
+
+#endif /* __CLOCK_ARCH_H__ */
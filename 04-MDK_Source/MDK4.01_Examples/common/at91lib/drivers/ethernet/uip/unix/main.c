@@ -0,0 +1,411 @@
+/**************************************************************************************
+* File Name          : main.c
+* Description        : Host build of the EMAC uIP examples. The same uIP stack and
+*                      applications run as a Linux process on a TAP interface, or
+*                      on the frames of a pcap file replayed as fast as they are
+*                      processed, and report packet rate, latency and CPU time.
+*
+* Build, from this directory (define UIP_HOST_TELNETD or UIP_HOST_HELLO_WORLD
+* and list the sources of that application instead to run another one):
+*
+*   gcc -O2 -I. -I../uip -I../lib -I../apps/webserver -I../apps/telnetd
+*       -I../apps/hello-world -I../apps/dhcpc -o uip-host
+*       main.c tapdev.c clock-arch.c ../uip/uip.c ../uip/uip_arp.c
+*       ../uip/uip_arch.c ../uip/psock.c ../uip/timer.c ../lib/memb.c
+*       ../apps/webserver/httpd.c ../apps/webserver/httpd-fs.c
+*       ../apps/webserver/httpd-cgi.c ../apps/webserver/http-strings.c
+*
+* Run:
+*
+*   uip-host [-i tap0]                     serve on a TAP interface until ^C
+*   uip-host -r in.pcap [-n loops]         replay the frames of in.pcap
+*   ... [-w out.pcap]                      also capture the frames sent
+**************************************************************************************/
+
+//-----------------------------------------------------------------------------
+//         Headers
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "uip.h"
+#include "uip_arp.h"
+#include "tapdev.h"
+#include "timer.h"
+
+//-----------------------------------------------------------------------------
+//         Local Define
+//-----------------------------------------------------------------------------
+
+/// uIP buffer : The ETH header
+#define BUF ((struct uip_eth_hdr *)&uip_buf[0])
+
+//-----------------------------------------------------------------------------
+//         Internal variables
+//-----------------------------------------------------------------------------
+
+/// Set by SIGINT
+static volatile int stop;
+
+/// Time each received frame took, from its arrival to the last frame
+/// sent because of it, in nanoseconds
+static unsigned int *latency;
+static unsigned int latencyCount;
+static unsigned int latencySize;
+
+//-----------------------------------------------------------------------------
+//         Local functions
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/// Monotonic time in nanoseconds
+//-----------------------------------------------------------------------------
+static unsigned long long Now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+//-----------------------------------------------------------------------------
+/// Record the processing time of a frame
+//-----------------------------------------------------------------------------
+static void AddLatency(unsigned long long ns)
+{
+    if (latencyCount == latencySize) {
+
+        latencySize = latencySize ? latencySize * 2 : 65536;
+        latency = realloc(latency, latencySize * sizeof(*latency));
+        if (latency == NULL) {
+
+            perror("realloc");
+            exit(1);
+        }
+    }
+    latency[latencyCount++] = ns > 0xffffffffULL ? 0xffffffff : (unsigned int)ns;
+}
+
+static int CompareLatency(const void *a, const void *b)
+{
+    unsigned int x = *(const unsigned int *)a;
+    unsigned int y = *(const unsigned int *)b;
+
+    return x < y ? -1 : x > y;
+}
+
+//-----------------------------------------------------------------------------
+/// Return the given percentile of the sorted latencies
+//-----------------------------------------------------------------------------
+static unsigned int Percentile(unsigned int p)
+{
+    if (latencyCount == 0) {
+
+        return 0;
+    }
+    return latency[(unsigned long long)(latencyCount - 1) * p / 1000];
+}
+
+//-----------------------------------------------------------------------------
+/// Print the benchmark results
+//-----------------------------------------------------------------------------
+static void Report(unsigned long long wall)
+{
+    struct rusage ru;
+    unsigned long long cpu;
+
+    getrusage(RUSAGE_SELF, &ru);
+    cpu = (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000000ULL
+          + (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) * 1000ULL;
+    qsort(latency, latencyCount, sizeof(*latency), CompareLatency);
+
+    printf("=== Statistics ===\n");
+    printf(" .rx_packets = %u\n", latencyCount);
+    printf(" .tx_packets = %u\n", tapdev_sent());
+    printf(" .rx_packets_per_s = %.0f\n",
+           wall ? latencyCount * 1e9 / wall : 0.0);
+    printf(" .latency_ns p50 = %u p90 = %u p99 = %u p99.9 = %u max = %u\n",
+           Percentile(500), Percentile(900), Percentile(990), Percentile(999),
+           Percentile(1000));
+    printf(" .cpu_ns_per_packet = %.0f\n",
+           latencyCount ? (double)cpu / latencyCount : 0.0);
+#if UIP_STATISTICS
+    printf(" .ip_drop = %u\n", uip_stat.ip.drop);
+    printf(" .tcp_rexmit = %u\n", uip_stat.tcp.rexmit);
+    printf(" .tcp_syndrop = %u\n", uip_stat.tcp.syndrop);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+/// SIGINT handler: leave the main loop and report
+//-----------------------------------------------------------------------------
+static void Stop(int sig)
+{
+    stop = 1;
+}
+
+//-----------------------------------------------------------------------------
+/// Initialize demo application
+//-----------------------------------------------------------------------------
+static void app_init(void)
+{
+#if defined(UIP_HOST_TELNETD)
+    printf("P: APP Init ... telnetd\n");
+    telnetd_init();
+#elif defined(UIP_HOST_HELLO_WORLD)
+    printf("P: APP Init ... hello world\n");
+    hello_world_init();
+#else
+    printf("P: APP Init ... webserver\n");
+    httpd_init();
+#endif
+
+#ifdef __DHCPC_H__
+    printf("P: DHCPC Init\n");
+    dhcpc_init(MacAddress.addr, 6);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+//         Global functions
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/// Global function for uIP to use
+/// \param m Pointer to string that logged
+//-----------------------------------------------------------------------------
+void uip_log(char *m)
+{
+    printf("-uIP- %s\n", m);
+}
+
+#ifdef __DHCPC_H__
+//-----------------------------------------------------------------------------
+/// Global function for uIP DHCPC to use, notification of DHCP configuration
+/// \param s Pointer to DHCP state instance
+//-----------------------------------------------------------------------------
+void dhcpc_configured(const struct dhcpc_state *s)
+{
+    u8_t *pAddr = (u8_t *)s->ipaddr;
+
+    printf("- DHCP IP : %d.%d.%d.%d\n", pAddr[0], pAddr[1], pAddr[2], pAddr[3]);
+    uip_sethostaddr(s->ipaddr);
+    uip_setnetmask(s->netmask);
+    uip_setdraddr(s->default_router);
+}
+
+#if DHCPC_LEASE_STORE
+/// File that keeps the lease across runs: the dhcpc_state fields, lease_time
+/// holding the expiry date
+#define LEASE_FILE "dhcpc.lease"
+
+//-----------------------------------------------------------------------------
+/// Global function for uIP DHCPC to use, get the lease saved by an earlier run
+/// \param s Pointer to DHCP state instance to fill
+/// \return 1 if the lease has not expired, 0 otherwise
+//-----------------------------------------------------------------------------
+int dhcpc_lease_load(struct dhcpc_state *s)
+{
+    FILE *f = fopen(LEASE_FILE, "rb");
+    struct dhcpc_state saved;
+    unsigned long expiry;
+    int ok;
+
+    if (f == NULL) {
+
+        return 0;
+    }
+    ok = fread(&saved, sizeof(saved), 1, f) == 1;
+    fclose(f);
+
+    expiry = (unsigned long)ntohs(saved.lease_time[0]) << 16
+             | ntohs(saved.lease_time[1]);
+    if (!ok || expiry <= (unsigned long)time(NULL)) {
+
+        return 0;
+    }
+    expiry -= time(NULL);
+
+    memcpy(s->ipaddr, saved.ipaddr, 4);
+    memcpy(s->serverid, saved.serverid, 4);
+    memcpy(s->default_router, saved.default_router, 4);
+    memcpy(s->netmask, saved.netmask, 4);
+    s->lease_time[0] = HTONS(expiry >> 16);
+    s->lease_time[1] = HTONS(expiry & 0xffff);
+    return 1;
+}
+
+//-----------------------------------------------------------------------------
+/// Global function for uIP DHCPC to use, save or forget the lease
+/// \param s Pointer to DHCP state instance, NULL to forget the lease
+//-----------------------------------------------------------------------------
+void dhcpc_lease_store(const struct dhcpc_state *s)
+{
+    struct dhcpc_state saved;
+    unsigned long expiry;
+    FILE *f;
+
+    if (s == NULL) {
+
+        remove(LEASE_FILE);
+        return;
+    }
+    saved = *s;
+    expiry = time(NULL) + ((unsigned long)ntohs(s->lease_time[0]) << 16
+                           | ntohs(s->lease_time[1]));
+    saved.lease_time[0] = HTONS(expiry >> 16);
+    saved.lease_time[1] = HTONS(expiry & 0xffff);
+
+    f = fopen(LEASE_FILE, "wb");
+    if (f != NULL) {
+
+        fwrite(&saved, sizeof(saved), 1, f);
+        fclose(f);
+    }
+}
+#endif /* DHCPC_LEASE_STORE */
+#endif
+
+//-----------------------------------------------------------------------------
+/// Default main() function.
+/// Do initialization and process tasks.
+//-----------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    uip_ipaddr_t ipaddr;
+    struct timer periodic_timer, arp_timer;
+    const char *ifName = NULL, *pcapIn = NULL, *pcapOut = NULL;
+    unsigned int loops = 1;
+    unsigned long long start, received;
+    unsigned int i;
+    int c;
+
+    while ((c = getopt(argc, argv, "i:r:n:w:")) != -1) {
+
+        switch (c) {
+        case 'i': ifName = optarg; break;
+        case 'r': pcapIn = optarg; break;
+        case 'n': loops = atoi(optarg); break;
+        case 'w': pcapOut = optarg; break;
+        default:
+            fprintf(stderr, "usage: %s [-i tap] [-r in.pcap [-n loops]] [-w out.pcap]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    signal(SIGINT, Stop);
+
+    // System devices initialize
+    tapdev_config(ifName, pcapIn, loops ? loops : 1, pcapOut);
+    tapdev_init();
+    clock_init();
+    timer_set(&periodic_timer, CLOCK_SECOND / 2);
+    timer_set(&arp_timer, CLOCK_SECOND * 10);
+
+    // Init uIP
+    uip_init();
+
+#ifndef __DHCPC_H__
+    // Set the IP address of this host
+    uip_ipaddr(ipaddr, HostIpAddress[0], HostIpAddress[1],
+                       HostIpAddress[2], HostIpAddress[3]);
+    uip_sethostaddr(ipaddr);
+
+    uip_ipaddr(ipaddr, RoutIpAddress[0], RoutIpAddress[1],
+                       RoutIpAddress[2], RoutIpAddress[3]);
+    uip_setdraddr(ipaddr);
+
+    uip_ipaddr(ipaddr, NetMask[0], NetMask[1], NetMask[2], NetMask[3]);
+    uip_setnetmask(ipaddr);
+#else
+    uip_ipaddr(ipaddr, 0, 0, 0, 0);
+    uip_sethostaddr(ipaddr);
+    uip_setdraddr(ipaddr);
+    uip_setnetmask(ipaddr);
+#endif
+
+    uip_setethaddr(MacAddress);
+
+    app_init();
+
+    start = Now();
+    while (!stop && !tapdev_done()) {
+
+        received = 0;
+        uip_len = tapdev_read();
+        if(uip_len > 0) {
+            received = Now();
+            if(BUF->type == htons(UIP_ETHTYPE_IP)) {
+                uip_arp_ipin();
+                uip_input();
+                /* If the above function invocation resulted in data that
+                should be sent out on the network, the global variable
+                uip_len is set to a value > 0. */
+                if(uip_len > 0) {
+                    uip_arp_out();
+                    tapdev_send();
+                }
+            } else if(BUF->type == htons(UIP_ETHTYPE_ARP)) {
+                uip_arp_arpin();
+                /* If the above function invocation resulted in data that
+                should be sent out on the network, the global variable
+                uip_len is set to a value > 0. */
+                if(uip_len > 0) {
+                    tapdev_send();
+                }
+            }
+        } else if(timer_expired(&periodic_timer)) {
+            timer_reset(&periodic_timer);
+            for(i = 0; i < UIP_CONNS; i++) {
+                uip_periodic(i);
+                if(uip_len > 0) {
+                  uip_arp_out();
+                  tapdev_send();
+                }
+            }
+#if UIP_UDP
+            for(i = 0; i < UIP_UDP_CONNS; i++) {
+                uip_udp_periodic(i);
+                if(uip_len > 0) {
+                    uip_arp_out();
+                    tapdev_send();
+                }
+            }
+#endif /* UIP_UDP */
+
+            /* Call the ARP timer function every 10 seconds. */
+            if(timer_expired(&arp_timer)) {
+                timer_reset(&arp_timer);
+                uip_arp_timer();
+            }
+        }
+
+#if UIP_SENDBUF
+        // uIP sends one segment per call: keep polling the buffered
+        // connections until their send window is full.
+        for(i = 0; i < UIP_CONNS; i++) {
+            while(uip_sendbuf_ready(&uip_conns[i])) {
+                uip_poll_conn(&uip_conns[i]);
+                if(uip_len == 0) {
+                    break;
+                }
+                uip_arp_out();
+                tapdev_send();
+            }
+        }
+#endif /* UIP_SENDBUF */
+
+        if (received) {
+
+            AddLatency(Now() - received);
+        }
+    }
+
+    Report(Now() - start);
+    return 0;
+}
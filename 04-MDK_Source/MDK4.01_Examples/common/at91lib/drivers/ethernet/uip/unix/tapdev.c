@@ -0,0 +1,328 @@
+/**************************************************************************************
+* File Name          : tapdev.c
+* Description        : Network device of the host build: a Linux TAP interface,
+*                      or a pcap file replayed from memory
+**************************************************************************************/
+
+//-----------------------------------------------------------------------------
+//         Headers
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/select.h>
+#include <sys/time.h>
+#include <linux/if.h>
+#include <linux/if_tun.h>
+#include "uip.h"
+#include "tapdev.h"
+
+//-----------------------------------------------------------------------------
+//         Local Define
+//-----------------------------------------------------------------------------
+
+/// pcap magic numbers, microsecond timestamps
+#define PCAP_MAGIC          0xa1b2c3d4
+#define PCAP_MAGIC_SWAPPED  0xd4c3b2a1
+
+/// pcap link type of Ethernet frames
+#define PCAP_LINKTYPE_ETHERNET  1
+
+/// Time to wait for a frame from the TAP interface, in microseconds
+#define TAP_WAIT_US         10000
+
+//-----------------------------------------------------------------------------
+//         Local types
+//-----------------------------------------------------------------------------
+
+/// pcap file header
+typedef struct {
+    unsigned int   magic;
+    unsigned short major;
+    unsigned short minor;
+    int            thiszone;
+    unsigned int   sigfigs;
+    unsigned int   snaplen;
+    unsigned int   network;
+} PcapHeader;
+
+/// pcap record header
+typedef struct {
+    unsigned int sec;
+    unsigned int usec;
+    unsigned int caplen;
+    unsigned int len;
+} PcapRecord;
+
+//-----------------------------------------------------------------------------
+//         Internal variables
+//-----------------------------------------------------------------------------
+
+/// Configuration
+static const char *tapName = "tap0";
+static const char *inName;
+static const char *outName;
+static unsigned int replayLoops = 1;
+
+/// TAP interface
+static int tapFd = -1;
+
+/// Replayed frames: lengths and data, back to back
+static unsigned char *frames;
+static unsigned int framesSize;
+static unsigned int framePos;
+static unsigned int loop;
+
+/// Capture of the frames sent
+static FILE *pcapOut;
+
+/// Number of frames sent
+static unsigned int sentCount;
+
+//-----------------------------------------------------------------------------
+//         Local functions
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/// Swap the bytes of a 32-bit pcap field if the file needs it.
+//-----------------------------------------------------------------------------
+static unsigned int Swap32(unsigned int v, int swap)
+{
+    if (!swap) {
+
+        return v;
+    }
+    return (v >> 24) | ((v >> 8) & 0xff00) | ((v << 8) & 0xff0000) | (v << 24);
+}
+
+//-----------------------------------------------------------------------------
+/// Load all the Ethernet frames of a pcap file, so that reading them
+/// during the replay costs no I/O.
+//-----------------------------------------------------------------------------
+static void LoadPcap(const char *name)
+{
+    FILE *f;
+    PcapHeader hdr;
+    PcapRecord rec;
+    unsigned int len, size = 0;
+    int swap;
+
+    f = fopen(name, "rb");
+    if (f == NULL || fread(&hdr, sizeof(hdr), 1, f) != 1) {
+
+        perror(name);
+        exit(1);
+    }
+    if (hdr.magic != PCAP_MAGIC && hdr.magic != PCAP_MAGIC_SWAPPED) {
+
+        fprintf(stderr, "%s: not a pcap file\n", name);
+        exit(1);
+    }
+    swap = (hdr.magic == PCAP_MAGIC_SWAPPED);
+    if (Swap32(hdr.network, swap) != PCAP_LINKTYPE_ETHERNET) {
+
+        fprintf(stderr, "%s: not an Ethernet capture\n", name);
+        exit(1);
+    }
+
+    while (fread(&rec, sizeof(rec), 1, f) == 1) {
+
+        len = Swap32(rec.caplen, swap);
+        if (framesSize + sizeof(len) + len > size) {
+
+            size = (size + sizeof(len) + len) * 2;
+            frames = realloc(frames, size);
+            if (frames == NULL) {
+
+                perror("realloc");
+                exit(1);
+            }
+        }
+        if (fread(frames + framesSize + sizeof(len), 1, len, f) != len) {
+
+            break;
+        }
+        if (len > UIP_BUFSIZE) {
+
+            // Frames uIP cannot hold are dropped as the EMAC would
+            continue;
+        }
+        memcpy(frames + framesSize, &len, sizeof(len));
+        framesSize += sizeof(len) + len;
+    }
+    fclose(f);
+}
+
+//-----------------------------------------------------------------------------
+/// Open a TAP interface.
+//-----------------------------------------------------------------------------
+static void OpenTap(const char *name)
+{
+    struct ifreq ifr;
+
+    tapFd = open("/dev/net/tun", O_RDWR);
+    if (tapFd < 0) {
+
+        perror("/dev/net/tun");
+        exit(1);
+    }
+    memset(&ifr, 0, sizeof(ifr));
+    ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+    strncpy(ifr.ifr_name, name, IFNAMSIZ - 1);
+    if (ioctl(tapFd, TUNSETIFF, (void *)&ifr) < 0) {
+
+        perror(name);
+        exit(1);
+    }
+}
+
+//-----------------------------------------------------------------------------
+//         Global functions
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/// Select the device before tapdev_init().
+//-----------------------------------------------------------------------------
+void tapdev_config(const char *ifName, const char *pcapIn,
+                   unsigned int loops, const char *pcapFile)
+{
+    if (ifName != NULL) {
+
+        tapName = ifName;
+    }
+    inName = pcapIn;
+    replayLoops = loops;
+    outName = pcapFile;
+}
+
+/*---------------------------------------------------------------------------*/
+void
+tapdev_init(void)
+{
+    PcapHeader hdr;
+
+    printf("-- Host uIP Project --\n");
+    printf(" - MAC %x:%x:%x:%x:%x:%x\n",
+           MacAddress.addr[0], MacAddress.addr[1], MacAddress.addr[2],
+           MacAddress.addr[3], MacAddress.addr[4], MacAddress.addr[5]);
+
+    if (inName != NULL) {
+
+        LoadPcap(inName);
+        printf(" - Replay %s, %u times\n", inName, replayLoops);
+    }
+    else {
+
+        OpenTap(tapName);
+        printf(" - TAP %s\n", tapName);
+    }
+
+    if (outName != NULL) {
+
+        pcapOut = fopen(outName, "wb");
+        if (pcapOut == NULL) {
+
+            perror(outName);
+            exit(1);
+        }
+        memset(&hdr, 0, sizeof(hdr));
+        hdr.magic = PCAP_MAGIC;
+        hdr.major = 2;
+        hdr.minor = 4;
+        hdr.snaplen = UIP_BUFSIZE;
+        hdr.network = PCAP_LINKTYPE_ETHERNET;
+        fwrite(&hdr, sizeof(hdr), 1, pcapOut);
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Read a frame into uip_buf, 0 if there is none.
+//-----------------------------------------------------------------------------
+unsigned int
+tapdev_read(void)
+{
+    fd_set fdset;
+    struct timeval tv;
+    unsigned int len;
+    int ret;
+
+    if (inName != NULL) {
+
+        if (framePos >= framesSize) {
+
+            if (loop + 1 >= replayLoops) {
+
+                loop = replayLoops;
+                return 0;
+            }
+            loop++;
+            framePos = 0;
+        }
+        memcpy(&len, frames + framePos, sizeof(len));
+        memcpy(uip_buf, frames + framePos + sizeof(len), len);
+        framePos += sizeof(len) + len;
+        return len;
+    }
+
+    tv.tv_sec = 0;
+    tv.tv_usec = TAP_WAIT_US;
+    FD_ZERO(&fdset);
+    FD_SET(tapFd, &fdset);
+    ret = select(tapFd + 1, &fdset, NULL, NULL, &tv);
+    if (ret <= 0) {
+
+        return 0;
+    }
+    ret = read(tapFd, uip_buf, UIP_BUFSIZE);
+    if (ret < 0) {
+
+        perror("tapdev_read");
+        return 0;
+    }
+    return ret;
+}
+
+//-----------------------------------------------------------------------------
+/// Send the frame in uip_buf.
+//-----------------------------------------------------------------------------
+void tapdev_send(void)
+{
+    PcapRecord rec;
+    struct timeval tv;
+
+    sentCount++;
+    if (pcapOut != NULL) {
+
+        gettimeofday(&tv, NULL);
+        rec.sec = tv.tv_sec;
+        rec.usec = tv.tv_usec;
+        rec.caplen = uip_len;
+        rec.len = uip_len;
+        fwrite(&rec, sizeof(rec), 1, pcapOut);
+        fwrite(uip_buf, 1, uip_len, pcapOut);
+    }
+    if (tapFd >= 0 && write(tapFd, uip_buf, uip_len) < 0) {
+
+        perror("tapdev_send");
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Return 1 once a replay has delivered all its frames.
+//-----------------------------------------------------------------------------
+int tapdev_done(void)
+{
+    return inName != NULL && loop >= replayLoops;
+}
+
+//-----------------------------------------------------------------------------
+/// Number of frames sent.
+//-----------------------------------------------------------------------------
+unsigned int tapdev_sent(void)
+{
+    return sentCount;
+}
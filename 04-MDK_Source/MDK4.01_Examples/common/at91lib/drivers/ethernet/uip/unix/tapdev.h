@@ -0,0 +1,43 @@
+/**************************************************************************************
+* File Name          : tapdev.h
+* Description        : Network device of the host build: a Linux TAP interface,
+*                      or a pcap file replayed from memory
+**************************************************************************************/
+
+#ifndef __TAPDEV_H__
+#define __TAPDEV_H__
+
+#include "uip.h"
+#include "uip_arp.h"
+
+/// The MAC address used for demo
+static const struct uip_eth_addr MacAddress = {{0x00, 0x45, 0x56, 0x78, 0x9a, 0xac}};
+
+/// The IP address used for demo (ping ...)
+static const unsigned char HostIpAddress[4] = {192, 168, 2, 19};
+
+/// Set the default router's IP address.
+static const unsigned char RoutIpAddress[4] = {192, 168, 2, 1};
+
+// The NetMask address
+static const unsigned char NetMask[4] = {255, 255, 255, 0};
+
+//-----------------------------------------------------------------------------
+/// Select the device before tapdev_init(): the TAP interface ifName, or
+/// with pcapIn set, the frames of that file replayed 'loops' times.
+/// Frames sent are also written to pcapOut when it is set.
+//-----------------------------------------------------------------------------
+void tapdev_config(const char *ifName, const char *pcapIn,
+                   unsigned int loops, const char *pcapOut);
+
+void tapdev_init(void);
+unsigned int tapdev_read(void);
+void tapdev_send(void);
+
+/// Return 1 once a replay has delivered all its frames.
+int tapdev_done(void);
+
+/// Number of frames sent.
+unsigned int tapdev_sent(void);
+
+#endif /* __TAPDEV_H__ */
@@ -0,0 +1,241 @@
+/**
+ * \addtogroup uipopt
+ * @{
+ */
+
+/**
+ * \name Project-specific configuration options
+ * @{
+ *
+ * uIP has a number of configuration options that can be overridden
+ * for each project. These are kept in a project-specific uip-conf.h
+ * file and all configuration names have the prefix UIP_CONF.
+ */
+
+/*
+ * Copyright (c) 2006, Swedish Institute of Computer Science.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the uIP TCP/IP stack
+ *
+ * $Id: uip-conf.h,v 1.6 2006/06/12 08:00:31 adam Exp $
+ */
+
+/**
+ * \file
+ *         uIP configuration of the host build, the same as the
+ *         EMAC examples' apart from the CPU byte order
+ */
+
+#ifndef __UIP_CONF_H__
+#define __UIP_CONF_H__
+
+
+/**
+ * 8 bit datatype
+ *
+ * This typedef defines the 8-bit type used throughout uIP.
+ *
+ * \hideinitializer
+ */
+typedef unsigned char u8_t;
+
+/**
+ * 16 bit datatype
+ *
+ * This typedef defines the 16-bit type used throughout uIP.
+ *
+ * \hideinitializer
+ */
+typedef unsigned short u16_t;
+
+/**
+ * Statistics datatype
+ *
+ * This typedef defines the dataype used for keeping statistics in
+ * uIP.
+ *
+ * \hideinitializer
+ */
+typedef unsigned short uip_stats_t;
+
+/**
+ * Maximum number of TCP connections.
+ *
+ * \hideinitializer
+ */
+#define UIP_CONF_MAX_CONNECTIONS 40
+
+/**
+ * Maximum number of listening TCP ports.
+ *
+ * \hideinitializer
+ */
+#define UIP_CONF_MAX_LISTENPORTS 40
+
+/**
+ * uIP buffer size.
+ *
+ * \hideinitializer
+ */
+#define UIP_CONF_BUFFER_SIZE     1066
+/**
+ * CPU byte order.
+ *
+ * \hideinitializer
+ */
+#define UIP_CONF_BYTE_ORDER      UIP_LITTLE_ENDIAN
+
+/**
+ * Logging on or off
+ *
+ * \hideinitializer
+ */
+#define UIP_CONF_LOGGING         1
+
+/**
+ * UDP support on or off
+ *
+ * \hideinitializer
+ */
+#define UIP_CONF_UDP             0
+
+/**
+ * UDP checksums on or off
+ *
+ * \hideinitializer
+ */
+#define UIP_CONF_UDP_CHECKSUMS   0
+
+/**
+ * uIP statistics on or off
+ *
+ * \hideinitializer
+ */
+#define UIP_CONF_STATISTICS      1
+
+/**
+ * The link level header length.
+ *
+ * \hideinitializer
+ */
+#define UIP_CONF_LLH_LEN         14
+
+/**
+ * Use the checksum functions of uip_arch.c, optimised for 32-bit CPUs.
+ *
+ * \hideinitializer
+ */
+#define UIP_ARCH_CHKSUM          1
+
+/**
+ * Send buffers on or off, letting connections that attach one keep
+ * several segments in flight.
+ *
+ * \hideinitializer
+ */
+#define UIP_CONF_SENDBUF         1
+
+/**
+ * Size of the send window of a buffered connection, in segments.
+ *
+ * \hideinitializer
+ */
+#define UIP_CONF_SENDBUF_SEGMENTS 4
+
+/**
+ * ARP table size, pinning of the default router's entry and queueing
+ * of the packet that triggers an ARP request.
+ *
+ * \hideinitializer
+ */
+#define UIP_CONF_ARPTAB_SIZE     256
+#define UIP_CONF_ARP_PIN_DRADDR  1
+#define UIP_CONF_ARP_QUEUE       1
+
+/**
+ * Web server: serve files missing from the ROM image from FAT volume
+ * 0, which needs the FatFs sources, a fatfs_config.h and a media
+ * driver in the project.
+ *
+ * \hideinitializer
+ */
+#define HTTPD_CONF_FS_FATFS      0
+
+/**
+ * Web server: size and number of the buffers for pipelined requests.
+ * They are shared by all connections and take 4 * 512 = 2 KB of RAM;
+ * one buffer per connection would take UIP_CONF_MAX_CONNECTIONS times
+ * the size, 20 KB here.
+ *
+ * \hideinitializer
+ */
+#define HTTPD_CONF_PIPELINE_SIZE 512
+#define HTTPD_CONF_PIPELINE_BUFFERS 4
+
+/**
+ * Broadcast support.
+ *
+ * \hideinitializer
+ *
+ */
+#define UIP_CONF_BROADCAST       0
+
+/* Here we include the header file for the application(s) we use in
+   our project. */
+
+/* Build with -DUIP_DHCP_on to run the DHCP client, and with
+   -DUIP_HOST_TELNETD or -DUIP_HOST_HELLO_WORLD to run those
+   applications instead of the web server. */
+
+#ifdef UIP_DHCP_on
+ #if !UIP_CONF_UDP
+  #undef UIP_CONF_UDP
+  #define UIP_CONF_UDP 1
+ #endif
+ #if !UIP_CONF_BROADCAST
+  #undef UIP_CONF_BROADCAST
+  #define UIP_CONF_BROADCAST 1
+ #endif
+/* Keep the lease in the file dhcpc.lease across runs */
+#define DHCPC_CONF_LEASE_STORE 1
+#include "dhcpc.h"
+#endif
+
+#if defined(UIP_HOST_TELNETD)
+#include "telnetd.h"
+#elif defined(UIP_HOST_HELLO_WORLD)
+#include "hello-world.h"
+#else
+#include "webserver.h"
+#endif
+
+#endif /* __UIP_CONF_H__ */
+
+/** @} */
+/** @} */
+
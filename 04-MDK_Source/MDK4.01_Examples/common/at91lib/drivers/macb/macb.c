@@ -47,6 +47,10 @@
 /// Default max retry count
 #define MACB_RETRY_MAX            1000000
 
+/// Abilities advertised: 100BaseTxFD and HD, 10BaseTFD and HD, IEEE 802.3
+#define MACB_ADVERTISE            (MII_TX_FDX | MII_TX_HDX | \
+                                   MII_10_FDX | MII_10_HDX | MII_AN_IEEE_802_3)
+
 //-----------------------------------------------------------------------------
 /// Dump all the useful registers
 /// \param pMacb          Pointer to the MACB instance
@@ -188,6 +192,11 @@ void MACB_Init(Macb *pMacb, unsigned char phyAddress)
 
     // Initialize timeout by default
     pMacb->retryMax = MACB_RETRY_MAX;
+
+    pMacb->state = MACB_STATE_IDLE;
+    pMacb->speed = 0;
+    pMacb->fullDuplex = 0;
+    pMacb->linkCallback = 0;
 }
 
 
@@ -320,21 +329,18 @@ unsigned char MACB_InitPhy(Macb         *pMacb,
 }
 
 //-----------------------------------------------------------------------------
-/// Issue a Auto Negotiation of the PHY
-/// Return 1 if successfully, 0 if timeout.
+/// Program the PHY advertisement and restart its auto negotiation.
+/// Return 1 if successfully, 0 if MDIO access failed.
 /// \param pMacb   Pointer to the MACB instance
 //-----------------------------------------------------------------------------
-unsigned char MACB_AutoNegotiate(Macb *pMacb)
+static unsigned char MACB_RestartAutoNegotiate(Macb *pMacb)
 {
     unsigned int retryMax;
     unsigned int value;
-    unsigned int phyAnar;
-    unsigned int phyAnalpar;
-    unsigned int retryCount= 0;
+    unsigned int phyId2;
     unsigned char phyAddress;
     unsigned char rc = 1;
 
-    ASSERT(pMacb, "-F- MACB_AutoNegotiate\n\r");
     phyAddress = pMacb->phyAddress;
     retryMax = pMacb->retryMax;
 
@@ -343,21 +349,21 @@ unsigned char MACB_AutoNegotiate(Macb *pMacb)
     if (!EMAC_ReadPhy(phyAddress, MII_PHYID1, &value, retryMax)) {
         TRACE_ERROR("Pb EMAC_ReadPhy Id1\n\r");
         rc = 0;
-        goto AutoNegotiateExit;
+        goto RestartAutoNegotiateExit;
     }
     TRACE_DEBUG("ReadPhy Id1 0x%X, addresse: %d\n\r", value, phyAddress);
-    if (!EMAC_ReadPhy(phyAddress, MII_PHYID2, &phyAnar, retryMax)) {
+    if (!EMAC_ReadPhy(phyAddress, MII_PHYID2, &phyId2, retryMax)) {
         TRACE_ERROR("Pb EMAC_ReadPhy Id2\n\r");
         rc = 0;
-        goto AutoNegotiateExit;
+        goto RestartAutoNegotiateExit;
     }
-    TRACE_DEBUG("ReadPhy Id2 0x%X\n\r", phyAnar);
+    TRACE_DEBUG("ReadPhy Id2 0x%X\n\r", phyId2);
 
     if( ( value == MII_OUI_MSB )
-     && ( ((phyAnar>>10)&MII_LSB_MASK) == MII_OUI_LSB ) ) {
+     && ( ((phyId2>>10)&MII_LSB_MASK) == MII_OUI_LSB ) ) {
 
-        TRACE_DEBUG("Vendor Number Model = 0x%X\n\r", ((phyAnar>>4)&0x3F));
-        TRACE_DEBUG("Model Revision Number = 0x%X\n\r", (phyAnar&0x7));
+        TRACE_DEBUG("Vendor Number Model = 0x%X\n\r", ((phyId2>>4)&0x3F));
+        TRACE_DEBUG("Model Revision Number = 0x%X\n\r", (phyId2&0x7));
     }
     else {
         TRACE_ERROR("Problem OUI value\n\r");
@@ -367,7 +373,7 @@ unsigned char MACB_AutoNegotiate(Macb *pMacb)
     rc  = EMAC_ReadPhy(phyAddress, MII_BMCR, &value, retryMax);
     if (rc == 0) {
 
-        goto AutoNegotiateExit;
+        goto RestartAutoNegotiateExit;
     }
 
     value &= ~MII_AUTONEG;   // Remove autonegotiation enable
@@ -376,32 +382,28 @@ unsigned char MACB_AutoNegotiate(Macb *pMacb)
     rc = EMAC_WritePhy(phyAddress, MII_BMCR, value, retryMax);
     if (rc == 0) {
 
-        goto AutoNegotiateExit;
+        goto RestartAutoNegotiateExit;
     }
 
     // Set the Auto_negotiation Advertisement Register
-    // MII advertising for Next page
-    // 100BaseTxFD and HD, 10BaseTFD and HD, IEEE 802.3
-    phyAnar = MII_TX_FDX | MII_TX_HDX |
-              MII_10_FDX | MII_10_HDX | MII_AN_IEEE_802_3;
-    rc = EMAC_WritePhy(phyAddress, MII_ANAR, phyAnar, retryMax);
+    rc = EMAC_WritePhy(phyAddress, MII_ANAR, MACB_ADVERTISE, retryMax);
     if (rc == 0) {
 
-        goto AutoNegotiateExit;
+        goto RestartAutoNegotiateExit;
     }
 
     // Read & modify control register
     rc  = EMAC_ReadPhy(phyAddress, MII_BMCR, &value, retryMax);
     if (rc == 0) {
 
-        goto AutoNegotiateExit;
+        goto RestartAutoNegotiateExit;
     }
 
     value |= MII_SPEED_SELECT | MII_AUTONEG | MII_DUPLEX_MODE;
     rc = EMAC_WritePhy(phyAddress, MII_BMCR, value, retryMax);
     if (rc == 0) {
 
-        goto AutoNegotiateExit;
+        goto RestartAutoNegotiateExit;
     }
 
     // Restart Auto_negotiation
@@ -410,10 +412,82 @@ unsigned char MACB_AutoNegotiate(Macb *pMacb)
     rc = EMAC_WritePhy(phyAddress, MII_BMCR, value, retryMax);
     if (rc == 0) {
 
-        goto AutoNegotiateExit;
+        goto RestartAutoNegotiateExit;
     }
     TRACE_DEBUG(" _BMCR: 0x%X\n\r", value);
 
+RestartAutoNegotiateExit:
+    EMAC_DisableMdio();
+    return rc;
+}
+
+//-----------------------------------------------------------------------------
+/// Setup the EMAC link speed from the abilities of the link partner, the
+/// best one both sides advertise.
+/// \param pMacb       Pointer to the MACB instance
+/// \param phyAnalpar  Content of the PHY ANLPAR register
+//-----------------------------------------------------------------------------
+static void MACB_ApplyLinkPartner(Macb *pMacb, unsigned int phyAnalpar)
+{
+    unsigned int common = MACB_ADVERTISE & phyAnalpar;
+
+    if (common & MII_TX_FDX) {
+
+        // set MII for 100BaseTX and Full Duplex
+        pMacb->speed = 1;
+        pMacb->fullDuplex = 1;
+    }
+    else if (common & MII_10_FDX) {
+
+        // set MII for 10BaseT and Full Duplex
+        pMacb->speed = 0;
+        pMacb->fullDuplex = 1;
+    }
+    else if (common & MII_TX_HDX) {
+
+        // set MII for 100BaseTX and half Duplex
+        pMacb->speed = 1;
+        pMacb->fullDuplex = 0;
+    }
+    else if (common & MII_10_HDX) {
+
+        // set MII for 10BaseT and half Duplex
+        pMacb->speed = 0;
+        pMacb->fullDuplex = 0;
+    }
+    else {
+
+        return;
+    }
+    EMAC_SetLinkSpeed(pMacb->speed, pMacb->fullDuplex);
+}
+
+//-----------------------------------------------------------------------------
+/// Issue a Auto Negotiation of the PHY and wait for it to complete
+/// Return 1 if successfully, 0 if timeout.
+/// \param pMacb   Pointer to the MACB instance
+//-----------------------------------------------------------------------------
+unsigned char MACB_AutoNegotiate(Macb *pMacb)
+{
+    unsigned int retryMax;
+    unsigned int value;
+    unsigned int phyAnalpar;
+    unsigned int retryCount= 0;
+    unsigned char phyAddress;
+    unsigned char rc = 1;
+
+    ASSERT(pMacb, "-F- MACB_AutoNegotiate\n\r");
+    phyAddress = pMacb->phyAddress;
+    retryMax = pMacb->retryMax;
+
+    rc = MACB_RestartAutoNegotiate(pMacb);
+    if (rc == 0) {
+
+        return 0;
+    }
+
+    EMAC_EnableMdio();
+
     // Check AutoNegotiate complete
     while (1) {
 
@@ -449,37 +523,111 @@ unsigned char MACB_AutoNegotiate(Macb *pMacb)
     }
 
     // Setup the EMAC link speed
-    if ((phyAnar & phyAnalpar) & MII_TX_FDX) {
+    MACB_ApplyLinkPartner(pMacb, phyAnalpar);
 
-        // set MII for 100BaseTX and Full Duplex
-        EMAC_SetLinkSpeed(1, 1);
-    }
-    else if ((phyAnar & phyAnalpar) & MII_10_FDX) {
+    // Setup EMAC mode
+#if (BOARD_EMAC_MODE_RMII != 1)
+    EMAC_EnableMII();
+#else
+    EMAC_EnableRMII();
+#endif
 
-        // set MII for 10BaseT and Full Duplex
-        EMAC_SetLinkSpeed(0, 1);
-    }
-    else if ((phyAnar & phyAnalpar) & MII_TX_HDX) {
+AutoNegotiateExit:
+    EMAC_DisableMdio();
+    return rc;
+}
 
-        // set MII for 100BaseTX and half Duplex
-        EMAC_SetLinkSpeed(1, 0);
-    }
-    else if ((phyAnar & phyAnalpar) & MII_10_HDX) {
+//-----------------------------------------------------------------------------
+/// Start an Auto Negotiation of the PHY and return without waiting for it.
+/// MACB_PollLink() then has to be called periodically (every 100 ms or so):
+/// it programs the EMAC once the negotiation completes and follows the link
+/// afterwards, invoking the callback each time it comes up or goes down.
+/// Return 1 if successfully, 0 if MDIO access failed.
+/// \param pMacb     Pointer to the MACB instance
+/// \param callback  Link change callback, may be 0
+//-----------------------------------------------------------------------------
+unsigned char MACB_StartAutoNegotiate(Macb *pMacb, MACB_LinkCallback callback)
+{
+    ASSERT(pMacb, "-F- MACB_StartAutoNegotiate\n\r");
 
-        // set MII for 10BaseT and half Duplex
-        EMAC_SetLinkSpeed(0, 0);
+    pMacb->state = MACB_STATE_IDLE;
+    if (!MACB_RestartAutoNegotiate(pMacb)) {
+
+        return 0;
     }
 
-    // Setup EMAC mode
+    // Setup EMAC mode, the link speed follows once negotiated
 #if (BOARD_EMAC_MODE_RMII != 1)
     EMAC_EnableMII();
 #else
     EMAC_EnableRMII();
 #endif
 
-AutoNegotiateExit:
+    pMacb->linkCallback = callback;
+    pMacb->state = MACB_STATE_AUTONEG;
+    return 1;
+}
+
+//-----------------------------------------------------------------------------
+/// Check the PHY status once, following the link started by
+/// MACB_StartAutoNegotiate(). Costs one or two MDIO reads.
+/// \param pMacb   Pointer to the MACB instance
+//-----------------------------------------------------------------------------
+void MACB_PollLink(Macb *pMacb)
+{
+    unsigned int retryMax;
+    unsigned int bmsr;
+    unsigned int phyAnalpar;
+    unsigned char phyAddress;
+    unsigned char changed = 0;
+
+    ASSERT(pMacb, "-F- MACB_PollLink\n\r");
+
+    if (pMacb->state == MACB_STATE_IDLE) {
+
+        return;
+    }
+    phyAddress = pMacb->phyAddress;
+    retryMax = pMacb->retryMax;
+
+    EMAC_EnableMdio();
+
+    // The link status bit latches low: a drop since the last poll is seen
+    if (!EMAC_ReadPhy(phyAddress, MII_BMSR, &bmsr, retryMax)) {
+
+        goto PollLinkExit;
+    }
+
+    if (pMacb->state == MACB_STATE_AUTONEG) {
+
+        if ((bmsr & (MII_AUTONEG_COMP | MII_LINK_STATUS))
+            == (MII_AUTONEG_COMP | MII_LINK_STATUS)
+            && EMAC_ReadPhy(phyAddress, MII_ANLPAR, &phyAnalpar, retryMax)) {
+
+            MACB_ApplyLinkPartner(pMacb, phyAnalpar);
+            pMacb->state = MACB_STATE_LINKUP;
+            changed = 1;
+            TRACE_INFO("Link up, %s Mbps %s duplex\n\r",
+                       pMacb->speed ? "100" : "10",
+                       pMacb->fullDuplex ? "full" : "half");
+        }
+    }
+    else if ((bmsr & MII_LINK_STATUS) == 0) {
+
+        // The PHY negotiates again by itself when the link comes back
+        pMacb->state = MACB_STATE_AUTONEG;
+        changed = 1;
+        TRACE_INFO("Link down\n\r");
+    }
+
+PollLinkExit:
     EMAC_DisableMdio();
-    return rc;
+
+    if (changed && pMacb->linkCallback) {
+
+        pMacb->linkCallback(pMacb->state == MACB_STATE_LINKUP,
+                            pMacb->speed, pMacb->fullDuplex);
+    }
 }
 
 //-----------------------------------------------------------------------------
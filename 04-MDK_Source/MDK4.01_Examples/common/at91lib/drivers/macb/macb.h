@@ -58,10 +58,25 @@
 /// The reset length setting for external reset configuration
 #define MACB_RESET_LENGTH         0xD
 
+/// Link monitoring stopped, see MACB_StartAutoNegotiate()
+#define MACB_STATE_IDLE           0
+/// Auto negotiation running, or waiting for a link
+#define MACB_STATE_AUTONEG        1
+/// Link up, EMAC programmed for its speed and duplex
+#define MACB_STATE_LINKUP         2
+
 //-----------------------------------------------------------------------------
 //         Types
 //-----------------------------------------------------------------------------
 
+/// Link change callback
+/// \param link       1 when the link came up, 0 when it went down
+/// \param speed      1 for 100 Mbps, 0 for 10 Mbps
+/// \param fullDuplex 1 for full duplex, 0 for half duplex
+typedef void (*MACB_LinkCallback)(unsigned char link,
+                                  unsigned char speed,
+                                  unsigned char fullDuplex);
+
 /// The DM9161 instance
 typedef struct _Macb {
 
@@ -71,6 +86,18 @@ typedef struct _Macb {
     /// PHY address ( pre-defined by pins on reset )
     unsigned char phyAddress;
 
+    /// Link state, MACB_STATE_xxx
+    unsigned char state;
+
+    /// Negotiated speed, 1 for 100 Mbps
+    unsigned char speed;
+
+    /// Negotiated duplex, 1 for full duplex
+    unsigned char fullDuplex;
+
+    /// Invoked by MACB_PollLink() on link changes
+    MACB_LinkCallback linkCallback;
+
 } Macb, *pMacb;
 
 //------------------------------------------------------------------------------
@@ -90,6 +117,11 @@ extern unsigned char MACB_InitPhy(Macb *pMacb,
 
 extern unsigned char MACB_AutoNegotiate(Macb *pMacb);
 
+extern unsigned char MACB_StartAutoNegotiate(Macb *pMacb,
+                                             MACB_LinkCallback callback);
+
+extern void MACB_PollLink(Macb *pMacb);
+
 extern unsigned char MACB_GetLinkSpeed(Macb *pMacb,
                                          unsigned char applySettings);
 
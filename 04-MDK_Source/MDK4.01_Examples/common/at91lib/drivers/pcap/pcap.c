@@ -0,0 +1,428 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support 
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2008, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * ----------------------------------------------------------------------------
+ */
+
+//-----------------------------------------------------------------------------
+//         Headers
+//-----------------------------------------------------------------------------
+#include "pcap.h"
+#include <utility/assert.h>
+#include <string.h>
+
+//-----------------------------------------------------------------------------
+//         Definitions
+//-----------------------------------------------------------------------------
+
+/// pcap file magic number, in the byte order of the writer
+#define PCAP_MAGIC                0xA1B2C3D4
+/// pcap file format version
+#define PCAP_VERSION_MAJOR        2
+#define PCAP_VERSION_MINOR        4
+/// Link type of the frames: Ethernet
+#define PCAP_LINKTYPE_ETHERNET    1
+
+/// Frame headers looked at by the filter: Ethernet, IPv4 with options, ports
+#define PCAP_FILTER_HEADER_SIZE   (14 + 60 + 4)
+
+#define ETH_TYPE_IP               0x0800
+#define IP_PROTO_TCP              6
+#define IP_PROTO_UDP              17
+
+//-----------------------------------------------------------------------------
+//         Internal variables
+//-----------------------------------------------------------------------------
+
+/// Capture ring. The frames are kept as the records of a pcap file: header
+/// then captured bytes, from tail up to head (excluded).
+static struct {
+
+    unsigned char *pBuffer;         /// Ring buffer
+    unsigned int size;              /// Size of the ring buffer
+    volatile unsigned int head;     /// Next byte written, by PCAP_Capture()
+    volatile unsigned int tail;     /// First byte not read, by PCAP_Close()
+    unsigned short snapLength;      /// Bytes kept of each frame
+    PCAP_ClockCallback fClock;      /// Microsecond clock
+    unsigned int lastClock;         /// Clock at the previous frame
+    unsigned int seconds;           /// Time of the previous frame
+    unsigned int microseconds;
+    PcapFilter filter;              /// Frames captured
+    PcapStats stats;                /// Statistics
+
+} pcap;
+
+//-----------------------------------------------------------------------------
+//         Internal functions
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/// Copies data into the ring, wrapping at its end.
+/// \param offset   Ring offset to write at
+/// \param pData    Data to copy
+/// \param length   Number of bytes, less than the ring size
+/// \return         Ring offset following the data
+//-----------------------------------------------------------------------------
+static unsigned int PCAP_RingWrite(unsigned int offset,
+                                   const void *pData,
+                                   unsigned int length)
+{
+    unsigned int first = pcap.size - offset;
+
+    if (length < first) {
+
+        memcpy(pcap.pBuffer + offset, pData, length);
+        return offset + length;
+    }
+    memcpy(pcap.pBuffer + offset, pData, first);
+    memcpy(pcap.pBuffer, (const unsigned char *) pData + first, length - first);
+    return length - first;
+}
+
+//-----------------------------------------------------------------------------
+/// Copies data out of the ring, wrapping at its end.
+/// \param offset   Ring offset to read at
+/// \param pData    Buffer to copy to
+/// \param length   Number of bytes, less than the ring size
+//-----------------------------------------------------------------------------
+static void PCAP_RingRead(unsigned int offset, void *pData, unsigned int length)
+{
+    unsigned int first = pcap.size - offset;
+
+    if (length <= first) {
+
+        memcpy(pData, pcap.pBuffer + offset, length);
+        return;
+    }
+    memcpy(pData, pcap.pBuffer + offset, first);
+    memcpy((unsigned char *) pData + first, pcap.pBuffer, length - first);
+}
+
+//-----------------------------------------------------------------------------
+/// Copies the first bytes of a frame made of several buffers.
+/// \return  Number of bytes copied
+//-----------------------------------------------------------------------------
+static unsigned int PCAP_Gather(const EmacIoVec *pIov,
+                                unsigned int count,
+                                unsigned char *pData,
+                                unsigned int length)
+{
+    unsigned int done = 0;
+    unsigned int n;
+
+    while (count-- && done < length) {
+
+        n = length - done;
+        if (n > pIov->size) {
+            n = pIov->size;
+        }
+        memcpy(pData + done, pIov->pBuffer, n);
+        done += n;
+        pIov++;
+    }
+    return done;
+}
+
+//-----------------------------------------------------------------------------
+/// Returns 1 if a frame matches every field set in the filter.
+//-----------------------------------------------------------------------------
+static unsigned char PCAP_Match(const EmacIoVec *pIov,
+                                unsigned int count,
+                                unsigned char direction)
+{
+    const PcapFilter *pFilter = &pcap.filter;
+    unsigned char header[PCAP_FILTER_HEADER_SIZE];
+    unsigned int length;
+    unsigned int ipLength;
+    unsigned short etherType;
+    unsigned char *pPorts;
+
+    if (pFilter->directions && !(pFilter->directions & (1 << direction))) {
+
+        return 0;
+    }
+    if (!pFilter->etherType && !pFilter->ipProtocol && !pFilter->port) {
+
+        return 1;
+    }
+
+    length = PCAP_Gather(pIov, count, header, sizeof(header));
+    if (length < 14) {
+
+        return 0;
+    }
+    etherType = (header[12] << 8) | header[13];
+    if (pFilter->etherType && etherType != pFilter->etherType) {
+
+        return 0;
+    }
+    if (!pFilter->ipProtocol && !pFilter->port) {
+
+        return 1;
+    }
+
+    // IPv4 header
+    if (etherType != ETH_TYPE_IP || length < 14 + 20) {
+
+        return 0;
+    }
+    if (pFilter->ipProtocol && header[23] != pFilter->ipProtocol) {
+
+        return 0;
+    }
+    if (!pFilter->port) {
+
+        return 1;
+    }
+
+    // Ports of the first fragment of a TCP or UDP datagram
+    ipLength = (header[14] & 0x0F) * 4;
+    if ((header[23] != IP_PROTO_TCP && header[23] != IP_PROTO_UDP)
+        || ((header[20] & 0x1F) | header[21])
+        || length < 14 + ipLength + 4) {
+
+        return 0;
+    }
+    pPorts = header + 14 + ipLength;
+    return ((((pPorts[0] << 8) | pPorts[1]) == pFilter->port)
+            || (((pPorts[2] << 8) | pPorts[3]) == pFilter->port));
+}
+
+//-----------------------------------------------------------------------------
+//         Exported functions
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+/// Initializes the capture ring, which is then empty, and clears the filter
+/// and statistics. The capture shall be stopped.
+/// \param pBuffer      Ring buffer
+/// \param size         Size of the ring buffer
+/// \param snapLength   Number of bytes kept of each frame
+/// \param fClock       Microsecond clock timestamping the frames
+//-----------------------------------------------------------------------------
+void PCAP_Init(unsigned char *pBuffer,
+               unsigned int size,
+               unsigned short snapLength,
+               PCAP_ClockCallback fClock)
+{
+    ASSERT(pBuffer && fClock, "F: PCAP_Init\n\r");
+    ASSERT(size > (unsigned int) PCAP_RECORD_HEADER_SIZE + snapLength,
+           "F: PCAP_Init: ring of %u bytes too small\n\r", size);
+
+    memset(&pcap, 0, sizeof(pcap));
+    pcap.pBuffer = pBuffer;
+    pcap.size = size;
+    pcap.snapLength = snapLength;
+    pcap.fClock = fClock;
+    pcap.lastClock = fClock();
+}
+
+//-----------------------------------------------------------------------------
+/// Selects the frames captured.
+/// \param pFilter  Filter to copy, 0 to capture every frame
+//-----------------------------------------------------------------------------
+void PCAP_SetFilter(const PcapFilter *pFilter)
+{
+    if (pFilter) {
+
+        pcap.filter = *pFilter;
+    }
+    else {
+
+        memset(&pcap.filter, 0, sizeof(pcap.filter));
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Captures a frame into the ring. This is the EMAC_CaptureCallback to give
+/// to EMAC_Set_CaptureCb(). The frame is dropped when the ring is full.
+/// \param pIov         Buffers making up the frame
+/// \param count        Number of buffers
+/// \param frameLength  Length of the frame on the wire
+/// \param direction    EMAC_CAPTURE_RX or EMAC_CAPTURE_TX
+//-----------------------------------------------------------------------------
+void PCAP_Capture(const EmacIoVec *pIov,
+                  unsigned int count,
+                  unsigned int frameLength,
+                  unsigned char direction)
+{
+    unsigned int record[PCAP_RECORD_HEADER_SIZE / 4];
+    unsigned int size = 0;
+    unsigned int length;
+    unsigned int head;
+    unsigned int clock;
+    unsigned int i;
+
+    // Keep the time even for the frames not captured, so that the clock
+    // wraps are seen. A clock read just before its tick interrupt may
+    // go back a little: keep the previous time then.
+    clock = pcap.fClock();
+    if ((int) (clock - pcap.lastClock) > 0) {
+
+        pcap.microseconds += clock - pcap.lastClock;
+        pcap.lastClock = clock;
+    }
+    if (pcap.microseconds >= 1000000) {
+
+        pcap.seconds += pcap.microseconds / 1000000;
+        pcap.microseconds %= 1000000;
+    }
+
+    if (!PCAP_Match(pIov, count, direction) == !pcap.filter.exclude) {
+
+        pcap.stats.filtered++;
+        return;
+    }
+
+    for (i = 0; i < count; i++) {
+
+        size += pIov[i].size;
+    }
+    length = (size < pcap.snapLength) ? size : pcap.snapLength;
+
+    head = pcap.head;
+    if ((pcap.tail + pcap.size - head - 1) % pcap.size
+        < PCAP_RECORD_HEADER_SIZE + length) {
+
+        pcap.stats.dropped++;
+        return;
+    }
+
+    record[0] = pcap.seconds;
+    record[1] = pcap.microseconds;
+    record[2] = length;
+    record[3] = frameLength;
+    head = PCAP_RingWrite(head, record, sizeof(record));
+    for (i = 0; length; i++) {
+
+        size = (pIov[i].size < length) ? pIov[i].size : length;
+        head = PCAP_RingWrite(head, pIov[i].pBuffer, size);
+        length -= size;
+    }
+
+    // Publish the frame to the reader once written
+    pcap.head = head;
+    pcap.stats.captured++;
+}
+
+//-----------------------------------------------------------------------------
+/// Gets the capture statistics.
+/// \param pStats   Pointer to PcapStats structure to copy the informations
+/// \param reset    Reset the statistics after copy it
+//-----------------------------------------------------------------------------
+void PCAP_GetStatistics(PcapStats *pStats, unsigned char reset)
+{
+    if (pStats) {
+
+        *pStats = pcap.stats;
+    }
+    if (reset) {
+
+        memset(&pcap.stats, 0, sizeof(pcap.stats));
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Takes a snapshot of the frames in the ring, to be read as a pcap file.
+/// The capture goes on meanwhile, into the rest of the ring.
+/// \param pReader  Pointer to the snapshot to fill
+/// \return         Size of the pcap file
+//-----------------------------------------------------------------------------
+unsigned int PCAP_Open(PcapReader *pReader)
+{
+    pReader->start = pcap.tail;
+    pReader->length = 0;
+    if (pcap.size) {
+
+        pReader->length = (pcap.head + pcap.size - pReader->start) % pcap.size;
+    }
+    return PCAP_FILE_HEADER_SIZE + pReader->length;
+}
+
+//-----------------------------------------------------------------------------
+/// Copies a part of the pcap file of a snapshot. The same part may be read
+/// again until PCAP_Close() is called.
+/// \param pReader  Snapshot returned by PCAP_Open()
+/// \param offset   Offset in the pcap file
+/// \param pData    Buffer to copy to
+/// \param length   Number of bytes to copy
+/// \return         Number of bytes copied, less at the end of the file
+//-----------------------------------------------------------------------------
+unsigned int PCAP_Read(const PcapReader *pReader,
+                       unsigned int offset,
+                       void *pData,
+                       unsigned int length)
+{
+    unsigned int header[PCAP_FILE_HEADER_SIZE / 4];
+    unsigned short *pVersion = (unsigned short *) &header[1];
+    unsigned char *pOut = pData;
+    unsigned int n;
+    unsigned int done = 0;
+
+    if (offset < PCAP_FILE_HEADER_SIZE) {
+
+        header[0] = PCAP_MAGIC;
+        pVersion[0] = PCAP_VERSION_MAJOR;
+        pVersion[1] = PCAP_VERSION_MINOR;
+        header[2] = 0;
+        header[3] = 0;
+        header[4] = pcap.snapLength;
+        header[5] = PCAP_LINKTYPE_ETHERNET;
+
+        n = PCAP_FILE_HEADER_SIZE - offset;
+        if (n > length) {
+            n = length;
+        }
+        memcpy(pOut, (unsigned char *) header + offset, n);
+        done = n;
+        offset += n;
+    }
+
+    offset -= PCAP_FILE_HEADER_SIZE;
+    if (done < length && offset < pReader->length) {
+
+        n = length - done;
+        if (n > pReader->length - offset) {
+            n = pReader->length - offset;
+        }
+        PCAP_RingRead((pReader->start + offset) % pcap.size, pOut + done, n);
+        done += n;
+    }
+    return done;
+}
+
+//-----------------------------------------------------------------------------
+/// Frees the frames of a snapshot which has been read, so that they are
+/// not in the next one. Does nothing if they were freed already.
+/// \param pReader  Snapshot returned by PCAP_Open()
+//-----------------------------------------------------------------------------
+void PCAP_Close(const PcapReader *pReader)
+{
+    if (pcap.tail == pReader->start && pcap.size) {
+
+        pcap.tail = (pReader->start + pReader->length) % pcap.size;
+    }
+}
@@ -0,0 +1,152 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support 
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2008, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * ----------------------------------------------------------------------------
+ */
+
+//-----------------------------------------------------------------------------
+/// \unit
+///
+/// !Purpose
+///
+/// Capture of the frames sent and received by the EMAC into a ring, read
+/// back as a pcap file.
+///
+/// !Usage
+///
+/// -# Initialize the ring with PCAP_Init(), giving it a buffer (e.g. in
+///    DDRAM), the number of bytes kept of each frame and a microsecond clock.
+/// -# Optionally select the frames to keep with PCAP_SetFilter().
+/// -# Start the capture with EMAC_Set_CaptureCb(PCAP_Capture), stop it with
+///    EMAC_Set_CaptureCb(0).
+/// -# Read the capture: PCAP_Open() takes a snapshot of the ring and returns
+///    the size of the pcap file, PCAP_Read() copies any part of it, so that a
+///    transport (HTTP, USB CDC...) can send it again after a loss, and
+///    PCAP_Close() frees the frames read.
+///
+/// The ring is written by PCAP_Capture() and read by PCAP_Read() without
+/// lock: there is one writer, the EMAC driver which is not reentrant, and
+/// one reader. Frames which do not fit are dropped and counted; they never
+/// overwrite the frames not read yet.
+///
+/// Please refer to the list of functions in the #Overview# tab of this unit
+/// for more detailed information.
+//-----------------------------------------------------------------------------
+
+// drivers/pcap/pcap.h
+
+#ifndef _PCAP_H
+#define _PCAP_H
+
+//-----------------------------------------------------------------------------
+//         Headers
+//-----------------------------------------------------------------------------
+#include <emac/emac.h>
+
+//-----------------------------------------------------------------------------
+//         Definitions
+//-----------------------------------------------------------------------------
+
+/// Size of the pcap file header
+#define PCAP_FILE_HEADER_SIZE     24
+/// Size of the pcap header of each frame
+#define PCAP_RECORD_HEADER_SIZE   16
+
+/// Frame directions, for PcapFilter
+#define PCAP_DIR_RX               (1 << EMAC_CAPTURE_RX)
+#define PCAP_DIR_TX               (1 << EMAC_CAPTURE_TX)
+
+//-----------------------------------------------------------------------------
+//         Types
+//-----------------------------------------------------------------------------
+
+/// Returns a free running count of microseconds, e.g. built from a PIT or TC.
+/// The timestamps stay right while frames come at least every half of its
+/// wrap period, 35 minutes.
+typedef unsigned int (*PCAP_ClockCallback)(void);
+
+//-----------------------------------------------------------------------------
+/// Selects the frames captured. A field set to 0 matches every frame.
+//-----------------------------------------------------------------------------
+typedef struct _PcapFilter {
+
+    unsigned char directions;   /// PCAP_DIR_RX and/or PCAP_DIR_TX, 0 for both
+    unsigned char ipProtocol;   /// IPv4 protocol, e.g. 6 for TCP
+    unsigned short etherType;   /// EtherType, e.g. 0x0800 for IPv4
+    unsigned short port;        /// TCP or UDP source or destination port
+    unsigned char exclude;      /// 1 to drop the frames matching instead
+
+} PcapFilter;
+
+//-----------------------------------------------------------------------------
+/// Capture statistics.
+//-----------------------------------------------------------------------------
+typedef struct _PcapStats {
+
+    unsigned int captured;      /// Frames written into the ring
+    unsigned int filtered;      /// Frames rejected by the filter
+    unsigned int dropped;       /// Frames lost, the ring was full
+
+} PcapStats;
+
+//-----------------------------------------------------------------------------
+/// Snapshot of the ring taken by PCAP_Open().
+//-----------------------------------------------------------------------------
+typedef struct _PcapReader {
+
+    unsigned int start;         /// Ring offset of the first frame
+    unsigned int length;        /// Bytes of frames in the snapshot
+
+} PcapReader;
+
+//-----------------------------------------------------------------------------
+//         Exported functions
+//-----------------------------------------------------------------------------
+
+extern void PCAP_Init(unsigned char *pBuffer,
+                      unsigned int size,
+                      unsigned short snapLength,
+                      PCAP_ClockCallback fClock);
+
+extern void PCAP_SetFilter(const PcapFilter *pFilter);
+
+extern void PCAP_Capture(const EmacIoVec *pIov,
+                         unsigned int count,
+                         unsigned int frameLength,
+                         unsigned char direction);
+
+extern void PCAP_GetStatistics(PcapStats *pStats, unsigned char reset);
+
+extern unsigned int PCAP_Open(PcapReader *pReader);
+
+extern unsigned int PCAP_Read(const PcapReader *pReader,
+                              unsigned int offset,
+                              void *pData,
+                              unsigned int length);
+
+extern void PCAP_Close(const PcapReader *pReader);
+
+#endif //#ifndef _PCAP_H
@@ -50,6 +50,88 @@
 #define MODEL(ecc)  ((struct NandFlashModel *) ecc)
 #define RAW(ecc)    ((struct RawNandFlash *) ecc)
 
+/// Maximum number of pages handled by one RawNandFlash_ReadPages or
+/// RawNandFlash_WritePages call (bounds the temporary spare buffer).
+#define NUMCACHEPAGES   8
+
+//------------------------------------------------------------------------------
+//         Internal types
+//------------------------------------------------------------------------------
+
+#ifndef HARDWARE_ECC
+//------------------------------------------------------------------------------
+/// Pages transferred by one RawNandFlash_ReadPages or RawNandFlash_WritePages
+/// call, processed page by page by VerifyPage() or ComputePage().
+//------------------------------------------------------------------------------
+struct EccPages {
+
+    /// EccNandFlash instance.
+    const struct EccNandFlash *ecc;
+    /// Data areas of the pages.
+    unsigned char *data;
+    /// Spare areas of the pages.
+    unsigned char *spare;
+    /// Set if a page contains unrecoverable data.
+    unsigned char error;
+    /// Index of the first page containing unrecoverable data.
+    unsigned short errorIndex;
+};
+#endif
+
+//------------------------------------------------------------------------------
+//         Internal functions
+//------------------------------------------------------------------------------
+
+#ifndef HARDWARE_ECC
+//------------------------------------------------------------------------------
+/// Verifies (and corrects) the data area of a page which has been read, using
+/// the ECC stored in its spare area.
+/// \param pArg  Pointer to an EccPages instance.
+/// \param index  Index of the page in the transfer.
+//------------------------------------------------------------------------------
+static void VerifyPage(void *pArg, unsigned short index)
+{
+    struct EccPages *pages = (struct EccPages *) pArg;
+    unsigned short pageDataSize = NandFlashModel_GetPageDataSize(MODEL(pages->ecc));
+    unsigned char pageSpareSize = NandFlashModel_GetPageSpareSize(MODEL(pages->ecc));
+    unsigned char hamming[NandCommon_MAXSPAREECCBYTES];
+    unsigned char error;
+
+    NandSpareScheme_ReadEcc(NandFlashModel_GetScheme(MODEL(pages->ecc)),
+                            &pages->spare[index * pageSpareSize],
+                            hamming);
+    error = Hamming_Verify256x(&pages->data[index * pageDataSize],
+                               pageDataSize,
+                               hamming);
+    if (error && (error != Hamming_ERROR_SINGLEBIT) && !pages->error) {
+
+        pages->error = 1;
+        pages->errorIndex = index;
+    }
+}
+
+//------------------------------------------------------------------------------
+/// Fills the spare area of a page which is being written with the ECC of its
+/// data area.
+/// \param pArg  Pointer to an EccPages instance.
+/// \param index  Index of the page in the transfer.
+//------------------------------------------------------------------------------
+static void ComputePage(void *pArg, unsigned short index)
+{
+    struct EccPages *pages = (struct EccPages *) pArg;
+    unsigned short pageDataSize = NandFlashModel_GetPageDataSize(MODEL(pages->ecc));
+    unsigned char pageSpareSize = NandFlashModel_GetPageSpareSize(MODEL(pages->ecc));
+    unsigned char hamming[NandCommon_MAXSPAREECCBYTES];
+    unsigned char *spare = &pages->spare[index * pageSpareSize];
+
+    Hamming_Compute256x(&pages->data[index * pageDataSize], pageDataSize, hamming);
+    memset(spare, 0xFF, pageSpareSize);
+    NandSpareScheme_WriteEcc(NandFlashModel_GetScheme(MODEL(pages->ecc)),
+                             spare,
+                             hamming);
+}
+#endif
+
 //------------------------------------------------------------------------------
 //         Exported functions
 //------------------------------------------------------------------------------
@@ -281,3 +363,145 @@ unsigned char EccNandFlash_WritePage(
     return 0;
 }
 
+//------------------------------------------------------------------------------
+/// Reads the data areas of several consecutive pages of a block, and verifies
+/// each of them using the ECC information contained in its spare area. The
+/// data is read directly into the given buffer, using the cache read function
+/// of the device when available; each page is verified while the next one is
+/// being transferred.
+/// Returns 0 if the data has been read and is valid; otherwise returns either
+/// NandCommon_ERROR_CORRUPTEDDATA or a RawNandFlash_ReadPages error code.
+/// \param ecc  Pointer to an EccNandFlash instance.
+/// \param block  Number of block to read from.
+/// \param page  Number of the first page to read inside given block.
+/// \param numPages  Number of pages to read.
+/// \param data  Data area buffer (numPages data areas).
+//------------------------------------------------------------------------------
+unsigned char EccNandFlash_ReadPages(
+    const struct EccNandFlash *ecc,
+    unsigned short block,
+    unsigned short page,
+    unsigned short numPages,
+    void *data)
+{
+    unsigned short pageDataSize = NandFlashModel_GetPageDataSize(MODEL(ecc));
+    unsigned char error;
+#ifndef HARDWARE_ECC
+    unsigned char tmpSpare[NUMCACHEPAGES * NandCommon_MAXPAGESPARESIZE];
+    struct EccPages pages;
+    unsigned short count;
+#endif
+
+    TRACE_DEBUG("EccNandFlash_ReadPages(B#%d:P#%d, %d)\n\r", block, page, numPages);
+#ifndef HARDWARE_ECC
+    pages.ecc = ecc;
+    pages.spare = tmpSpare;
+    while (numPages > 0) {
+
+        count = (numPages > NUMCACHEPAGES) ? NUMCACHEPAGES : numPages;
+        pages.data = (unsigned char *) data;
+        pages.error = 0;
+
+        // Read data and spare of several pages at once, verifying (and
+        // correcting) each page in place
+        error = RawNandFlash_ReadPages(RAW(ecc), block, page, count,
+                                       data, tmpSpare, VerifyPage, &pages);
+        if (error) {
+
+            TRACE_ERROR("EccNandFlash_ReadPages: Failed to read pages\n\r");
+            return error;
+        }
+        if (pages.error) {
+
+            TRACE_ERROR("EccNandFlash_ReadPages: at B%d.P%d Unrecoverable data\n\r",
+                        block, page + pages.errorIndex);
+            return NandCommon_ERROR_CORRUPTEDDATA;
+        }
+
+        data = (void *) ((unsigned char *) data + count * pageDataSize);
+        page += count;
+        numPages -= count;
+    }
+#else
+    // Hardware ECC parity is computed on a single page transfer
+    while (numPages > 0) {
+
+        error = EccNandFlash_ReadPage(ecc, block, page, data, 0);
+        if (error) {
+
+            return error;
+        }
+        data = (void *) ((unsigned char *) data + pageDataSize);
+        page++;
+        numPages--;
+    }
+#endif
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/// Writes the data areas of several consecutive pages of a block, after
+/// calculating the ECC of each of them and storing it in its spare area. Uses
+/// the cache program function of the device when available; the ECC of each
+/// page is calculated while its data area is being transferred.
+/// Returns 0 if successful; otherwise returns an error code.
+/// \param ecc  Pointer to an EccNandFlash instance.
+/// \param block  Number of the block to write in.
+/// \param page  Number of the first page to write inside the given block.
+/// \param numPages  Number of pages to write.
+/// \param data  Data area buffer (numPages data areas).
+//------------------------------------------------------------------------------
+unsigned char EccNandFlash_WritePages(
+    const struct EccNandFlash *ecc,
+    unsigned short block,
+    unsigned short page,
+    unsigned short numPages,
+    void *data)
+{
+    unsigned short pageDataSize = NandFlashModel_GetPageDataSize(MODEL(ecc));
+    unsigned char error;
+#ifndef HARDWARE_ECC
+    unsigned char tmpSpare[NUMCACHEPAGES * NandCommon_MAXPAGESPARESIZE];
+    struct EccPages pages;
+    unsigned short count;
+#endif
+
+    TRACE_DEBUG("EccNandFlash_WritePages(B#%d:P#%d, %d)\n\r", block, page, numPages);
+#ifndef HARDWARE_ECC
+    pages.ecc = ecc;
+    pages.spare = tmpSpare;
+    while (numPages > 0) {
+
+        count = (numPages > NUMCACHEPAGES) ? NUMCACHEPAGES : numPages;
+        pages.data = (unsigned char *) data;
+
+        // Write data and spare of several pages at once, the spare of each
+        // page being computed just before it is sent
+        error = RawNandFlash_WritePages(RAW(ecc), block, page, count,
+                                        data, tmpSpare, ComputePage, &pages);
+        if (error) {
+
+            TRACE_ERROR("EccNandFlash_WritePages: Failed to write pages\n\r");
+            return error;
+        }
+
+        data = (void *) ((unsigned char *) data + count * pageDataSize);
+        page += count;
+        numPages -= count;
+    }
+#else
+    // Hardware ECC parity is computed on a single page transfer
+    while (numPages > 0) {
+
+        error = EccNandFlash_WritePage(ecc, block, page, data, 0);
+        if (error) {
+
+            return error;
+        }
+        data = (void *) ((unsigned char *) data + pageDataSize);
+        page++;
+        numPages--;
+    }
+#endif
+    return 0;
+}
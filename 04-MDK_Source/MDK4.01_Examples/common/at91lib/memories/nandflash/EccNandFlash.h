@@ -45,6 +45,8 @@
 /// -# EccNandFlash_ReadPage is uese to read a Nandflash page with ecc check, the function
 ///      will read out data and spare first, then it calculates ecc with data and then compare with 
 ///      the readout ecc, and feedback the ecc check result to dl driver.
+/// -# EccNandFlash_ReadPages and EccNandFlash_WritePages do the same for several consecutive
+///      pages of a block, using the RawNandFlash multi-page (cache) functions.
 //------------------------------------------------------------------------------
 
 #ifndef ECCNANDFLASH_H
@@ -93,5 +95,19 @@ extern unsigned char EccNandFlash_WritePage(
     void *data,
     void *spare);
 
+extern unsigned char EccNandFlash_ReadPages(
+    const struct EccNandFlash *ecc,
+    unsigned short block,
+    unsigned short page,
+    unsigned short numPages,
+    void *data);
+
+extern unsigned char EccNandFlash_WritePages(
+    const struct EccNandFlash *ecc,
+    unsigned short block,
+    unsigned short page,
+    unsigned short numPages,
+    void *data);
+
 #endif //#ifndef ECCNANDFLASH_H
 
@@ -401,3 +401,14 @@ unsigned char NandFlashModel_SupportsCopyBack(
 {
     return ((model->options & NandFlashModel_COPYBACK) != 0);
 }
+
+//------------------------------------------------------------------------------
+/// Returns 1 if the device supports the cache read and cache program
+/// operations. Otherwise returns 0.
+/// \param model  Pointer to a NandFlashModel instance.
+//------------------------------------------------------------------------------
+unsigned char NandFlashModel_SupportsCacheOperations(
+    const struct NandFlashModel *model)
+{
+    return ((model->options & NandFlashModel_CACHE) != 0);
+}
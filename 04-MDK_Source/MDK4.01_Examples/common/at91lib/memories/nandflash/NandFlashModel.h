@@ -50,6 +50,7 @@
 ///    - NandFlashModel_GetDataBusWidth
 ///    - NandFlashModel_UsesSmallBlocksRead
 ///    - NandFlashModel_UsesSmallBlocksWrite
+///    - NandFlashModel_SupportsCacheOperations
 //------------------------------------------------------------------------------
 
 #ifndef NANDFLASHMODEL_H
@@ -73,6 +74,7 @@ struct NandSpareScheme;
 /// - NandFlashModel_DATABUS8
 /// - NandFlashModel_DATABUS16
 /// - NandFlashModel_COPYBACK
+/// - NandFlashModel_CACHE
 
 /// Indicates the Nand uses an 8-bit databus.
 #define NandFlashModel_DATABUS8     (0 << 0)
@@ -83,6 +85,10 @@ struct NandSpareScheme;
 /// The Nand supports the copy-back function (internal page-to-page copy).
 #define NandFlashModel_COPYBACK     (1 << 1)
 
+/// The Nand supports the cache read (31h/3Fh) and cache program (15h)
+/// functions.
+#define NandFlashModel_CACHE        (1 << 2)
+
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
@@ -165,5 +171,8 @@ extern unsigned char NandFlashModel_HasSmallBlocks(
 extern unsigned char NandFlashModel_SupportsCopyBack(
     const struct NandFlashModel *model);
 
+extern unsigned char NandFlashModel_SupportsCacheOperations(
+    const struct NandFlashModel *model);
+
 #endif //#ifndef NANDFLASHMODEL_H
 
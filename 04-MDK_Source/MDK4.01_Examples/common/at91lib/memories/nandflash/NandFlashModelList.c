@@ -84,7 +84,7 @@ const struct NandFlashModel nandFlashModelList[NandFlashModelList_SIZE] = {
 	{0x71,   NandFlashModel_DATABUS8,    512,    256,   16,    &nandSpareScheme512},
 	
 // Large blocks devices. Parameters must be fetched from the extended I
-#define OPTIONS     NandFlashModel_COPYBACK                   
+#define OPTIONS     NandFlashModel_COPYBACK | NandFlashModel_CACHE
                                                                                           
 	{0xA2,   NandFlashModel_DATABUS8  | OPTIONS,   0,     64, 0,  &nandSpareScheme2048},
 	{0xF2,   NandFlashModel_DATABUS8  | OPTIONS,   0,     64, 0,  &nandSpareScheme2048},
@@ -36,6 +36,10 @@
 #include "NandFlashModelList.h"
 #include <utility/trace.h>
 #include <utility/assert.h>
+#if defined(NANDFLASH_DMA)
+#include <dma/dma.h>
+#include <drivers/dmad/dmad.h>
+#endif
 
 #include <string.h>
 
@@ -47,10 +51,15 @@
 /// Nand flash chip status codes
 #define STATUS_READY                    (1 << 6)
 #define STATUS_ERROR                    (1 << 0)
+/// Nand flash chip status codes (cache operations)
+#define STATUS_ARRAY_READY              (1 << 5)
+#define STATUS_ERROR_PREVIOUS           (1 << 1)
 
 /// Nand flash commands
 #define COMMAND_READ_1                  0x00
 #define COMMAND_READ_2                  0x30
+#define COMMAND_READ_CACHE_SEQ          0x31
+#define COMMAND_READ_CACHE_END          0x3F
 #define COMMAND_COPYBACK_READ_1         0x00
 #define COMMAND_COPYBACK_READ_2         0x35
 #define COMMAND_COPYBACK_PROGRAM_1      0x85
@@ -61,6 +70,7 @@
 #define COMMAND_READID                  0x90
 #define COMMAND_WRITE_1                 0x80
 #define COMMAND_WRITE_2                 0x10
+#define COMMAND_WRITE_CACHE             0x15
 #define COMMAND_ERASE_1                 0x60
 #define COMMAND_ERASE_2                 0xD0
 #define COMMAND_STATUS                  0x70
@@ -104,6 +114,18 @@
 /// Number of tries for copying a block
 #define NUMCOPYTRIES            2
 
+/// Smallest data transfer performed by DMA, smaller ones are done by the CPU
+#define DMA_MINSIZE             32
+
+//------------------------------------------------------------------------------
+//         Internal variables
+//------------------------------------------------------------------------------
+
+#if defined(NANDFLASH_DMA)
+/// Set while a data transfer is performed by the DMA controller.
+static volatile unsigned char dmaTransferPending = 0;
+#endif
+
 //------------------------------------------------------------------------------
 //         Internal functions
 //------------------------------------------------------------------------------
@@ -262,6 +284,154 @@ static void ReadData(
     }
 }
 
+#if defined(NANDFLASH_DMA)
+//------------------------------------------------------------------------------
+/// Invoked by the DMA driver when a data transfer is completed.
+//------------------------------------------------------------------------------
+static void DataTransferCallback(void)
+{
+    dmaTransferPending = 0;
+}
+
+//------------------------------------------------------------------------------
+/// Starts a DMA transfer between the NandFlash data register and a buffer.
+/// The NandFlash data is mapped on an address range (only ALE/CLE address
+/// lines are significant), so the transfer is a memory-to-memory one with
+/// both addresses incremented, using the widest access allowed by the buffer
+/// alignment: the SMC splits it into accesses of the NandFlash bus width.
+/// Returns 1 if the transfer has been started; otherwise returns 0 and the
+/// transfer must be done by the CPU.
+/// \param raw  Pointer to a RawNandFlash instance.
+/// \param buffer  Buffer to transfer from/to.
+/// \param size  Number of bytes to transfer.
+/// \param read  1 to read from the NandFlash, 0 to write to it.
+//------------------------------------------------------------------------------
+static unsigned char StartDataDma(
+    const struct RawNandFlash *raw,
+    unsigned char *buffer,
+    unsigned int size,
+    unsigned char read)
+{
+    unsigned char width;
+    unsigned int sourceAddress;
+    unsigned int destAddress;
+
+    if ((raw->dmaChannel == RawNandFlash_NODMA) || (size < DMA_MINSIZE)) {
+
+        return 0;
+    }
+
+    // Select transfer width (0: byte, 1: half-word, 2: word)
+    if (((((unsigned int) buffer) | size) & 3) == 0) {
+
+        width = 2;
+    }
+    else if (NandFlashModel_GetDataBusWidth(MODEL(raw)) == 8) {
+
+        width = 0;
+    }
+    else if (((((unsigned int) buffer) | size) & 1) == 0) {
+
+        width = 1;
+    }
+    else {
+
+        return 0;
+    }
+
+    if (read) {
+
+        sourceAddress = raw->dataAddress;
+        destAddress = (unsigned int) buffer;
+    }
+    else {
+
+        sourceAddress = (unsigned int) buffer;
+        destAddress = raw->dataAddress;
+    }
+
+    dmaTransferPending = 1;
+    if (DMAD_Configure_Buffer(raw->dmaChannel,
+                              DMA_TRANSFER_SINGLE,
+                              DMA_TRANSFER_SINGLE,
+                              0,
+                              0)
+        || DMAD_Configure_TransferController(raw->dmaChannel,
+                                             size >> width,
+                                             width,
+                                             width,
+                                             sourceAddress,
+                                             destAddress)
+        || DMAD_BufferTransfer(raw->dmaChannel,
+                               size >> width,
+                               DataTransferCallback,
+                               0)) {
+
+        TRACE_WARNING("StartDataDma: DMA channel busy, using CPU\n\r");
+        dmaTransferPending = 0;
+        return 0;
+    }
+
+    return 1;
+}
+#endif
+
+//------------------------------------------------------------------------------
+/// Starts sending a data area to the NandFlash chip. The transfer is done by
+/// DMA if configured, and must then be completed with WaitDataTransfer();
+/// otherwise it is done by the CPU before returning.
+/// \param raw  Pointer to a RawNandFlash instance.
+/// \param buffer  Buffer where the data is stored.
+/// \param size  Number of bytes that will be written
+//------------------------------------------------------------------------------
+static void StartWriteData(
+    const struct RawNandFlash *raw,
+    unsigned char *buffer,
+    unsigned int size)
+{
+#if defined(NANDFLASH_DMA)
+    if (StartDataDma(raw, buffer, size, 0)) {
+
+        return;
+    }
+#endif
+    WriteData(raw, buffer, size);
+}
+
+//------------------------------------------------------------------------------
+/// Starts reading a data area from the NandFlash chip. The transfer is done by
+/// DMA if configured, and must then be completed with WaitDataTransfer();
+/// otherwise it is done by the CPU before returning.
+/// \param raw  Pointer to a RawNandFlash instance.
+/// \param buffer  Buffer where the data will be stored.
+/// \param size  Number of bytes that will be read
+//------------------------------------------------------------------------------
+static void StartReadData(
+    const struct RawNandFlash *raw,
+    unsigned char *buffer,
+    unsigned int size)
+{
+#if defined(NANDFLASH_DMA)
+    if (StartDataDma(raw, buffer, size, 1)) {
+
+        return;
+    }
+#endif
+    ReadData(raw, buffer, size);
+}
+
+//------------------------------------------------------------------------------
+/// Waits for the end of a data transfer started by StartWriteData() or
+/// StartReadData().
+/// \param raw  Pointer to a RawNandFlash instance.
+//------------------------------------------------------------------------------
+static void WaitDataTransfer(const struct RawNandFlash *raw)
+{
+#if defined(NANDFLASH_DMA)
+    while (dmaTransferPending);
+#endif
+}
+
 //------------------------------------------------------------------------------
 /// Erases the specified block of the device. Returns 0 if the operation was
 /// successful; otherwise returns an error code.
@@ -337,7 +507,8 @@ static unsigned char WritePage(
         WRITE_COMMAND(raw, COMMAND_WRITE_1);
         WriteColumnAddress(raw, 0);
         WriteRowAddress(raw, rowAddress);
-        WriteData(raw, (unsigned char *) data, pageDataSize);
+        StartWriteData(raw, (unsigned char *) data, pageDataSize);
+        WaitDataTransfer(raw);
 
         // Spare is written here as well since it is more efficient
         if (spare) {
@@ -462,6 +633,226 @@ static unsigned char CopyPage(
     return error;
 }
 
+//------------------------------------------------------------------------------
+/// Waits for the end of a cache program operation and returns 1 if the page
+/// programmed before the last one has been written successfully; otherwise
+/// returns 0. When the last page is programmed (last=1), waits for the array
+/// to be ready and checks the status of the last page too.
+/// \param raw  Pointer to a RawNandFlash instance.
+/// \param last  Indicates if the last page of the sequence has been issued.
+/// \param previous  Indicates if a page has been programmed before, i.e. if
+///                  the status of the previous page is meaningful.
+//------------------------------------------------------------------------------
+static unsigned char IsCacheOperationComplete(
+    const struct RawNandFlash *raw,
+    unsigned char last,
+    unsigned char previous)
+{
+    unsigned char status;
+
+    WRITE_COMMAND(raw, COMMAND_STATUS);
+    if (last) {
+
+        while (((status = READ_DATA8(raw)) & STATUS_ARRAY_READY) != STATUS_ARRAY_READY);
+        if ((status & STATUS_ERROR) != 0) {
+
+            return 0;
+        }
+    }
+    else {
+
+        while (((status = READ_DATA8(raw)) & STATUS_READY) != STATUS_READY);
+    }
+
+    return (!previous || ((status & STATUS_ERROR_PREVIOUS) == 0));
+}
+
+//------------------------------------------------------------------------------
+/// Reads several consecutive pages of a block using the cache read function:
+/// while the data of one page is transferred from the cache register, the
+/// device already loads the next page from the array.
+/// \param raw  Pointer to a RawNandFlash instance.
+/// \param block  Number of the block where the pages to read reside.
+/// \param page  Number of the first page to read inside the given block.
+/// \param numPages  Number of pages to read (at least 2).
+/// \param data  Buffer where the data areas will be stored.
+/// \param spare  Buffer where the spare areas will be stored, can be 0.
+/// \param callback  Optional function invoked when a page has been read.
+/// \param pArg  Argument of the callback.
+//------------------------------------------------------------------------------
+static void CacheReadPages(
+    const struct RawNandFlash *raw,
+    unsigned short block,
+    unsigned short page,
+    unsigned short numPages,
+    unsigned char *data,
+    unsigned char *spare,
+    RawNandFlashCallback callback,
+    void *pArg)
+{
+    unsigned int pageDataSize = NandFlashModel_GetPageDataSize(MODEL(raw));
+    unsigned int pageSpareSize = NandFlashModel_GetPageSpareSize(MODEL(raw));
+    unsigned int rowAddress;
+    unsigned short i;
+
+    TRACE_DEBUG("CacheReadPages(B#%d:P#%d, %d)\r\n", block, page, numPages);
+
+    // Calculate actual address of the first page
+    rowAddress = block * NandFlashModel_GetBlockSizeInPages(MODEL(raw)) + page;
+
+    ENABLE_CE(raw);
+
+    // Load the first page into the data register
+    WRITE_COMMAND(raw, COMMAND_READ_1);
+    WriteColumnAddress(raw, 0);
+    WriteRowAddress(raw, rowAddress);
+    WRITE_COMMAND(raw, COMMAND_READ_2);
+    WaitReady(raw);
+
+    for (i = 0; i < numPages; i++) {
+
+        // Move page i to the cache register and start loading page i+1,
+        // except for the last page
+        if (i < (numPages - 1)) {
+
+            WRITE_COMMAND(raw, COMMAND_READ_CACHE_SEQ);
+        }
+        else {
+
+            WRITE_COMMAND(raw, COMMAND_READ_CACHE_END);
+        }
+        WaitReady(raw);
+
+        // Transfer page i while the array is busy with page i+1, and let
+        // the previous page be processed during the data transfer
+        WRITE_COMMAND(raw, COMMAND_READ_1);
+        StartReadData(raw, data, pageDataSize);
+        if (callback && (i > 0)) {
+
+            callback(pArg, i - 1);
+        }
+        WaitDataTransfer(raw);
+        data += pageDataSize;
+        if (spare) {
+
+            ReadData(raw, spare, pageSpareSize);
+            spare += pageSpareSize;
+        }
+    }
+
+    DISABLE_CE(raw);
+
+    if (callback) {
+
+        callback(pArg, numPages - 1);
+    }
+}
+
+//------------------------------------------------------------------------------
+/// Writes several consecutive pages of a block using the cache program
+/// function: the data of one page is transferred into the cache register
+/// while the device programs the previous page into the array.
+/// Returns 0 if all pages have been written successfully; otherwise returns
+/// NandCommon_ERROR_CANNOTWRITE, once the device has finished programming.
+/// The pages from the failed one onwards must then be considered as not
+/// written.
+/// \param raw  Pointer to a RawNandFlash instance.
+/// \param block  Number of the block where the pages to write reside.
+/// \param page  Number of the first page to write inside the given block.
+/// \param numPages  Number of pages to write (at least 2).
+/// \param data  Buffer containing the data areas.
+/// \param spare  Buffer containing the spare areas, can be 0.
+/// \param callback  Optional function invoked before a spare area is sent.
+/// \param pArg  Argument of the callback.
+//------------------------------------------------------------------------------
+static unsigned char CacheWritePages(
+    const struct RawNandFlash *raw,
+    unsigned short block,
+    unsigned short page,
+    unsigned short numPages,
+    unsigned char *data,
+    unsigned char *spare,
+    RawNandFlashCallback callback,
+    void *pArg)
+{
+    unsigned char error = 0;
+    unsigned int pageDataSize = NandFlashModel_GetPageDataSize(MODEL(raw));
+    unsigned int pageSpareSize = NandFlashModel_GetPageSpareSize(MODEL(raw));
+    unsigned short dummyByte;
+    unsigned int rowAddress;
+    unsigned short i;
+
+    TRACE_DEBUG("CacheWritePages(B#%d:P#%d, %d)\r\n", block, page, numPages);
+
+    // Calculate physical address of the first page
+    rowAddress = block * NandFlashModel_GetBlockSizeInPages(MODEL(raw)) + page;
+
+    ENABLE_CE(raw);
+
+    for (i = 0; i < numPages; i++) {
+
+        WRITE_COMMAND(raw, COMMAND_WRITE_1);
+        WriteColumnAddress(raw, 0);
+        WriteRowAddress(raw, rowAddress + i);
+
+        // The spare area of the page can be prepared during the data transfer
+        StartWriteData(raw, data, pageDataSize);
+        if (callback) {
+
+            callback(pArg, i);
+        }
+        WaitDataTransfer(raw);
+        data += pageDataSize;
+        if (spare) {
+
+            WriteData(raw, spare, pageSpareSize);
+            spare += pageSpareSize;
+        }
+        else {
+            // Same ECC parity workaround as in WritePage()
+            ReadData(raw, (unsigned char *) (&dummyByte), 2);
+        }
+
+        // The last page is programmed with a regular page program command
+        if (i < (numPages - 1)) {
+
+            WRITE_COMMAND(raw, COMMAND_WRITE_CACHE);
+            WaitReady(raw);
+            if (!IsCacheOperationComplete(raw, 0, (i > 0))) {
+
+                error = NandCommon_ERROR_CANNOTWRITE;
+                break;
+            }
+        }
+        else {
+
+            WRITE_COMMAND(raw, COMMAND_WRITE_2);
+            WaitReady(raw);
+            if (!IsCacheOperationComplete(raw, 1, 1)) {
+
+                error = NandCommon_ERROR_CANNOTWRITE;
+            }
+        }
+    }
+
+    if (error) {
+
+        // The page sent after the failed one is still being programmed:
+        // R/B only reports the cache register, so wait for the array itself
+        // before releasing the chip
+        if (i < (numPages - 1)) {
+
+            IsCacheOperationComplete(raw, 1, 1);
+        }
+        TRACE_ERROR("CacheWritePages: Failed writing B#%d:P#%d..%d\n\r",
+                    block, page, page + numPages - 1);
+    }
+
+    DISABLE_CE(raw);
+
+    return error;
+}
+
 //------------------------------------------------------------------------------
 //         Exported functions
 //------------------------------------------------------------------------------
@@ -497,6 +888,9 @@ unsigned char RawNandFlash_Initialize(
     raw->dataAddress = dataAddress;
     raw->pinChipEnable = pinChipEnable;
     raw->pinReadyBusy = pinReadyBusy;
+#if defined(NANDFLASH_DMA)
+    raw->dmaChannel = RawNandFlash_NODMA;
+#endif
 
     // Reset
     RawNandFlash_Reset(raw);
@@ -524,6 +918,28 @@ unsigned char RawNandFlash_Initialize(
     return 0;
 }
 
+#if defined(NANDFLASH_DMA)
+//------------------------------------------------------------------------------
+/// Configures the DMA channel used for the data phase of page transfers, or
+/// disables DMA transfers if the channel is RawNandFlash_NODMA. The DMA
+/// controller interrupt is handled by the default DMAD handler.
+/// \param raw  Pointer to a RawNandFlash instance.
+/// \param channel  DMA channel number, or RawNandFlash_NODMA.
+//------------------------------------------------------------------------------
+void RawNandFlash_ConfigureDma(
+    struct RawNandFlash *raw,
+    unsigned char channel)
+{
+    TRACE_DEBUG("RawNandFlash_ConfigureDma(%d)\n\r", channel);
+
+    if (channel != RawNandFlash_NODMA) {
+
+        DMAD_Initialize(channel, DMAD_USE_DEFAULT_IT);
+    }
+    raw->dmaChannel = channel;
+}
+#endif
+
 //------------------------------------------------------------------------------
 /// Resets a NandFlash device.
 /// \param raw  Pointer to a RawNandFlash instance.
@@ -656,7 +1072,8 @@ unsigned char RawNandFlash_ReadPage(
     // Read data area if needed
     if (data) {
         WRITE_COMMAND(raw, COMMAND_READ_1);
-        ReadData(raw, (unsigned char *) data, pageDataSize);
+        StartReadData(raw, (unsigned char *) data, pageDataSize);
+        WaitDataTransfer(raw);
 
         if (spare) {
             ReadData(raw, (unsigned char *) spare, pageSpareSize);
@@ -674,6 +1091,76 @@ unsigned char RawNandFlash_ReadPage(
     return 0;
 }
 
+//------------------------------------------------------------------------------
+/// Reads the data and optionally the spare areas of several consecutive pages
+/// of a block into the provided buffers. The data areas are stored one after
+/// the other in the data buffer, and so are the spare areas in the spare
+/// buffer. If the model supports cache operations, the array read of one page
+/// is overlapped with the transfer of the previous one; otherwise the pages
+/// are read one by one.
+/// If a callback is given, it is invoked with the index of each page once its
+/// data and spare areas are in memory; when the data phase is done by DMA,
+/// this happens while the next page is being transferred.
+/// Returns 0 if the operation has been successful; otherwise returns an error
+/// code.
+/// \param raw  Pointer to a RawNandFlash instance.
+/// \param block  Number of the block where the pages to read reside.
+/// \param page  Number of the first page to read inside the given block.
+/// \param numPages  Number of pages to read.
+/// \param data  Buffer where the data areas will be stored.
+/// \param spare  Buffer where the spare areas will be stored, can be 0.
+/// \param callback  Optional function invoked when a page has been read.
+/// \param pArg  Argument of the callback.
+//------------------------------------------------------------------------------
+unsigned char RawNandFlash_ReadPages(
+    const struct RawNandFlash *raw,
+    unsigned short block,
+    unsigned short page,
+    unsigned short numPages,
+    void *data,
+    void *spare,
+    RawNandFlashCallback callback,
+    void *pArg)
+{
+    unsigned int pageDataSize = NandFlashModel_GetPageDataSize(MODEL(raw));
+    unsigned int pageSpareSize = NandFlashModel_GetPageSpareSize(MODEL(raw));
+    unsigned char error;
+    unsigned short i;
+
+    ASSERT(data, "RawNandFlash_ReadPages: Data area must be read\n\r");
+    ASSERT((page + numPages) <= NandFlashModel_GetBlockSizeInPages(MODEL(raw)),
+           "RawNandFlash_ReadPages: Pages must reside in the same block\n\r");
+    TRACE_DEBUG("RawNandFlash_ReadPages(B#%d:P#%d, %d)\r\n", block, page, numPages);
+
+    if ((numPages > 1) && NandFlashModel_SupportsCacheOperations(MODEL(raw))) {
+
+        CacheReadPages(raw, block, page, numPages,
+                       (unsigned char *) data, (unsigned char *) spare,
+                       callback, pArg);
+        return 0;
+    }
+
+    for (i = 0; i < numPages; i++) {
+
+        error = RawNandFlash_ReadPage(raw, block, page + i, data, spare);
+        if (error) {
+
+            return error;
+        }
+        if (callback) {
+
+            callback(pArg, i);
+        }
+        data = (void *) ((unsigned char *) data + pageDataSize);
+        if (spare) {
+
+            spare = (void *) ((unsigned char *) spare + pageSpareSize);
+        }
+    }
+
+    return 0;
+}
+
 //------------------------------------------------------------------------------
 /// Writes the data and/or the spare area of a page on a NandFlash chip. If one
 /// of the buffer pointer is 0, the corresponding area is not written. Retries
@@ -710,6 +1197,80 @@ unsigned char RawNandFlash_WritePage(
     return NandCommon_ERROR_BADBLOCK;
 }
 
+//------------------------------------------------------------------------------
+/// Writes the data and optionally the spare areas of several consecutive pages
+/// of a block. The data areas are taken one after the other from the data
+/// buffer, and so are the spare areas from the spare buffer. If the model
+/// supports cache operations, the transfer of one page is overlapped with the
+/// programming of the previous one; otherwise the pages are written one by
+/// one, with retries.
+/// If a callback is given, it is invoked with the index of each page before
+/// its spare area is sent, so that it can fill it (e.g. with the ECC of the
+/// data area); when the data phase is done by DMA, this happens while the
+/// data area is being transferred.
+/// Returns 0 if the write operation is successful; otherwise returns
+/// NandCommon_ERROR_BADBLOCK.
+/// \param raw  Pointer to a RawNandFlash instance.
+/// \param block  Number of the block where the pages to write reside.
+/// \param page  Number of the first page to write inside the given block.
+/// \param numPages  Number of pages to write.
+/// \param data  Buffer containing the data areas.
+/// \param spare  Buffer containing the spare areas, can be 0.
+/// \param callback  Optional function invoked before a spare area is sent.
+/// \param pArg  Argument of the callback.
+//------------------------------------------------------------------------------
+unsigned char RawNandFlash_WritePages(
+    const struct RawNandFlash *raw,
+    unsigned short block,
+    unsigned short page,
+    unsigned short numPages,
+    void *data,
+    void *spare,
+    RawNandFlashCallback callback,
+    void *pArg)
+{
+    unsigned int pageDataSize = NandFlashModel_GetPageDataSize(MODEL(raw));
+    unsigned int pageSpareSize = NandFlashModel_GetPageSpareSize(MODEL(raw));
+    unsigned short i;
+
+    ASSERT(data, "RawNandFlash_WritePages: Data area must be written\n\r");
+    ASSERT((page + numPages) <= NandFlashModel_GetBlockSizeInPages(MODEL(raw)),
+           "RawNandFlash_WritePages: Pages must reside in the same block\n\r");
+    TRACE_DEBUG("RawNandFlash_WritePages(B#%d:P#%d, %d)\r\n", block, page, numPages);
+
+    if ((numPages > 1) && NandFlashModel_SupportsCacheOperations(MODEL(raw))) {
+
+        // A page which cannot be programmed means the block must be replaced;
+        // already programmed pages cannot be retried.
+        if (CacheWritePages(raw, block, page, numPages,
+                            (unsigned char *) data, (unsigned char *) spare,
+                            callback, pArg)) {
+
+            return NandCommon_ERROR_BADBLOCK;
+        }
+        return 0;
+    }
+
+    for (i = 0; i < numPages; i++) {
+
+        if (callback) {
+
+            callback(pArg, i);
+        }
+        if (RawNandFlash_WritePage(raw, block, page + i, data, spare)) {
+
+            return NandCommon_ERROR_BADBLOCK;
+        }
+        data = (void *) ((unsigned char *) data + pageDataSize);
+        if (spare) {
+
+            spare = (void *) ((unsigned char *) spare + pageSpareSize);
+        }
+    }
+
+    return 0;
+}
+
 //------------------------------------------------------------------------------
 /// Copy the data in a page of the NandFlash device to an other page on that
 /// same chip. Both pages must have be even or odd; it is not possible to copy
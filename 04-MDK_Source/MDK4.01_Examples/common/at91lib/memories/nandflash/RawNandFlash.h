@@ -44,6 +44,11 @@
 /// -# RawNandFlash_ReadId is used to read a Nandflash's id.
 /// -# RawNandFlash_EraseBlock is used to erase a certain Nandflash device's block.
 /// -# RawNandFlash_ReadPage and RawNandFlash_WritePage is used to do read/write operation.
+/// -# RawNandFlash_ReadPages and RawNandFlash_WritePages read/write several consecutive pages
+///      of a block, using the cache read/program functions when the model supports them.
+/// -# When NANDFLASH_DMA is defined, RawNandFlash_ConfigureDma selects a DMA channel which
+///      moves the data areas of pages instead of the CPU. The buffers must not be held in
+///      the data cache.
 /// -# RawNandFlash_CopyPage is used to issue copypage command to Nandflash device.
 /// -# RawNandFlash_CopyBlock calls RawNandFlash_CopyPage to do a Nandflash block copy.
 //------------------------------------------------------------------------------
@@ -59,10 +64,22 @@
 #include "NandFlashModel.h"
 #include <pio/pio.h>
 
+//------------------------------------------------------------------------------
+//         Definitions
+//------------------------------------------------------------------------------
+
+#if defined(NANDFLASH_DMA)
+/// Indicates that no DMA channel is used for data transfers.
+#define RawNandFlash_NODMA      0xFF
+#endif
+
 //------------------------------------------------------------------------------
 //         Types
 //------------------------------------------------------------------------------
 
+/// Function invoked by the multi-page functions for each page transferred.
+typedef void (*RawNandFlashCallback)(void *pArg, unsigned short index);
+
 //------------------------------------------------------------------------------
 /// Describes a physical NandFlash chip connected to the SAM microcontroller.
 //------------------------------------------------------------------------------
@@ -80,6 +97,10 @@ struct RawNandFlash {
     Pin pinChipEnable;
     /// Pin used to monitor the ready/busy signal from the NandFlash.
     Pin pinReadyBusy;
+#if defined(NANDFLASH_DMA)
+    /// DMA channel used for data transfers, or RawNandFlash_NODMA.
+    unsigned char dmaChannel;
+#endif
 };
 
 //------------------------------------------------------------------------------
@@ -95,6 +116,12 @@ extern unsigned char RawNandFlash_Initialize(
     const Pin pinChipEnable,
     const Pin pinReadyBusy);
 
+#if defined(NANDFLASH_DMA)
+extern void RawNandFlash_ConfigureDma(
+    struct RawNandFlash *raw,
+    unsigned char channel);
+#endif
+
 extern void RawNandFlash_Reset(const struct RawNandFlash *raw);
 
 extern unsigned int RawNandFlash_ReadId(const struct RawNandFlash *raw);
@@ -117,6 +144,26 @@ extern unsigned char RawNandFlash_WritePage(
     void *data,
     void *spare);
 
+extern unsigned char RawNandFlash_ReadPages(
+    const struct RawNandFlash *raw,
+    unsigned short block,
+    unsigned short page,
+    unsigned short numPages,
+    void *data,
+    void *spare,
+    RawNandFlashCallback callback,
+    void *pArg);
+
+extern unsigned char RawNandFlash_WritePages(
+    const struct RawNandFlash *raw,
+    unsigned short block,
+    unsigned short page,
+    unsigned short numPages,
+    void *data,
+    void *spare,
+    RawNandFlashCallback callback,
+    void *pArg);
+
 extern unsigned char RawNandFlash_CopyPage(
     const struct RawNandFlash *raw,
     unsigned short sourceBlock,
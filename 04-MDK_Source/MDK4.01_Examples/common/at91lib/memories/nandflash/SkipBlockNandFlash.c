@@ -289,14 +289,11 @@ unsigned char SkipBlockNandFlash_ReadBlock(
     void *data)
 {
     /// Number of pages per block
-    unsigned int numPagesPerBlock, pageSize;
-    // Page index
-    unsigned short i;
-    // Error returned by SkipBlockNandFlash_WritePage
+    unsigned int numPagesPerBlock;
+    // Error returned by EccNandFlash_ReadPages
     unsigned char error = 0;
     
     // Retrieve model information
-    pageSize = NandFlashModel_GetPageDataSize(MODEL(skipBlock));
     numPagesPerBlock = NandFlashModel_GetBlockSizeInPages(MODEL(skipBlock));
 
     // Check that the block is not BAD if data is requested
@@ -307,14 +304,11 @@ unsigned char SkipBlockNandFlash_ReadBlock(
     }
 
     // Read all the pages of the block
-    for (i = 0; i < numPagesPerBlock; i++) {
-        error = EccNandFlash_ReadPage(ECC(skipBlock), block, i, data, 0);
-        if (error) {
+    error = EccNandFlash_ReadPages(ECC(skipBlock), block, 0, numPagesPerBlock, data);
+    if (error) {
 
-            TRACE_ERROR("SkipBlockNandFlash_ReadBlock: Cannot read page %d of block %d.\n\r", i, block);
-            return error;
-        }
-        data = (void *) ((unsigned char *) data + pageSize);
+        TRACE_ERROR("SkipBlockNandFlash_ReadBlock: Cannot read block %d.\n\r", block);
+        return error;
     }
     
     return 0;
@@ -351,7 +345,8 @@ unsigned char SkipBlockNandFlash_WritePage(
 //------------------------------------------------------------------------------
 /// Writes the data of a whole block on a SkipBlock nandflash.
 /// Returns NandCommon_ERROR_BADBLOCK if the block is BAD; Otherwise, returns
-/// EccNandFlash_ReadPage().
+/// EccNandFlash_WritePages(), so that a block which cannot be programmed is
+/// reported as NandCommon_ERROR_BADBLOCK.
 /// \param skipBlock  Pointer to a SkipBlockNandFlash instance.
 /// \param block  Number of block to read page from.
 /// \param data  Data area buffer, can be 0.
@@ -363,15 +358,10 @@ unsigned char SkipBlockNandFlash_WriteBlock(
 {
     // Number of pages per block
     unsigned int numPagesPerBlock;
-    // Page size
-    unsigned int pageSize;
-    // Page index
-    unsigned short i;
-    // Error returned by SkipBlockNandFlash_WritePage
+    // Error returned by EccNandFlash_WritePages
     unsigned char error = 0;
     
     // Retrieve model information
-    pageSize = NandFlashModel_GetPageDataSize(MODEL(skipBlock));
     numPagesPerBlock = NandFlashModel_GetBlockSizeInPages(MODEL(skipBlock));
 
     // Check that the block is LIVE
@@ -381,14 +371,12 @@ unsigned char SkipBlockNandFlash_WriteBlock(
         return NandCommon_ERROR_BADBLOCK;
     }    
     
-    for (i = 0; i < numPagesPerBlock; i++) {
-        error = EccNandFlash_WritePage(ECC(skipBlock), block, i, data, 0);       
-        if (error) {
+    // Write all the pages of the block
+    error = EccNandFlash_WritePages(ECC(skipBlock), block, 0, numPagesPerBlock, data);
+    if (error) {
 
-            TRACE_ERROR("SkipBlockNandFlash_WriteBlock: Cannot write page %d of block %d.\n\r", i, block);
-            return NandCommon_ERROR_CANNOTWRITE;
-        }
-        data = (void *) ((unsigned char *) data + pageSize);
+        TRACE_ERROR("SkipBlockNandFlash_WriteBlock: Cannot write block %d.\n\r", block);
+        return error;
     }
 
     return 0;
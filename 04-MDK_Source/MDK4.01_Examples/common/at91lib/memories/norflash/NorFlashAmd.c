@@ -47,10 +47,13 @@
 #define AMD_CMD_UNLOCK_2      0x0055
 #define AMD_CMD_ERASE_SETUP   0x0080
 #define AMD_CMD_ERASE_RESUME  0x0030
+#define AMD_CMD_ERASE_SUSPEND 0x00B0
 #define AMD_CMD_ERASE_CHIP    0x0010
 #define AMD_CMD_ERASE_SECTOR  0x0030
 #define AMD_CMD_PROGRAM       0x00A0
 #define AMD_CMD_UNLOCK_BYPASS 0x0020
+#define AMD_CMD_WRITE_BUFFER  0x0025
+#define AMD_CMD_PROGRAM_BUFFER 0x0029
 
 // Command offset for vendor command set CMD_SET_AMD
 #define AMD_OFFSET_UNLOCK_1   0x05555
@@ -64,9 +67,10 @@
 
 // Data polling mask for vendor command set CMD_SET_AMD
 #define AMD_POLLING_DQ7       0x80
-#define AMD_POLLING_DQ6       0x60
+#define AMD_POLLING_DQ6       0x40
 #define AMD_POLLING_DQ5       0x20
 #define AMD_POLLING_DQ3       0x08
+#define AMD_POLLING_DQ1       0x02
 
 
 //------------------------------------------------------------------------------
@@ -207,6 +211,127 @@ unsigned char amd_Program(
     return 0;
 }
 
+//------------------------------------------------------------------------------
+/// It implements a write to buffer program command. The words must all lie in
+/// the same write-buffer page of the device. Returns 0 if the operation was
+/// successful; otherwise returns an error code.
+/// \param pNorFlashInfo  Pointer to an NorFlashInfo instance.
+/// \param address Start address offset to be wrote.
+/// \param buffer Buffer where the data is stored.
+/// \param count Number of words to be written.
+//------------------------------------------------------------------------------
+unsigned char amd_ProgramBuffer(
+    struct NorFlashInfo *pNorFlashInfo,
+    unsigned int address,
+    unsigned char *buffer,
+    unsigned int count)
+{
+    unsigned int pollingData;
+    unsigned int data = 0;
+    unsigned int sectorAddress;
+    unsigned int busAddress;
+    unsigned int i;
+    unsigned char done = 0;
+    unsigned char busWidth;
+    unsigned char chipWidth;
+
+    busWidth = NorFlash_GetDataBusWidth(pNorFlashInfo);
+    chipWidth = pNorFlashInfo->deviceChipWidth;
+    // The write buffer command sequence is initiated by writing two unlock cycles.
+    WriteCommand(busWidth, 
+                 NorFlash_GetByteAddressInChip(pNorFlashInfo, AMD_OFFSET_UNLOCK_1),
+                 AMD_CMD_UNLOCK_1);
+    WriteCommand(busWidth, 
+                 NorFlash_GetByteAddressInChip(pNorFlashInfo, AMD_OFFSET_UNLOCK_2), 
+                 AMD_CMD_UNLOCK_2);
+    // Followed by the write buffer load command at the sector address.
+    sectorAddress = NorFlash_GetAddressInChip(pNorFlashInfo, address);
+    WriteCommand(busWidth, sectorAddress, AMD_CMD_WRITE_BUFFER);
+    // The number of words to be loaded minus one is written next.
+    WriteCommand(busWidth, sectorAddress, count - 1);
+
+    // Then the address and data of each word are loaded into the buffer.
+    busAddress = sectorAddress;
+    for (i = 0; i < count; i++) {
+        WriteRawData(busWidth, busAddress, buffer);
+        busAddress += chipWidth;
+        buffer += chipWidth;
+    }
+    busAddress -= chipWidth;
+    memcpy(&data, buffer - chipWidth, chipWidth);
+
+    // The program buffer to flash command starts the Embedded Program algorithm.
+    WriteCommand(busWidth, sectorAddress, AMD_CMD_PROGRAM_BUFFER);
+
+    // Data polling on the last loaded address
+    do {
+        ReadRawData(busWidth, busAddress, (unsigned char *)&pollingData);
+        // Check if the chip program algorithm is completed.
+        if ((pollingData & AMD_POLLING_DQ7) == (data & AMD_POLLING_DQ7)) {
+            // Program operation successful. Device in read mode.
+            done = 1;
+        }
+        else if (pollingData & (AMD_POLLING_DQ5 | AMD_POLLING_DQ1)) {
+
+            // I/O should be rechecked.
+            ReadRawData(busWidth, busAddress, (unsigned char *)&pollingData);
+
+            if ((pollingData & AMD_POLLING_DQ7) == (data & AMD_POLLING_DQ7)) {
+                // Program operation successful. Device in read mode.
+                done = 1;
+            }
+            else {
+                // Program aborted or timed out, the write-to-buffer-abort
+                // reset sequence returns the device to read mode.
+                amd_Reset(pNorFlashInfo, 0);
+                return NorCommon_ERROR_CANNOTWRITE;
+            }
+        }
+    } while (!done);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/// Issues the sector erase command sequence and returns the bus address of the
+/// sector, without waiting for the erase to complete.
+/// \param pNorFlashInfo  Pointer to an NorFlashInfo instance.
+/// \param address Address offset to be erase.
+//------------------------------------------------------------------------------
+unsigned int amd_EraseSectorCommand(
+    struct NorFlashInfo *pNorFlashInfo, 
+    unsigned int address)
+{
+    unsigned int busAddress;
+    unsigned char busWidth;
+    
+    busWidth = NorFlash_GetDataBusWidth(pNorFlashInfo);
+    
+    //Programming is a six-bus-cycle operation. 
+    // The erase command sequence is initiated by writing two unlock write cycles.
+    WriteCommand(busWidth, 
+                 NorFlash_GetByteAddressInChip(pNorFlashInfo, AMD_OFFSET_UNLOCK_1), 
+                 AMD_CMD_UNLOCK_1);
+    WriteCommand(busWidth, 
+                 NorFlash_GetByteAddressInChip(pNorFlashInfo, AMD_OFFSET_UNLOCK_2), 
+                 AMD_CMD_UNLOCK_2);
+    // Followed by the program set-up command.
+    WriteCommand(busWidth, 
+                 NorFlash_GetByteAddressInChip(pNorFlashInfo, AMD_OFFSET_UNLOCK_1),
+                 AMD_CMD_ERASE_SETUP);
+    // Two additional unlock cycles are written.
+    WriteCommand(busWidth, 
+                 NorFlash_GetByteAddressInChip(pNorFlashInfo, AMD_OFFSET_UNLOCK_1), 
+                 AMD_CMD_UNLOCK_1);
+    WriteCommand(busWidth, 
+                 NorFlash_GetByteAddressInChip(pNorFlashInfo, AMD_OFFSET_UNLOCK_2), 
+                 AMD_CMD_UNLOCK_2);
+        
+    // Followed by the address of the sector to be erased, and the sector erase command.
+    busAddress = NorFlash_GetAddressInChip(pNorFlashInfo,address);              
+    WriteCommand(busWidth, busAddress, AMD_CMD_ERASE_SECTOR);
+    return busAddress;
+}
+
 //------------------------------------------------------------------------------
 //         Exported functions
 //------------------------------------------------------------------------------
@@ -256,30 +381,7 @@ unsigned char AMD_EraseSector(
     unsigned char done = 0;
     
     busWidth = NorFlash_GetDataBusWidth(pNorFlashInfo);
-    
-    //Programming is a six-bus-cycle operation. 
-    // The erase command sequence is initiated by writing two unlock write cycles.
-    WriteCommand(busWidth, 
-                 NorFlash_GetByteAddressInChip(pNorFlashInfo, AMD_OFFSET_UNLOCK_1), 
-                 AMD_CMD_UNLOCK_1);
-    WriteCommand(busWidth, 
-                 NorFlash_GetByteAddressInChip(pNorFlashInfo, AMD_OFFSET_UNLOCK_2), 
-                 AMD_CMD_UNLOCK_2);
-    // Followed by the program set-up command.
-    WriteCommand(busWidth, 
-                 NorFlash_GetByteAddressInChip(pNorFlashInfo, AMD_OFFSET_UNLOCK_1),
-                 AMD_CMD_ERASE_SETUP);
-    // Two additional unlock cycles are written.
-    WriteCommand(busWidth, 
-                 NorFlash_GetByteAddressInChip(pNorFlashInfo, AMD_OFFSET_UNLOCK_1), 
-                 AMD_CMD_UNLOCK_1);
-    WriteCommand(busWidth, 
-                 NorFlash_GetByteAddressInChip(pNorFlashInfo, AMD_OFFSET_UNLOCK_2), 
-                 AMD_CMD_UNLOCK_2);
-        
-    // Followed by the address of the sector to be erased, and the sector erase command.
-    busAddress = NorFlash_GetAddressInChip(pNorFlashInfo,address);              
-    WriteCommand(busWidth, busAddress, AMD_CMD_ERASE_SECTOR);
+    busAddress = amd_EraseSectorCommand(pNorFlashInfo, address);
     
     // Data polling 
     do {
@@ -310,6 +412,99 @@ unsigned char AMD_EraseSector(
     return 0;
 }
 
+//------------------------------------------------------------------------------
+/// Starts erasing the specified block of the device without waiting for the
+/// operation to complete. Returns 0.
+/// \param pNorFlashInfo  Pointer to an NorFlashInfo instance.
+/// \param address Address offset to be erase.
+//------------------------------------------------------------------------------
+unsigned char AMD_EraseSectorStart(
+    struct NorFlashInfo *pNorFlashInfo, 
+    unsigned int address)
+{
+    amd_EraseSectorCommand(pNorFlashInfo, address);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/// Checks the progress of a sector erase started by AMD_EraseSectorStart().
+/// Returns NorCommon_ERROR_BUSY while the erase is running, 0 if it completed
+/// successfully; otherwise returns an error code.
+/// \param pNorFlashInfo  Pointer to an NorFlashInfo instance.
+/// \param address Address offset in the sector being erased.
+//------------------------------------------------------------------------------
+unsigned char AMD_EraseStatus(
+    struct NorFlashInfo *pNorFlashInfo, 
+    unsigned int address)
+{
+    unsigned int pollingData;
+    unsigned int busAddress;
+    unsigned char busWidth;
+    
+    busWidth = NorFlash_GetDataBusWidth(pNorFlashInfo);
+    busAddress = NorFlash_GetAddressInChip(pNorFlashInfo, address);
+    
+    ReadRawData(busWidth, busAddress, (unsigned char *)&pollingData);
+    // Check if the sector erase algorithm is completed.
+    if ((pollingData & AMD_POLLING_DQ7) == AMD_POLLING_DQ7 ) {
+        return 0;
+    }
+    // check if sector earse algrithm exceeded timing limits
+    if (pollingData & AMD_POLLING_DQ5 ) {
+    
+        // I/O should be rechecked.
+        ReadRawData(busWidth, busAddress, (unsigned char *)&pollingData);
+        if ((pollingData & AMD_POLLING_DQ7) == AMD_POLLING_DQ7 ){
+            return 0;
+        }
+        // Erase operation not successful, write reset command.
+        amd_Reset(pNorFlashInfo, 0);
+        return NorCommon_ERROR_CANNOTERASE;
+    }
+    return NorCommon_ERROR_BUSY;
+}
+
+//------------------------------------------------------------------------------
+/// Suspends a sector erase so that other sectors can be read. Waits until the
+/// device has entered the erase-suspend-read mode, signalled by DQ6 no longer
+/// toggling. Returns 0.
+/// \param pNorFlashInfo  Pointer to an NorFlashInfo instance.
+/// \param address Address offset in the sector being erased.
+//------------------------------------------------------------------------------
+unsigned char AMD_EraseSuspend(
+    struct NorFlashInfo *pNorFlashInfo, 
+    unsigned int address)
+{
+    unsigned int toggle1 = 0;
+    unsigned int toggle2 = 0;
+    unsigned int busAddress;
+    unsigned char busWidth;
+    
+    busWidth = NorFlash_GetDataBusWidth(pNorFlashInfo);
+    busAddress = NorFlash_GetAddressInChip(pNorFlashInfo, address);
+    
+    WriteCommand(busWidth, busAddress, AMD_CMD_ERASE_SUSPEND);
+    do {
+        ReadRawData(busWidth, busAddress, (unsigned char *)&toggle1);
+        ReadRawData(busWidth, busAddress, (unsigned char *)&toggle2);
+    } while ((toggle1 ^ toggle2) & AMD_POLLING_DQ6);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/// Resumes a sector erase suspended by AMD_EraseSuspend().
+/// \param pNorFlashInfo  Pointer to an NorFlashInfo instance.
+/// \param address Address offset in the sector being erased.
+//------------------------------------------------------------------------------
+void AMD_EraseResume(
+    struct NorFlashInfo *pNorFlashInfo, 
+    unsigned int address)
+{
+    WriteCommand(NorFlash_GetDataBusWidth(pNorFlashInfo), 
+                 NorFlash_GetAddressInChip(pNorFlashInfo, address),
+                 AMD_CMD_ERASE_RESUME);
+}
+
 //------------------------------------------------------------------------------
 /// Erases all the block of the device. Returns 0 if the operation was successful;
 /// otherwise returns an error code.
@@ -401,9 +596,32 @@ unsigned char AMD_Write_Data(
 {
     unsigned int i;
     unsigned char busWidth;
+    unsigned int bufferSize;
+    unsigned int count;
     busWidth = pNorFlashInfo->deviceChipWidth;
     
-    if (busWidth == FLASH_CHIP_WIDTH_8BITS ){ 
+    // Use buffered programming when the device reports a write buffer.
+    bufferSize = NorFlash_GetDeviceWriteBufferSize(pNorFlashInfo);
+    if (bufferSize > busWidth) {
+        size = (size + busWidth - 1) / busWidth;
+        while (size) {
+            // A buffer load must not cross a write-buffer page boundary.
+            count = (bufferSize - (address % bufferSize)) / busWidth;
+            if (count == 0) {
+                count = 1;
+            }
+            if (count > size) {
+                count = size;
+            }
+            if(amd_ProgramBuffer(pNorFlashInfo, address, buffer, count)) {
+                return NorCommon_ERROR_CANNOTWRITE;
+            }
+            address += count * busWidth;
+            buffer += count * busWidth;
+            size -= count;
+        }
+    }
+    else if (busWidth == FLASH_CHIP_WIDTH_8BITS ){ 
         for(i=0; i < size; i++) {
             if(amd_Program(pNorFlashInfo, address, buffer[i])) {
                 return NorCommon_ERROR_CANNOTWRITE;
@@ -47,11 +47,16 @@
 ///      Word at a time using static function amd_Program(). Programming 
 ///      larger amounts of data must be done in one Word at a time by 
 ///      giving a Program command, waiting for the command to complete, 
-///      giving the next Program command and so on.
+///      giving the next Program command and so on. When the CFI table
+///      reports a write buffer, up to a buffer page of Words is loaded and
+///      programmed at once using static function amd_ProgramBuffer().
 /// -# erase a block within the flash using AMD_EraseSector().
 ///    - Flash erase is performed on a block basis. An entire block is 
 ///      erased each time an erase command sequence is given. 
 /// -# erase whole blocks within the flash using AMD_EraseChip().
+/// -# AMD_EraseSectorStart() starts a block erase without waiting for it;
+///    its progress is checked with AMD_EraseStatus(), and it can be
+///    suspended and resumed with AMD_EraseSuspend() and AMD_EraseResume().
 /// -# AMD_Reset() function can be issued, between Bus Write cycles 
 ///    before the start of a program or erase operation, to return the 
 ///    device to read mode.
@@ -80,6 +85,22 @@ unsigned char AMD_EraseSector(
     
 unsigned char AMD_EraseChip(struct NorFlashInfo *pNorFlashInfo);
 
+unsigned char AMD_EraseSectorStart(
+    struct NorFlashInfo *pNorFlashInfo, 
+    unsigned int sectorAddr);
+
+unsigned char AMD_EraseStatus(
+    struct NorFlashInfo *pNorFlashInfo, 
+    unsigned int sectorAddr);
+
+unsigned char AMD_EraseSuspend(
+    struct NorFlashInfo *pNorFlashInfo, 
+    unsigned int sectorAddr);
+
+void AMD_EraseResume(
+    struct NorFlashInfo *pNorFlashInfo, 
+    unsigned int sectorAddr);
+
 unsigned char AMD_Write_Data(
     struct NorFlashInfo *pNorFlashInfo,
     unsigned int address,
@@ -92,7 +113,11 @@ const struct NorFlashOperations amdOperations = {
    AMD_ReadManufactoryId, 
    AMD_ReadDeviceID,
    AMD_EraseChip,
-   AMD_EraseSector
+   AMD_EraseSector,
+   AMD_EraseSectorStart,
+   AMD_EraseStatus,
+   AMD_EraseSuspend,
+   AMD_EraseResume
 };
 
 #endif //#ifndef NORFLASHAMD_H
@@ -79,6 +79,9 @@ unsigned char NORFLASH_EraseSector(
     struct NorFlash *pNorFlash, 
     unsigned int address)
 {
+    if (pNorFlash->eraseState != NORFLASH_ERASE_IDLE) {
+        return NorCommon_ERROR_BUSY;
+    }
     return ((pNorFlash->pOperations)->_fEraseSector)(&(pNorFlash->norFlashInfo), address);
 }
 
@@ -90,9 +93,103 @@ unsigned char NORFLASH_EraseSector(
 unsigned char NORFLASH_EraseChip(
     struct NorFlash *pNorFlash)
 {
+    if (pNorFlash->eraseState != NORFLASH_ERASE_IDLE) {
+        return NorCommon_ERROR_BUSY;
+    }
     return ((pNorFlash->pOperations)->_fEraseChip)(&(pNorFlash->norFlashInfo));
 }
 
+//------------------------------------------------------------------------------
+/// Starts erasing the specified block of the device and returns without
+/// waiting for completion. Returns 0 if the erase has been started; otherwise
+/// returns an error code.
+/// \param pNorFlash  Pointer to a NorFlash instance.
+/// \param address Address offset to be erase.
+//------------------------------------------------------------------------------
+unsigned char NORFLASH_EraseSectorStart(
+    struct NorFlash *pNorFlash, 
+    unsigned int address)
+{
+    unsigned int sector;
+    unsigned char error;
+
+    if (pNorFlash->eraseState != NORFLASH_ERASE_IDLE) {
+        return NorCommon_ERROR_BUSY;
+    }
+    sector = NorFlash_GetDeviceSectorInRegion(&(pNorFlash->norFlashInfo), address);
+    error = ((pNorFlash->pOperations)->_fEraseSectorStart)(&(pNorFlash->norFlashInfo), address);
+    if (error) {
+        return error;
+    }
+    pNorFlash->eraseAddress = NorFlash_GetDeviceSectorAddress(&(pNorFlash->norFlashInfo), sector);
+    pNorFlash->eraseSize = NorFlash_GetDeviceBlockSize(&(pNorFlash->norFlashInfo), sector);
+    pNorFlash->eraseState = NORFLASH_ERASE_BUSY;
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/// Polls the background erase started by NORFLASH_EraseSectorStart(). Returns
+/// NorCommon_ERROR_BUSY while the erase is running or suspended, 0 once it has
+/// completed successfully; otherwise returns an error code.
+/// \param pNorFlash  Pointer to a NorFlash instance.
+//------------------------------------------------------------------------------
+unsigned char NORFLASH_EraseStatus(
+    struct NorFlash *pNorFlash)
+{
+    unsigned char status;
+
+    if (pNorFlash->eraseState == NORFLASH_ERASE_IDLE) {
+        return 0;
+    }
+    if (pNorFlash->eraseState == NORFLASH_ERASE_SUSPENDED) {
+        return NorCommon_ERROR_BUSY;
+    }
+    status = ((pNorFlash->pOperations)->_fEraseStatus)(&(pNorFlash->norFlashInfo),
+                                                       pNorFlash->eraseAddress);
+    if (status != NorCommon_ERROR_BUSY) {
+        pNorFlash->eraseState = NORFLASH_ERASE_IDLE;
+    }
+    return status;
+}
+
+//------------------------------------------------------------------------------
+/// Suspends the background erase so that the other sectors of the device can
+/// be read. Returns 0 if the erase is suspended or already completed;
+/// otherwise returns an error code.
+/// \param pNorFlash  Pointer to a NorFlash instance.
+//------------------------------------------------------------------------------
+unsigned char NORFLASH_EraseSuspend(
+    struct NorFlash *pNorFlash)
+{
+    unsigned char error;
+
+    if (pNorFlash->eraseState != NORFLASH_ERASE_BUSY) {
+        return 0;
+    }
+    error = ((pNorFlash->pOperations)->_fEraseSuspend)(&(pNorFlash->norFlashInfo),
+                                                       pNorFlash->eraseAddress);
+    if (error) {
+        return error;
+    }
+    pNorFlash->eraseState = NORFLASH_ERASE_SUSPENDED;
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/// Resumes a background erase suspended by NORFLASH_EraseSuspend().
+/// \param pNorFlash  Pointer to a NorFlash instance.
+//------------------------------------------------------------------------------
+void NORFLASH_EraseResume(
+    struct NorFlash *pNorFlash)
+{
+    if (pNorFlash->eraseState != NORFLASH_ERASE_SUSPENDED) {
+        return;
+    }
+    ((pNorFlash->pOperations)->_fEraseResume)(&(pNorFlash->norFlashInfo),
+                                              pNorFlash->eraseAddress);
+    pNorFlash->eraseState = NORFLASH_ERASE_BUSY;
+}
+
 //------------------------------------------------------------------------------
 /// Sends data to the pNorFlash chip from the provided buffer.
 /// \param pNorFlash  Pointer to a NorFlash instance.
@@ -106,6 +203,9 @@ unsigned char NORFLASH_WriteData(
     unsigned char *buffer,
     unsigned int size)
 {
+    if (pNorFlash->eraseState != NORFLASH_ERASE_IDLE) {
+        return NorCommon_ERROR_BUSY;
+    }
     return ((pNorFlash->pOperations)->_fWriteData)(&(pNorFlash->norFlashInfo), address, buffer, size);
 }
 
@@ -124,6 +224,20 @@ unsigned char NORFLASH_ReadData(
     unsigned int busAddress;
     unsigned char busWidth;
     unsigned int i;
+    unsigned char suspended = 0;
+
+    // Reads are serviced mid-erase by suspending it, except inside the
+    // sector being erased.
+    if (pNorFlash->eraseState == NORFLASH_ERASE_BUSY) {
+        if ((address < pNorFlash->eraseAddress + pNorFlash->eraseSize)
+            && (address + size > pNorFlash->eraseAddress)) {
+            return NorCommon_ERROR_BUSY;
+        }
+        if (NORFLASH_EraseSuspend(pNorFlash)) {
+            return NorCommon_ERROR_CANNOTREAD;
+        }
+        suspended = 1;
+    }
     busWidth = NorFlash_GetDataBusWidth(&(pNorFlash->norFlashInfo));
     
     busAddress = NorFlash_GetAddressInChip(&(pNorFlash->norFlashInfo), address);
@@ -139,5 +253,8 @@ unsigned char NORFLASH_ReadData(
         busAddress+= (busWidth / 8);
 
     }
+    if (suspended) {
+        NORFLASH_EraseResume(pNorFlash);
+    }
     return 0;
 }
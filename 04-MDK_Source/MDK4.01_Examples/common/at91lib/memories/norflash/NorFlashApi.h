@@ -49,6 +49,12 @@
 ///    - Flash erase is performed on a block basis. An entire block is 
 ///      erased each time an erase command sequence is given. 
 /// -# erase whole blocks within the flash using NORFLASH_EraseChip().
+/// -# erase a block in the background using NORFLASH_EraseSectorStart(),
+///    then call NORFLASH_EraseStatus() from the main loop, a timer or the
+///    RY/BY# pin interrupt until it no longer returns NorCommon_ERROR_BUSY.
+///    NORFLASH_ReadData() suspends and resumes the erase by itself when
+///    reading outside the sector being erased; NORFLASH_EraseSuspend() and
+///    NORFLASH_EraseResume() can also be called directly.
 /// -# NORFLASH_Reset() function can be issued, between Bus Write cycles 
 ///    before the start of a program or erase operation, to return the 
 ///    device to read mode.
@@ -83,6 +89,14 @@ typedef unsigned int (*fReadDeviceID)(struct NorFlashInfo *);
 typedef unsigned char (*fEraseChip) (struct NorFlashInfo *);
 /// Erase single sector function.
 typedef unsigned char (*fEraseSector)(struct NorFlashInfo *, unsigned int );
+/// Start single sector erase function.
+typedef unsigned char (*fEraseSectorStart)(struct NorFlashInfo *, unsigned int );
+/// Poll sector erase status function.
+typedef unsigned char (*fEraseStatus)(struct NorFlashInfo *, unsigned int );
+/// Suspend sector erase function.
+typedef unsigned char (*fEraseSuspend)(struct NorFlashInfo *, unsigned int );
+/// Resume sector erase function.
+typedef void (*fEraseResume)(struct NorFlashInfo *, unsigned int );
 
 
 struct NorFlashOperations {
@@ -101,6 +115,14 @@ struct NorFlashOperations {
     unsigned char (*_fEraseChip) (struct NorFlashInfo *pNorFlashInfo);
     /// Erase single sector function.
     unsigned char (*_fEraseSector)(struct NorFlashInfo *pNorFlashInfo, unsigned int address);
+    /// Start single sector erase function.
+    unsigned char (*_fEraseSectorStart)(struct NorFlashInfo *pNorFlashInfo, unsigned int address);
+    /// Poll sector erase status function.
+    unsigned char (*_fEraseStatus)(struct NorFlashInfo *pNorFlashInfo, unsigned int address);
+    /// Suspend sector erase function.
+    unsigned char (*_fEraseSuspend)(struct NorFlashInfo *pNorFlashInfo, unsigned int address);
+    /// Resume sector erase function.
+    void (*_fEraseResume)(struct NorFlashInfo *pNorFlashInfo, unsigned int address);
 };
 
 //------------------------------------------------------------------------------
@@ -120,6 +142,19 @@ extern unsigned char NORFLASH_EraseSector(
 extern unsigned char NORFLASH_EraseChip(
     struct NorFlash *norFlash);
 
+extern unsigned char NORFLASH_EraseSectorStart(
+    struct NorFlash *norFlash, 
+    unsigned int sectorAddr);
+
+extern unsigned char NORFLASH_EraseStatus(
+    struct NorFlash *norFlash);
+
+extern unsigned char NORFLASH_EraseSuspend(
+    struct NorFlash *norFlash);
+
+extern void NORFLASH_EraseResume(
+    struct NorFlash *norFlash);
+
 extern unsigned char NORFLASH_WriteData(
     struct NorFlash *norFlash,
     unsigned int address,
@@ -324,6 +324,23 @@ unsigned long  NorFlash_GetDeviceSizeInBytes(
     return ((unsigned long) 2 << ((pNorFlashInfo->cfiDescription.norFlashCfiDeviceGeometry.deviceSize) - 1));
 }
 
+//------------------------------------------------------------------------------
+/// Returns the size in bytes of the device write buffer, or 0 if the device
+/// does not support buffered programming.
+/// \param pNorFlashInfo  Pointer to a NorFlashInfo instance.
+//------------------------------------------------------------------------------
+unsigned int NorFlash_GetDeviceWriteBufferSize(
+   struct NorFlashInfo *pNorFlashInfo)
+{
+    unsigned short numMultiWrite;
+
+    numMultiWrite = pNorFlashInfo->cfiDescription.norFlashCfiDeviceGeometry.numMultiWrite;
+    if ((numMultiWrite == 0) || (numMultiWrite > 15)) {
+        return 0;
+    }
+    return (1 << numMultiWrite);
+}
+
 //------------------------------------------------------------------------------
 /// Looks for query struct in Norflash common flash interface.
 /// If found, the model variable is filled with the correct values.
@@ -341,8 +358,10 @@ unsigned char NorFlash_CFI_Detect(
     
     pNorFlash->norFlashInfo.cfiCompatible = 0;
     pNorFlash->norFlashInfo.deviceChipWidth = hardwareBusWidth;
+    pNorFlash->eraseState = NORFLASH_ERASE_IDLE;
     address = CFI_QUERY_OFFSET;
-    for(i = 0; i< sizeof(struct NorFlashInfo) ; i++){
+    // Only fill the CFI description, the fields after it must be preserved
+    for(i = 0; i< sizeof(struct NorFlashCFI) ; i++){
         WriteCommand(8, NorFlash_GetByteAddressInChip(&(pNorFlash->norFlashInfo), CFI_QUERY_ADDRESS), CFI_QUERY_COMMAND);
         ReadRawData(8, NorFlash_GetByteAddressInChip(&(pNorFlash->norFlashInfo), address), pCfi);
         address++;
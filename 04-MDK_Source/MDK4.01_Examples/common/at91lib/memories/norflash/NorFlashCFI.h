@@ -66,6 +66,13 @@
 /// Indicates the NorFlash uses an 64-bit address bus.
 #define FLASH_CHIP_WIDTH_64BITS 0x08
 
+/// No background erase operation is pending.
+#define NORFLASH_ERASE_IDLE      0
+/// A background sector erase is in progress.
+#define NORFLASH_ERASE_BUSY      1
+/// A background sector erase has been suspended.
+#define NORFLASH_ERASE_SUSPENDED 2
+
 //------------------------------------------------------------------------------
 //        Local Type
 //------------------------------------------------------------------------------
@@ -180,6 +187,12 @@ struct NorFlashInfo {
 struct NorFlash {
    const struct NorFlashOperations *pOperations;
    struct NorFlashInfo norFlashInfo;
+   /// State of the background erase (NORFLASH_ERASE_xxx).
+   unsigned char eraseState;
+   /// Start address offset of the sector being erased.
+   unsigned int eraseAddress;
+   /// Size in bytes of the sector being erased.
+   unsigned int eraseSize;
 };
 
 //------------------------------------------------------------------------------
@@ -226,5 +239,8 @@ unsigned char NorFlash_GetDataBusWidth(
 unsigned long  NorFlash_GetDeviceSizeInBytes(
    struct NorFlashInfo *pNorFlashInfo);
 
+unsigned int NorFlash_GetDeviceWriteBufferSize(
+   struct NorFlashInfo *pNorFlashInfo);
+
 #endif //#ifndef NORFLASHCFI_H
 
@@ -80,6 +80,9 @@
 /// A locked operation cannot be carried out.
 #define NorCommon_ERROR_PROTECT            5
 
+/// An erase operation is still in progress.
+#define NorCommon_ERROR_BUSY               6
+
 //------------------------------------------------------------------------------
 //         Exported functions
 //------------------------------------------------------------------------------
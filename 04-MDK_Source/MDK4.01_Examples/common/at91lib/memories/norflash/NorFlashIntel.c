@@ -52,6 +52,10 @@
 #define INTEL_CMD_BLOCK_LOCKDOWN   0x002F
 #define INTEL_CMD_PROGRAM_WORD     0x0010
 #define INTEL_CMD_RESET            0x00FF
+#define INTEL_CMD_WRITE_BUFFER     0x00E8
+#define INTEL_CMD_WRITE_CONFIRM    0x00D0
+#define INTEL_CMD_SUSPEND          0x00B0
+#define INTEL_CMD_RESUME           0x00D0
 
 
 /// Intel norflash status resgister
@@ -248,6 +252,110 @@ unsigned char intel_Program(
     return 0;
 }
 
+//------------------------------------------------------------------------------
+/// It implements a buffered program command. The words must all lie in the
+/// same write-buffer page of the device. Returns 0 if the operation was
+/// successful; otherwise returns an error code.
+/// \param pNorFlashInfo  Pointer to an struct NorFlashInfo instance.
+/// \param address Start address offset to be wrote.
+/// \param buffer Buffer where the data is stored.
+/// \param count Number of words to be written.
+//------------------------------------------------------------------------------
+unsigned char intel_ProgramBuffer(
+    struct NorFlashInfo *pNorFlashInfo,
+    unsigned int address,
+    unsigned char *buffer,
+    unsigned int count)
+{
+    unsigned int status;
+    unsigned int blockAddress;
+    unsigned int busAddress;
+    unsigned int i;
+    unsigned char done = 0;
+    unsigned char busWidth;
+    unsigned char chipWidth;
+
+    busWidth = NorFlash_GetDataBusWidth(pNorFlashInfo);
+    chipWidth = pNorFlashInfo->deviceChipWidth;
+     // Issue Read Array Command - just in case that the flash is not in Read Array mode 
+    intel_Reset(pNorFlashInfo, address);
+    intel_ClearStatus(pNorFlashInfo);
+
+    blockAddress = NorFlash_GetAddressInChip(pNorFlashInfo, address);
+    // Buffered programming is initiated by writing the Buffered Program Setup
+    // command, repeated until the status register reports the buffer available.
+    do {
+        WriteCommand(busWidth, blockAddress, INTEL_CMD_WRITE_BUFFER);
+        status = 0;
+        ReadRawData(busWidth, blockAddress, (unsigned char*)&status);
+    } while ((status & INTEL_STATUS_DWS) != INTEL_STATUS_DWS);
+
+    // The number of words to be written minus one is written next.
+    WriteCommand(busWidth, blockAddress, count - 1);
+
+    // Followed by the address and data of each word.
+    busAddress = blockAddress;
+    for (i = 0; i < count; i++) {
+        WriteRawData(busWidth, busAddress, buffer);
+        busAddress += chipWidth;
+        buffer += chipWidth;
+    }
+
+    // The Buffered Program Confirm command starts programming the array.
+    WriteCommand(busWidth, blockAddress, INTEL_CMD_WRITE_CONFIRM);
+
+    // Status register polling 
+    do {
+        status = intel_ReadStatus(pNorFlashInfo, address);
+        // Check if the device is ready.
+        if ((status & INTEL_STATUS_DWS) == INTEL_STATUS_DWS ) {
+            // check if VPP within acceptable limits, program failed or block locked.
+            if (status & (INTEL_STATUS_VPPS | INTEL_STATUS_PS | INTEL_STATUS_BLS)) {
+                intel_ClearStatus(pNorFlashInfo);
+                intel_Reset(pNorFlashInfo, address);
+                return NorCommon_ERROR_CANNOTWRITE;
+            }
+            done = 1;
+        }
+    } while (!done);
+
+    intel_ClearStatus(pNorFlashInfo);
+    intel_Reset(pNorFlashInfo, address);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/// Unlocks the specified block if needed and issues the block erase command
+/// sequence, without waiting for the erase to complete.
+/// \param pNorFlashInfo  Pointer to an struct NorFlashInfo instance.
+/// \param address Address offset to be erase.
+//------------------------------------------------------------------------------
+void intel_EraseSectorCommand(
+    struct NorFlashInfo *pNorFlashInfo, 
+    unsigned int address)
+{
+    unsigned int status;
+    unsigned int busAddress;
+    unsigned char busWidth;
+    
+    busWidth = NorFlash_GetDataBusWidth(pNorFlashInfo);
+     // Issue Read Array Command - just in case that the flash is not in Read Array mode 
+    intel_Reset(pNorFlashInfo, address);    
+   
+    // Check the lock status is locked.
+    status = intel_GetBlockLockStatus(pNorFlashInfo, address);
+    if(( status & INTEL_LOCKSTATUS_LOCKED ) == INTEL_LOCKSTATUS_LOCKED){
+        intel_UnlockSector(pNorFlashInfo, address);
+    }
+    // Clear the status register first.
+    intel_ClearStatus(pNorFlashInfo);
+    busAddress = NorFlash_GetAddressInChip(pNorFlashInfo,address);
+    // Block erase operations are initiated by writing the Block Erase Setup command to the address of the block to be erased.
+    WriteCommand(busWidth, busAddress, INTEL_CMD_BLOCK_ERASE_1);
+    // Next, the Block Erase Confirm command is written to the address of the block to be erased.
+    WriteCommand(busWidth, busAddress, INTEL_CMD_BLOCK_ERASE_2);
+}
+
 //------------------------------------------------------------------------------
 //         Exported functions
 //------------------------------------------------------------------------------
@@ -291,26 +399,9 @@ unsigned char INTEL_EraseSector(
     unsigned int address)
 {
     unsigned int status;
-    unsigned int busAddress;
-    unsigned char busWidth;
     unsigned char done = 0;
     
-    busWidth = NorFlash_GetDataBusWidth(pNorFlashInfo);
-     // Issue Read Array Command - just in case that the flash is not in Read Array mode 
-    intel_Reset(pNorFlashInfo, address);    
-   
-    // Check the lock status is locked.
-    status = intel_GetBlockLockStatus(pNorFlashInfo, address);
-    if(( status & INTEL_LOCKSTATUS_LOCKED ) == INTEL_LOCKSTATUS_LOCKED){
-        intel_UnlockSector(pNorFlashInfo, address);
-    }
-    // Clear the status register first.
-    intel_ClearStatus(pNorFlashInfo);
-    busAddress = NorFlash_GetAddressInChip(pNorFlashInfo,address);
-    // Block erase operations are initiated by writing the Block Erase Setup command to the address of the block to be erased.
-    WriteCommand(busWidth, busAddress, INTEL_CMD_BLOCK_ERASE_1);
-    // Next, the Block Erase Confirm command is written to the address of the block to be erased.
-    WriteCommand(busWidth, busAddress, INTEL_CMD_BLOCK_ERASE_2);
+    intel_EraseSectorCommand(pNorFlashInfo, address);
     // Status register polling 
     do {
         status = intel_ReadStatus(pNorFlashInfo,address);
@@ -346,6 +437,85 @@ unsigned char INTEL_EraseSector(
     return 0;
 }
 
+//------------------------------------------------------------------------------
+/// Starts erasing the specified block of the device without waiting for the
+/// operation to complete. Returns 0.
+/// \param pNorFlashInfo  Pointer to an struct NorFlashInfo instance.
+/// \param address Address offset to be erase.
+//------------------------------------------------------------------------------
+unsigned char INTEL_EraseSectorStart(
+    struct NorFlashInfo *pNorFlashInfo, 
+    unsigned int address)
+{
+    intel_EraseSectorCommand(pNorFlashInfo, address);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/// Checks the progress of a block erase started by INTEL_EraseSectorStart().
+/// Returns NorCommon_ERROR_BUSY while the erase is running, 0 if it completed
+/// successfully; otherwise returns an error code.
+/// \param pNorFlashInfo  Pointer to an struct NorFlashInfo instance.
+/// \param address Address offset in the block being erased.
+//------------------------------------------------------------------------------
+unsigned char INTEL_EraseStatus(
+    struct NorFlashInfo *pNorFlashInfo, 
+    unsigned int address)
+{
+    unsigned int status;
+    
+    status = intel_ReadStatus(pNorFlashInfo, address);
+    // Check if the device is ready.
+    if ((status & INTEL_STATUS_DWS) != INTEL_STATUS_DWS ) {
+        return NorCommon_ERROR_BUSY;
+    }
+    // check VPP range, erase error or block locked during the operation.
+    if (status & (INTEL_STATUS_VPPS | INTEL_STATUS_PS | INTEL_STATUS_ES | INTEL_STATUS_BLS)) {
+        intel_ClearStatus(pNorFlashInfo);
+        intel_Reset(pNorFlashInfo, 0);
+        return NorCommon_ERROR_CANNOTERASE;
+    }
+    intel_Reset(pNorFlashInfo, address);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/// Suspends a block erase so that other blocks can be read. Waits until the
+/// device is ready and leaves it in read array mode. Returns 0.
+/// \param pNorFlashInfo  Pointer to an struct NorFlashInfo instance.
+/// \param address Address offset in the block being erased.
+//------------------------------------------------------------------------------
+unsigned char INTEL_EraseSuspend(
+    struct NorFlashInfo *pNorFlashInfo, 
+    unsigned int address)
+{
+    unsigned int status;
+    
+    WriteCommand(NorFlash_GetDataBusWidth(pNorFlashInfo), 
+                 NorFlash_GetAddressInChip(pNorFlashInfo, address),
+                 INTEL_CMD_SUSPEND);
+    // The erase is suspended (ESS set) or already completed once DWS is set.
+    do {
+        status = intel_ReadStatus(pNorFlashInfo, address);
+    } while ((status & INTEL_STATUS_DWS) != INTEL_STATUS_DWS);
+    intel_Reset(pNorFlashInfo, address);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/// Resumes a block erase suspended by INTEL_EraseSuspend().
+/// \param pNorFlashInfo  Pointer to an struct NorFlashInfo instance.
+/// \param address Address offset in the block being erased.
+//------------------------------------------------------------------------------
+void INTEL_EraseResume(
+    struct NorFlashInfo *pNorFlashInfo, 
+    unsigned int address)
+{
+    WriteCommand(NorFlash_GetDataBusWidth(pNorFlashInfo), 
+                 NorFlash_GetAddressInChip(pNorFlashInfo, address),
+                 INTEL_CMD_RESUME);
+}
+
 //------------------------------------------------------------------------------
 /// Erases all the block of the device. Returns 0 if the operation was successful;
 /// otherwise returns an error code.
@@ -381,9 +551,33 @@ unsigned char INTEL_Write_Data(
 {
     unsigned int i;
     unsigned char busWidth;
+    unsigned int bufferSize;
+    unsigned int count;
     
     busWidth = pNorFlashInfo->deviceChipWidth;
-    if (busWidth == FLASH_CHIP_WIDTH_8BITS ){ 
+    
+    // Use buffered programming when the device reports a write buffer.
+    bufferSize = NorFlash_GetDeviceWriteBufferSize(pNorFlashInfo);
+    if (bufferSize > busWidth) {
+        size = (size + busWidth - 1) / busWidth;
+        while (size) {
+            // A buffer load must not cross a write-buffer page boundary.
+            count = (bufferSize - (address % bufferSize)) / busWidth;
+            if (count == 0) {
+                count = 1;
+            }
+            if (count > size) {
+                count = size;
+            }
+            if(intel_ProgramBuffer(pNorFlashInfo, address, buffer, count)) {
+                return NorCommon_ERROR_CANNOTWRITE;
+            }
+            address += count * busWidth;
+            buffer += count * busWidth;
+            size -= count;
+        }
+    }
+    else if (busWidth == FLASH_CHIP_WIDTH_8BITS ){ 
         for(i=0; i < size; i++) {
             if(intel_Program(pNorFlashInfo, address, buffer[i])) {
                 return NorCommon_ERROR_CANNOTWRITE;
@@ -47,11 +47,16 @@
 ///      Word at a time using static function intel_Program(). Programming 
 ///      larger amounts of data must be done in one Word at a time by 
 ///      giving a Program command, waiting for the command to complete, 
-///      giving the next Program command and so on.
+///      giving the next Program command and so on. When the CFI table
+///      reports a write buffer, up to a buffer page of Words is loaded and
+///      programmed at once using static function intel_ProgramBuffer().
 /// -# erase a block within the flash using INTEL_EraseSector().
 ///    - Flash erase is performed on a block basis. An entire block is 
 ///      erased each time an erase command sequence is given. 
 /// -# erase whole blocks within the flash using INTEL_EraseChip().
+/// -# INTEL_EraseSectorStart() starts a block erase without waiting for it;
+///    its progress is checked with INTEL_EraseStatus(), and it can be
+///    suspended and resumed with INTEL_EraseSuspend() and INTEL_EraseResume().
 /// -# INTEL_Reset() function can be issued, between Bus Write cycles 
 ///    before the start of a program or erase operation, to return the 
 ///    device to read mode.
@@ -78,6 +83,22 @@ unsigned char INTEL_EraseSector(
     unsigned int sectorAddr);
 
 unsigned char INTEL_EraseChip(struct NorFlashInfo *NorFlashInfo);
+
+unsigned char INTEL_EraseSectorStart(
+    struct NorFlashInfo *NorFlashInfo, 
+    unsigned int sectorAddr);
+
+unsigned char INTEL_EraseStatus(
+    struct NorFlashInfo *NorFlashInfo, 
+    unsigned int sectorAddr);
+
+unsigned char INTEL_EraseSuspend(
+    struct NorFlashInfo *NorFlashInfo, 
+    unsigned int sectorAddr);
+
+void INTEL_EraseResume(
+    struct NorFlashInfo *NorFlashInfo, 
+    unsigned int sectorAddr);
     
 unsigned char INTEL_Write_Data(
     struct NorFlashInfo *NorFlashInfo,
@@ -91,8 +112,11 @@ const struct NorFlashOperations intelOperations = {
    INTEL_ReadManufactoryId, 
    INTEL_ReadDeviceID,
    INTEL_EraseChip,
-   INTEL_EraseSector
-   
+   INTEL_EraseSector,
+   INTEL_EraseSectorStart,
+   INTEL_EraseStatus,
+   INTEL_EraseSuspend,
+   INTEL_EraseResume
 };
 
 #endif //#ifndef NORFLASHINTEL_H
@@ -48,6 +48,17 @@
                          SPID_CSR_DLYBS(BOARD_MCK, 5) | \
                          SPID_CSR_SCBR(BOARD_MCK, SPCK))
 
+/// SPI clock frequency used once the device has been recognized, in Hz. This
+/// is the highest FAST READ clock supported by all the devices listed below.
+#define SPCK_FAST       33000000
+
+/// SPI chip select configuration value once the device has been recognized:
+/// no delay between consecutive transfers, SCBR rounded up so that SPCK_FAST
+/// is never exceeded.
+#define CSR_FAST        (AT91C_SPI_NCPHA | \
+                         SPID_CSR_DLYBS(BOARD_MCK, 5) | \
+                         SPID_CSR_SCBR(BOARD_MCK + SPCK_FAST - 1, SPCK_FAST))
+
 /// Number of recognized dataflash.
 #define NUMDATAFLASH    (sizeof(at26Devices) / sizeof(At26Desc))
 
@@ -195,6 +206,8 @@ unsigned char AT26_SendCommand(
 //------------------------------------------------------------------------------
 /// Tries to detect a serial firmware flash device given its JEDEC identifier.
 /// The JEDEC id can be retrieved by sending the correct command to the device.
+/// Once a device is recognized, the chip select is reconfigured for the
+/// SPCK_FAST clock.
 /// Returns the corresponding AT26 descriptor if found; otherwise returns 0.
 /// \param pAt26  Pointer to an AT26 driver instance.
 /// \param jedecId  JEDEC identifier of device.
@@ -217,6 +230,12 @@ const At26Desc * AT26_FindDevice(At26 *pAt26, unsigned int jedecId)
         i++;
     }
 
+    // Switch to the maximum SPI clock
+    if (pAt26->pDesc) {
+
+        SPID_ConfigureCS(pAt26->pSpid, pAt26->command.spiCs, CSR_FAST);
+    }
+
     return pAt26->pDesc;
 }
 
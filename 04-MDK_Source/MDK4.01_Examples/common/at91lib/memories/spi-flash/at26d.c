@@ -95,6 +95,26 @@ static void AT26D_WriteStatus(At26 *pAt26, unsigned char status)
 }
 
 
+//------------------------------------------------------------------------------
+/// Waits for the serial flash device to become ready and returns the last
+/// status register value read, so that the result of the operation can be
+/// checked without issuing another status read.
+/// \param pAt26  Pointer to an AT26 driver instance.
+//------------------------------------------------------------------------------
+static unsigned char AT26D_WaitReadyStatus(At26 *pAt26)
+{
+    unsigned char status;
+
+    // Read status register and check busy bit
+    do {
+
+        status = AT26D_ReadStatus(pAt26);
+    }
+    while ((status & AT26_STATUS_RDYBSY) != AT26_STATUS_RDYBSY_READY);
+
+    return status;
+}
+
 //------------------------------------------------------------------------------
 //         Global functions
 //------------------------------------------------------------------------------
@@ -105,15 +125,9 @@ static void AT26D_WriteStatus(At26 *pAt26, unsigned char status)
 //------------------------------------------------------------------------------
 void AT26D_WaitReady(At26 *pAt26)
 {
-    unsigned char ready = 0;
-
     SANITY_CHECK(pAt26);
 
-    // Read status register and check busy bit
-    while (!ready) {
-
-        ready = ((AT26D_ReadStatus(pAt26) & AT26_STATUS_RDYBSY) == AT26_STATUS_RDYBSY_READY);
-    }
+    AT26D_WaitReadyStatus(pAt26);
 }
 
 //------------------------------------------------------------------------------
@@ -275,6 +289,9 @@ unsigned char AT26D_EraseBlock(At26 *pAt26, unsigned int address)
 /// Writes data at the specified address on the serial firmware dataflash. The
 /// page(s) to program must have been erased prior to writing. This function
 /// handles page boundary crossing automatically.
+/// A page program is not waited for once issued: the device is only polled
+/// when the next page has to be sent, and the status read that reports the
+/// end of the program also gives its erase/program error bit.
 /// Returns 0 if successful; otherwise, returns AT26_ERROR_PROGRAM is there has
 /// been an error during the data programming.
 /// \param pAt26  Pointer to an AT26 driver instance.
@@ -292,6 +309,7 @@ unsigned char AT26D_Write(
     unsigned int writeSize;
     unsigned char error;
     unsigned char status;
+    unsigned char programming = 0;
 
     SANITY_CHECK(pAt26);
     SANITY_CHECK(pData);
@@ -304,6 +322,16 @@ unsigned char AT26D_Write(
         // Compute number of bytes to program in page
         writeSize = min(size, pageSize - (address % pageSize));
 
+        // Wait for the previous page program and make sure it was without error
+        if (programming) {
+
+            status = AT26D_WaitReadyStatus(pAt26);
+            if ((status & AT26_STATUS_EPE) == AT26_STATUS_EPE_ERROR) {
+
+                return AT26_ERROR_PROGRAM;
+            }
+        }
+
         // Enable critical write operation
         AT26D_EnableWrite(pAt26);
      
@@ -311,27 +339,31 @@ unsigned char AT26D_Write(
           error = AT26_SendCommand(pAt26, AT26_BYTE_PAGE_PROGRAM, 4,
                            pData, writeSize, address, 0, 0);
         ASSERT(!error, "-F- AT26_WritePage: Failed to issue command.\n\r");
+        pData += writeSize;
+        size -= writeSize;
+        address += writeSize;
         // Wait for transfer to finish
         AT26D_Wait(pAt26);
-        // Poll the Serial flash status register until the operation is achieved
-        AT26D_WaitReady(pAt26);
+        programming = 1;
+    }
 
-        // Make sure that write was without error
-        status = AT26D_ReadStatus(pAt26);
+    // Wait for the last page program and make sure it was without error
+    if (programming) {
+
+        status = AT26D_WaitReadyStatus(pAt26);
         if ((status & AT26_STATUS_EPE) == AT26_STATUS_EPE_ERROR) {
 
             return AT26_ERROR_PROGRAM;
         }
-        pData += writeSize;
-        size -= writeSize;
-        address += writeSize;
     }
 
     return 0;
 }
 
 //------------------------------------------------------------------------------
-/// Reads data from the specified address on the serial flash.
+/// Reads data from the specified address on the serial flash, using the FAST
+/// READ command. Reads of any length are performed as a single command, the
+/// SPI driver chaining the data through the PDC.
 /// \param pAt26  Pointer to an AT26 driver instance.
 /// \param pData  Data buffer.
 /// \param size  Number of bytes to read.
@@ -346,7 +378,7 @@ unsigned char AT26D_Read(
     unsigned char error;
     
      // Start a read operation
-      error = AT26_SendCommand(pAt26, AT26_READ_ARRAY_LF, 4, pData, size, address, 0, 0);
+      error = AT26_SendCommand(pAt26, AT26_READ_ARRAY, 5, pData, size, address, 0, 0);
     ASSERT(!error, "-F- AT26_Read: Could not issue command.\n\r");
     // Wait for transfer to finish
     AT26D_Wait(pAt26);
@@ -34,6 +34,7 @@
 #include "at45.h"
 #include "at45d.h"
 #include <board.h>
+#include <utility/math.h>
 #include <utility/assert.h>
 
 //------------------------------------------------------------------------------
@@ -56,6 +57,36 @@ static void AT45D_Wait(At45 *pAt45)
     }
 }
 
+//------------------------------------------------------------------------------
+/// Sends a command to the At45 and waits for the end of the SPI transfer
+/// (not for the At45 to become ready).
+/// \param pAt45  Pointer to an AT45 driver instance.
+/// \param cmd  Command code.
+/// \param cmdSize  Size of command code + address bytes + dummy bytes.
+/// \param pData  Data buffer.
+/// \param dataSize  Number of data bytes to send/receive.
+/// \param address  Address at which the command is performed if meaningful.
+//------------------------------------------------------------------------------
+static void AT45D_Command(
+    At45 *pAt45,
+    unsigned char cmd,
+    unsigned char cmdSize,
+    unsigned char *pData,
+    unsigned int dataSize,
+    unsigned int address)
+{
+    unsigned char error;
+
+    error = AT45_SendCommand(pAt45, cmd, cmdSize, pData, dataSize, address, 0, 0);
+    ASSERT(!error, "-F- AT45_Command: Could not issue command.\n\r");
+
+    // Wait until the command is sent
+    while (AT45_IsBusy(pAt45)) {
+    
+        AT45D_Wait(pAt45);
+    }
+}
+
 
 //------------------------------------------------------------------------------
 //         Global functions
@@ -170,6 +201,95 @@ void AT45D_Write(
     AT45D_WaitReady(pAt45);
 }
 
+//------------------------------------------------------------------------------
+/// Writes any number of pages on the At45, starting at the specified address.
+/// The two SRAM buffers of the device are used alternately: while one buffer
+/// is being programmed into main memory, the next page is sent into the other
+/// one, and the At45 is only polled before starting the next page program.
+/// The first and last pages may be partial; their other bytes are preserved
+/// by loading the page into the buffer first.
+/// \param pAt45  Pointer to a At45 driver instance.
+/// \param pBuffer  Buffer containing the data to write.
+/// \param size  Number of bytes to write.
+/// \param address  Destination address on the At45.
+//------------------------------------------------------------------------------
+void AT45D_WriteStream(
+    At45 *pAt45,
+    unsigned char *pBuffer,
+    unsigned int size,
+    unsigned int address)
+{
+    unsigned int pageSize;
+    unsigned int writeSize;
+    unsigned char buffer = 0;
+
+    SANITY_CHECK(pAt45);
+    SANITY_CHECK(pBuffer);
+
+    pageSize = AT45_PageSize(pAt45);
+
+    while (size > 0) {
+
+        // Compute number of bytes to program in page
+        writeSize = min(size, pageSize - (address % pageSize));
+
+        // A partial page is merged with the page content, which can only be
+        // loaded once the previous page program is over
+        if (writeSize < pageSize) {
+
+            AT45D_WaitReady(pAt45);
+            AT45D_Command(pAt45, buffer ? AT45_PAGE_BUF2_TX : AT45_PAGE_BUF1_TX,
+                          4, 0, 0, address);
+            AT45D_WaitReady(pAt45);
+        }
+
+        // Fill the buffer, the other one may still be programming
+        AT45D_Command(pAt45, buffer ? AT45_BUF2_WRITE : AT45_BUF1_WRITE,
+                      4, pBuffer, writeSize, address);
+
+        // Program the buffer into main memory once the device is ready
+        AT45D_WaitReady(pAt45);
+        AT45D_Command(pAt45, buffer ? AT45_BUF2_MEM_ERASE : AT45_BUF1_MEM_ERASE,
+                      4, 0, 0, address);
+
+        buffer ^= 1;
+        pBuffer += writeSize;
+        size -= writeSize;
+        address += writeSize;
+    }
+
+    // Wait for the last page program
+    AT45D_WaitReady(pAt45);
+}
+
+//------------------------------------------------------------------------------
+/// Reads any amount of data from the At45 using the high frequency continuous
+/// array read command. The whole read is performed as a single command, the
+/// SPI driver chaining the data through the PDC.
+/// \param pAt45  Pointer to a At45 driver instance.
+/// \param pBuffer  Data buffer.
+/// \param size  Number of bytes to read.
+/// \param address  Address at which data shall be read.
+//------------------------------------------------------------------------------
+void AT45D_ReadStream(
+    At45 *pAt45,
+    unsigned char *pBuffer,
+    unsigned int size,
+    unsigned int address)
+{
+    unsigned char cmdSize;
+
+    SANITY_CHECK(pAt45);
+    SANITY_CHECK(pBuffer);
+
+    // Command code, address bytes and one dummy byte
+    cmdSize = (AT45_PageNumber(pAt45) >= 16384) ? 6 : 5;
+
+    // Wait for a previous write to complete
+    AT45D_WaitReady(pAt45);
+    AT45D_Command(pAt45, AT45_CONTINUOUS_READ, cmdSize, pBuffer, size, address);
+}
+
 //------------------------------------------------------------------------------
 /// Erases a page of data at the given address in the At45.
 /// \param pAt45  Pointer to a At45 driver instance.
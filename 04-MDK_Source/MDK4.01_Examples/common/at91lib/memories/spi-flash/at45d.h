@@ -42,6 +42,9 @@
 /// 
 /// -# Reads data from the At45 at the specified address using AT45D_Read().
 /// -# Writes data on the At45 at the specified address using AT45D_Write().
+/// -# Writes several pages using both SRAM buffers alternately with
+///    AT45D_WriteStream(), and reads them back in a single continuous array
+///    read with AT45D_ReadStream().
 /// -# Erases a page of data at the given address using AT45D_Erase().
 /// -# Poll until the At45 has completed of corresponding operations using 
 ///    AT45D_WaitReady().
@@ -78,6 +81,18 @@ extern void AT45D_Write(
     unsigned int size,
     unsigned int address); 
 
+extern void AT45D_WriteStream(
+    At45 *pAt45,
+    unsigned char *pBuffer,
+    unsigned int size,
+    unsigned int address);
+
+extern void AT45D_ReadStream(
+    At45 *pAt45,
+    unsigned char *pBuffer,
+    unsigned int size,
+    unsigned int address);
+
 extern void AT45D_Erase(At45 *pAt45, unsigned int address);
 
 extern void AT45D_BinaryPage(At45 *pAt45);
@@ -0,0 +1,1002 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support 
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2008, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * ----------------------------------------------------------------------------
+ */
+
+//------------------------------------------------------------------------------
+//         Headers
+//------------------------------------------------------------------------------
+
+#include "kvstore.h"
+#include "at45d.h"
+#include "at26d.h"
+#include <utility/assert.h>
+#include <utility/trace.h>
+#include <utility/math.h>
+
+#include <string.h>
+
+//------------------------------------------------------------------------------
+//         Internal definitions
+//------------------------------------------------------------------------------
+
+/// Marker found at the start of every sector holding log data ("KVS1").
+#define KVS_MAGIC               0x3153564B
+
+/// Size of the sector and record headers.
+#define KVS_HEADERSIZE          8
+
+/// Number of free sectors kept for compaction.
+#define KVS_RESERVEDSECTORS     1
+
+/// KVS_Compact() reclaims a sector when there are this many free sectors left.
+#define KVS_COMPACTTHRESHOLD    (KVS_RESERVEDSECTORS + 1)
+
+/// Number of AT45 pages in a sector (one AT45 block).
+#define KVS_AT45BLOCKPAGES      8
+
+/// Returns the size of a record holding the given value size.
+#define KVS_RECORDSIZE(size)    ((KVS_HEADERSIZE + (size) + 3) & ~3)
+
+/// Returns the address of a sector.
+#define KVS_SECTORADDRESS(pKvs, sector) \
+    ((pKvs)->baseAddress + (sector) * (pKvs)->sectorSize)
+
+//------------------------------------------------------------------------------
+//         Internal types
+//------------------------------------------------------------------------------
+
+/// Header at the start of a sector holding log data.
+typedef struct {
+
+    /// KVS_MAGIC.
+    unsigned int magic;
+    /// Order of the sector in the log.
+    unsigned int sequence;
+
+} KvsSectorHeader;
+
+/// Header of a record, followed by the value. A record with a size of 0
+/// indicates the key has been deleted.
+typedef struct {
+
+    /// Record key.
+    unsigned short key;
+    /// Value size in bytes.
+    unsigned short size;
+    /// Complement of the size, to detect an incompletely written header.
+    unsigned short check;
+    /// CRC of the key, size and value.
+    unsigned short crc;
+
+} KvsRecordHeader;
+
+//------------------------------------------------------------------------------
+//         Local functions
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/// Computes the CRC-16 (CCITT polynomial) of a buffer.
+/// \param crc  Initial CRC value.
+/// \param pData  Data buffer.
+/// \param size  Number of bytes in buffer.
+//------------------------------------------------------------------------------
+static unsigned short KVS_Crc(
+    unsigned short crc,
+    const unsigned char *pData,
+    unsigned int size)
+{
+    unsigned char i;
+
+    while (size--) {
+
+        crc ^= (*pData++) << 8;
+        for (i = 0; i < 8; i++) {
+
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+//------------------------------------------------------------------------------
+/// Returns the CRC of the record held in the record buffer.
+/// \param pKvs  Pointer to a Kvs instance.
+/// \param pHeader  Record header.
+//------------------------------------------------------------------------------
+static unsigned short KVS_RecordCrc(Kvs *pKvs, const KvsRecordHeader *pHeader)
+{
+    unsigned short crc;
+
+    crc = KVS_Crc(0xFFFF, (const unsigned char *) pHeader, 4);
+    return KVS_Crc(crc, pKvs->pBuffer + KVS_HEADERSIZE, pHeader->size);
+}
+
+//------------------------------------------------------------------------------
+/// Returns the first index entry to probe for a key.
+/// \param key  Record key.
+//------------------------------------------------------------------------------
+static unsigned int KVS_Hash(unsigned short key)
+{
+    return ((key * 40503) >> 6) & (KVS_INDEXSIZE - 1);
+}
+
+//------------------------------------------------------------------------------
+/// Returns the index entry of a key, or 0 if the key is not in the index.
+/// \param pKvs  Pointer to a Kvs instance.
+/// \param key  Record key.
+//------------------------------------------------------------------------------
+static KvsEntry * KVS_Find(Kvs *pKvs, unsigned short key)
+{
+    unsigned int i = KVS_Hash(key);
+
+    while (pKvs->index[i].key != KVS_NOKEY) {
+
+        if (pKvs->index[i].key == key) {
+
+            return &(pKvs->index[i]);
+        }
+        i = (i + 1) & (KVS_INDEXSIZE - 1);
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/// Sets the record address of a key in the index. Returns 0 if successful;
+/// otherwise returns KVS_ERROR_FULL if the index is full.
+/// \param pKvs  Pointer to a Kvs instance.
+/// \param key  Record key.
+/// \param address  Record address.
+//------------------------------------------------------------------------------
+static unsigned char KVS_IndexSet(
+    Kvs *pKvs,
+    unsigned short key,
+    unsigned int address)
+{
+    unsigned int i = KVS_Hash(key);
+
+    while (pKvs->index[i].key != KVS_NOKEY) {
+
+        if (pKvs->index[i].key == key) {
+
+            pKvs->index[i].address = address;
+            return 0;
+        }
+        i = (i + 1) & (KVS_INDEXSIZE - 1);
+    }
+
+    // Always keep one free entry so that lookups terminate
+    if (pKvs->numKeys >= (KVS_INDEXSIZE - 1)) {
+
+        return KVS_ERROR_FULL;
+    }
+    pKvs->index[i].key = key;
+    pKvs->index[i].address = address;
+    pKvs->numKeys++;
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/// Removes a key from the index. The following entries of the probe sequence
+/// are moved back so that no tombstone is needed.
+/// \param pKvs  Pointer to a Kvs instance.
+/// \param key  Record key.
+//------------------------------------------------------------------------------
+static void KVS_IndexRemove(Kvs *pKvs, unsigned short key)
+{
+    KvsEntry *pEntry = KVS_Find(pKvs, key);
+    unsigned int i, j, k;
+
+    if (!pEntry) {
+
+        return;
+    }
+
+    i = pEntry - pKvs->index;
+    j = i;
+    while (1) {
+
+        j = (j + 1) & (KVS_INDEXSIZE - 1);
+        if (pKvs->index[j].key == KVS_NOKEY) {
+
+            break;
+        }
+
+        // Leave the entry if its home position lies cyclically in ]i, j]
+        k = KVS_Hash(pKvs->index[j].key);
+        if ((i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j))) {
+
+            continue;
+        }
+        pKvs->index[i] = pKvs->index[j];
+        i = j;
+    }
+    pKvs->index[i].key = KVS_NOKEY;
+    pKvs->numKeys--;
+}
+
+//------------------------------------------------------------------------------
+/// Reads the next valid record of a sector into the record buffer, starting
+/// at the given offset. Records with a valid header but a wrong CRC are
+/// skipped. Returns 0 if a record has been found; KVS_ERROR_NOTFOUND at the
+/// end of the sector data, with the offset of the free space; or
+/// KVS_ERROR_CRC if a corrupted header has been found.
+/// \param pKvs  Pointer to a Kvs instance.
+/// \param sector  Sector to scan.
+/// \param pOffset  Offset in sector, updated past the record.
+/// \param pAddress  Address of the record found.
+//------------------------------------------------------------------------------
+static unsigned char KVS_NextRecord(
+    Kvs *pKvs,
+    unsigned short sector,
+    unsigned int *pOffset,
+    unsigned int *pAddress)
+{
+    KvsRecordHeader header;
+    unsigned int address;
+    unsigned int pageRemain;
+    unsigned int nextPage;
+    unsigned short key;
+
+    while ((*pOffset + KVS_HEADERSIZE) <= pKvs->sectorSize) {
+
+        pageRemain = pKvs->pageSize - (*pOffset % pKvs->pageSize);
+        if (pageRemain < KVS_HEADERSIZE) {
+
+            *pOffset += pageRemain;
+            continue;
+        }
+
+        address = KVS_SECTORADDRESS(pKvs, sector) + *pOffset;
+        if (pKvs->read(pKvs->pDevice, (unsigned char *) &header,
+                       KVS_HEADERSIZE, address)) {
+
+            return KVS_ERROR_FLASH;
+        }
+
+        // Erased space: either the end of the data or the end of a page left
+        // unused because the next record did not fit in it
+        if (header.key == KVS_NOKEY) {
+
+            nextPage = *pOffset + pageRemain;
+            if (((*pOffset % pKvs->pageSize) == 0)
+                || ((nextPage + KVS_HEADERSIZE) > pKvs->sectorSize)) {
+
+                return KVS_ERROR_NOTFOUND;
+            }
+            if (pKvs->read(pKvs->pDevice, (unsigned char *) &key, 2,
+                           KVS_SECTORADDRESS(pKvs, sector) + nextPage)) {
+
+                return KVS_ERROR_FLASH;
+            }
+            if (key == KVS_NOKEY) {
+
+                return KVS_ERROR_NOTFOUND;
+            }
+            *pOffset = nextPage;
+            continue;
+        }
+
+        // Check the header has been completely written
+        if ((header.check != (unsigned short) ~header.size)
+            || (header.size > KVS_MAXVALUESIZE)
+            || (KVS_RECORDSIZE(header.size) > pageRemain)) {
+
+            TRACE_WARNING("KVS_NextRecord: Bad header at 0x%X\n\r", address);
+            return KVS_ERROR_CRC;
+        }
+
+        *pOffset += KVS_RECORDSIZE(header.size);
+
+        // Read the value and check the record
+        if (pKvs->read(pKvs->pDevice, pKvs->pBuffer + KVS_HEADERSIZE,
+                       header.size, address + KVS_HEADERSIZE)) {
+
+            return KVS_ERROR_FLASH;
+        }
+        if (KVS_RecordCrc(pKvs, &header) != header.crc) {
+
+            TRACE_WARNING("KVS_NextRecord: Bad record at 0x%X\n\r", address);
+            continue;
+        }
+
+        memcpy(pKvs->pBuffer, &header, KVS_HEADERSIZE);
+        *pAddress = address;
+        return 0;
+    }
+
+    *pOffset = pKvs->sectorSize;
+    return KVS_ERROR_NOTFOUND;
+}
+
+//------------------------------------------------------------------------------
+/// Starts a new head sector. Returns 0 if successful; otherwise returns
+/// KVS_ERROR_FULL if no free sector is available, or KVS_ERROR_FLASH.
+/// \param pKvs  Pointer to a Kvs instance.
+/// \param useReserve  Allows the sectors reserved for compaction to be used.
+//------------------------------------------------------------------------------
+static unsigned char KVS_NextSector(Kvs *pKvs, unsigned char useReserve)
+{
+    KvsSectorHeader header;
+    unsigned short next;
+    unsigned short freeSectors;
+
+    freeSectors = pKvs->numSectors - pKvs->usedSectors;
+    if (freeSectors <= (useReserve ? 0 : KVS_RESERVEDSECTORS)) {
+
+        return KVS_ERROR_FULL;
+    }
+
+    next = (pKvs->head + 1) % pKvs->numSectors;
+    if (!pKvs->erased[next]) {
+
+        if (pKvs->erase(pKvs->pDevice, KVS_SECTORADDRESS(pKvs, next))) {
+
+            return KVS_ERROR_FLASH;
+        }
+    }
+    pKvs->erased[next] = 0;
+
+    header.magic = KVS_MAGIC;
+    header.sequence = pKvs->sequence + 1;
+    if (pKvs->write(pKvs->pDevice, (unsigned char *) &header,
+                    sizeof(header), KVS_SECTORADDRESS(pKvs, next))) {
+
+        return KVS_ERROR_FLASH;
+    }
+
+    pKvs->sequence++;
+    pKvs->head = next;
+    pKvs->usedSectors++;
+    pKvs->offset = KVS_HEADERSIZE;
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/// Appends a record at the head of the log. The value may already be in the
+/// record buffer. Returns 0 if successful; otherwise returns an error code.
+/// \param pKvs  Pointer to a Kvs instance.
+/// \param key  Record key.
+/// \param pData  Value.
+/// \param size  Value size in bytes, 0 for a deletion record.
+/// \param useReserve  Allows the sectors reserved for compaction to be used.
+/// \param pAddress  Address of the record written.
+//------------------------------------------------------------------------------
+static unsigned char KVS_Append(
+    Kvs *pKvs,
+    unsigned short key,
+    const void *pData,
+    unsigned int size,
+    unsigned char useReserve,
+    unsigned int *pAddress)
+{
+    KvsRecordHeader header;
+    unsigned int recordSize = KVS_RECORDSIZE(size);
+    unsigned int pageRemain;
+    unsigned char error;
+
+    // Records do not cross page boundaries
+    do {
+
+        pageRemain = pKvs->pageSize - (pKvs->offset % pKvs->pageSize);
+        if (recordSize > pageRemain) {
+
+            pKvs->offset += pageRemain;
+        }
+        if ((pKvs->offset + recordSize) > pKvs->sectorSize) {
+
+            error = KVS_NextSector(pKvs, useReserve);
+            if (error) {
+
+                return error;
+            }
+        }
+    } while (recordSize > pageRemain);
+
+    // Build the record
+    header.key = key;
+    header.size = size;
+    header.check = ~size;
+    memmove(pKvs->pBuffer + KVS_HEADERSIZE, pData, size);
+    memset(pKvs->pBuffer + KVS_HEADERSIZE + size, 0xFF,
+           recordSize - KVS_HEADERSIZE - size);
+    header.crc = KVS_RecordCrc(pKvs, &header);
+    memcpy(pKvs->pBuffer, &header, KVS_HEADERSIZE);
+
+    *pAddress = KVS_SECTORADDRESS(pKvs, pKvs->head) + pKvs->offset;
+    pKvs->offset += recordSize;
+    if (pKvs->write(pKvs->pDevice, pKvs->pBuffer, recordSize, *pAddress)) {
+
+        return KVS_ERROR_FLASH;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/// Reclaims the oldest sector of the log: its live records are appended at the
+/// head, then it is erased. Returns 0 if successful; otherwise returns an
+/// error code.
+/// \param pKvs  Pointer to a Kvs instance.
+//------------------------------------------------------------------------------
+static unsigned char KVS_CompactSector(Kvs *pKvs)
+{
+    KvsRecordHeader header;
+    KvsEntry *pEntry;
+    unsigned int offset = KVS_HEADERSIZE;
+    unsigned int address;
+    unsigned short sector = pKvs->tail;
+    unsigned char error;
+
+    if (pKvs->usedSectors <= 1) {
+
+        return KVS_ERROR_FULL;
+    }
+
+    // Copy the records which are still the latest of their key. Deletion
+    // records are dropped, older records of the key are in this sector too.
+    while ((error = KVS_NextRecord(pKvs, sector, &offset, &address)) == 0) {
+
+        memcpy(&header, pKvs->pBuffer, KVS_HEADERSIZE);
+        pEntry = KVS_Find(pKvs, header.key);
+        if (pEntry && (pEntry->address == address)) {
+
+            error = KVS_Append(pKvs, header.key, pKvs->pBuffer + KVS_HEADERSIZE,
+                               header.size, 1, &(pEntry->address));
+            if (error) {
+
+                return error;
+            }
+        }
+    }
+    if (error == KVS_ERROR_FLASH) {
+
+        return error;
+    }
+
+    // Erase the sector
+    if (pKvs->erase(pKvs->pDevice, KVS_SECTORADDRESS(pKvs, sector))) {
+
+        return KVS_ERROR_FLASH;
+    }
+    pKvs->erased[sector] = 1;
+    pKvs->tail = (sector + 1) % pKvs->numSectors;
+    pKvs->usedSectors--;
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/// Returns the number of bytes left for records: the free sectors and the end
+/// of the head sector.
+/// \param pKvs  Pointer to a Kvs instance.
+//------------------------------------------------------------------------------
+static unsigned int KVS_FreeSpace(Kvs *pKvs)
+{
+    return (pKvs->numSectors - pKvs->usedSectors) * pKvs->sectorSize
+           + (pKvs->sectorSize - min(pKvs->offset, pKvs->sectorSize));
+}
+
+//------------------------------------------------------------------------------
+/// Appends a record at the head of the log, compacting the oldest sectors as
+/// long as there is no room for it. Returns 0 if successful; KVS_ERROR_FULL
+/// if compaction does not reclaim any space, i.e. the live records fill the
+/// store; otherwise another error code.
+/// \param pKvs  Pointer to a Kvs instance.
+/// \param key  Record key.
+/// \param pData  Value.
+/// \param size  Value size in bytes, 0 for a deletion record.
+/// \param pAddress  Address of the record written.
+//------------------------------------------------------------------------------
+static unsigned char KVS_AppendCompact(
+    Kvs *pKvs,
+    unsigned short key,
+    const void *pData,
+    unsigned int size,
+    unsigned int *pAddress)
+{
+    unsigned int freeSpace;
+    unsigned short passes = 0;
+    unsigned char error;
+
+    error = KVS_Append(pKvs, key, pData, size, 0, pAddress);
+    while (error == KVS_ERROR_FULL) {
+
+        // Once every sector has been compacted, another pass cannot help
+        if (passes >= pKvs->numSectors) {
+
+            return KVS_ERROR_FULL;
+        }
+        freeSpace = KVS_FreeSpace(pKvs);
+        error = KVS_CompactSector(pKvs);
+        if (error) {
+
+            return error;
+        }
+        if (KVS_FreeSpace(pKvs) <= freeSpace) {
+
+            TRACE_WARNING("KVS_AppendCompact: Store full of live records\n\r");
+            return KVS_ERROR_FULL;
+        }
+        passes++;
+        error = KVS_Append(pKvs, key, pData, size, 0, pAddress);
+    }
+    return error;
+}
+
+//------------------------------------------------------------------------------
+/// Sends a command to an AT45 device, then waits for the end of the SPI
+/// transfer and for the device to be ready.
+/// \param pAt45  Pointer to an AT45 driver instance.
+/// \param cmd  Command code.
+/// \param pData  Data buffer, can be 0.
+/// \param size  Number of bytes to send.
+/// \param address  Address at which the command is performed.
+//------------------------------------------------------------------------------
+static unsigned char KVS_At45Command(
+    At45 *pAt45,
+    unsigned char cmd,
+    unsigned char *pData,
+    unsigned int size,
+    unsigned int address)
+{
+    if (AT45_SendCommand(pAt45, cmd, 4, pData, size, address, 0, 0)) {
+
+        return KVS_ERROR_FLASH;
+    }
+    while (AT45_IsBusy(pAt45)) {
+
+        SPID_Handler(pAt45->pSpid);
+    }
+    AT45D_WaitReady(pAt45);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/// Reads data from an AT45 device.
+//------------------------------------------------------------------------------
+static unsigned char KVS_At45Read(
+    void *pDevice,
+    unsigned char *pData,
+    unsigned int size,
+    unsigned int address)
+{
+    AT45D_ReadStream((At45 *) pDevice, pData, size, address);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/// Programs data on an AT45 device without erasing the pages: the log only
+/// writes to erased space, and the sectors are erased when compacted. Each
+/// page is loaded into buffer 1 so that its other bytes are programmed with
+/// their current value.
+//------------------------------------------------------------------------------
+static unsigned char KVS_At45Write(
+    void *pDevice,
+    unsigned char *pData,
+    unsigned int size,
+    unsigned int address)
+{
+    At45 *pAt45 = (At45 *) pDevice;
+    unsigned int pageSize = AT45_PageSize(pAt45);
+    unsigned int writeSize;
+
+    while (size > 0) {
+
+        writeSize = min(size, pageSize - (address % pageSize));
+        if (KVS_At45Command(pAt45, AT45_PAGE_BUF1_TX, 0, 0, address)
+            || KVS_At45Command(pAt45, AT45_BUF1_WRITE, pData, writeSize, address)
+            || KVS_At45Command(pAt45, AT45_BUF1_MEM_NOERASE, 0, 0, address)) {
+
+            return KVS_ERROR_FLASH;
+        }
+        pData += writeSize;
+        size -= writeSize;
+        address += writeSize;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/// Erases the AT45 block at the given address.
+//------------------------------------------------------------------------------
+static unsigned char KVS_At45Erase(void *pDevice, unsigned int address)
+{
+    return KVS_At45Command((At45 *) pDevice, AT45_BLOCK_ERASE, 0, 0, address);
+}
+
+//------------------------------------------------------------------------------
+/// Reads data from an AT26 device.
+//------------------------------------------------------------------------------
+static unsigned char KVS_At26Read(
+    void *pDevice,
+    unsigned char *pData,
+    unsigned int size,
+    unsigned int address)
+{
+    return AT26D_Read((At26 *) pDevice, pData, size, address);
+}
+
+//------------------------------------------------------------------------------
+/// Programs data on an AT26 device.
+//------------------------------------------------------------------------------
+static unsigned char KVS_At26Write(
+    void *pDevice,
+    unsigned char *pData,
+    unsigned int size,
+    unsigned int address)
+{
+    return AT26D_Write((At26 *) pDevice, pData, size, address);
+}
+
+//------------------------------------------------------------------------------
+/// Erases the AT26 block at the given address.
+//------------------------------------------------------------------------------
+static unsigned char KVS_At26Erase(void *pDevice, unsigned int address)
+{
+    return AT26D_EraseBlock((At26 *) pDevice, address);
+}
+
+//------------------------------------------------------------------------------
+/// Initializes the fields common to all devices.
+/// \param pKvs  Pointer to a Kvs instance.
+/// \param address  Start address of the store area.
+/// \param size  Size of the store area in bytes.
+//------------------------------------------------------------------------------
+static void KVS_Configure(Kvs *pKvs, unsigned int address, unsigned int size)
+{
+    SANITY_CHECK((address % pKvs->sectorSize) == 0);
+    SANITY_CHECK((pKvs->sectorSize % pKvs->pageSize) == 0);
+
+    pKvs->baseAddress = address;
+    pKvs->numSectors = min(size / pKvs->sectorSize, KVS_MAXSECTORS);
+    pKvs->usedSectors = 0;
+    pKvs->tail = 0;
+    pKvs->head = 0;
+    pKvs->offset = 0;
+    pKvs->sequence = 0;
+    memset(pKvs->erased, 0, sizeof(pKvs->erased));
+    pKvs->numKeys = 0;
+    memset(pKvs->index, 0xFF, sizeof(pKvs->index));
+
+    SANITY_CHECK(pKvs->numSectors > KVS_COMPACTTHRESHOLD);
+}
+
+//------------------------------------------------------------------------------
+//         Exported functions
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+/// Initializes a Kvs instance on an area of an AT45 device, with one AT45
+/// block (8 pages) per sector. The device must have been detected.
+/// \param pKvs  Pointer to a Kvs instance.
+/// \param pAt45  Pointer to an AT45 driver instance.
+/// \param address  Start address of the store area.
+/// \param size  Size of the store area in bytes.
+//------------------------------------------------------------------------------
+void KVS_ConfigureAt45(
+    Kvs *pKvs,
+    At45 *pAt45,
+    unsigned int address,
+    unsigned int size)
+{
+    SANITY_CHECK(pKvs);
+    SANITY_CHECK(pAt45);
+
+    pKvs->pDevice = pAt45;
+    pKvs->read = KVS_At45Read;
+    pKvs->write = KVS_At45Write;
+    pKvs->erase = KVS_At45Erase;
+    pKvs->pageSize = AT45_PageSize(pAt45);
+    pKvs->sectorSize = pKvs->pageSize * KVS_AT45BLOCKPAGES;
+    KVS_Configure(pKvs, address, size);
+}
+
+//------------------------------------------------------------------------------
+/// Initializes a Kvs instance on an area of an AT26 device, with one erase
+/// block per sector. The device must have been detected.
+/// \param pKvs  Pointer to a Kvs instance.
+/// \param pAt26  Pointer to an AT26 driver instance.
+/// \param address  Start address of the store area.
+/// \param size  Size of the store area in bytes.
+//------------------------------------------------------------------------------
+void KVS_ConfigureAt26(
+    Kvs *pKvs,
+    At26 *pAt26,
+    unsigned int address,
+    unsigned int size)
+{
+    SANITY_CHECK(pKvs);
+    SANITY_CHECK(pAt26);
+
+    pKvs->pDevice = pAt26;
+    pKvs->read = KVS_At26Read;
+    pKvs->write = KVS_At26Write;
+    pKvs->erase = KVS_At26Erase;
+    pKvs->pageSize = AT26_PageSize(pAt26);
+    pKvs->sectorSize = AT26_BlockSize(pAt26);
+    KVS_Configure(pKvs, address, size);
+}
+
+//------------------------------------------------------------------------------
+/// Erases the whole store area and starts an empty log. Returns 0 if
+/// successful; otherwise returns an error code.
+/// \param pKvs  Pointer to a Kvs instance.
+//------------------------------------------------------------------------------
+unsigned char KVS_Format(Kvs *pKvs)
+{
+    unsigned short i;
+
+    SANITY_CHECK(pKvs);
+
+    for (i = 0; i < pKvs->numSectors; i++) {
+
+        if (pKvs->erase(pKvs->pDevice, KVS_SECTORADDRESS(pKvs, i))) {
+
+            return KVS_ERROR_FLASH;
+        }
+        pKvs->erased[i] = 1;
+    }
+
+    pKvs->numKeys = 0;
+    memset(pKvs->index, 0xFF, sizeof(pKvs->index));
+    pKvs->usedSectors = 0;
+    pKvs->tail = 0;
+    pKvs->head = pKvs->numSectors - 1;
+    pKvs->sequence = 0;
+    return KVS_NextSector(pKvs, 1);
+}
+
+//------------------------------------------------------------------------------
+/// Mounts the store: finds the sectors of the log and rebuilds the index by
+/// scanning their records. An area without any log sector is formatted.
+/// Returns 0 if successful; otherwise returns an error code.
+/// \param pKvs  Pointer to a Kvs instance.
+//------------------------------------------------------------------------------
+unsigned char KVS_Mount(Kvs *pKvs)
+{
+    KvsSectorHeader header;
+    KvsRecordHeader record;
+    unsigned int minSequence = 0;
+    unsigned int offset;
+    unsigned int address;
+    unsigned short sector;
+    unsigned short i;
+    unsigned char found = 0;
+    unsigned char error;
+
+    SANITY_CHECK(pKvs);
+
+    // Find the oldest and newest sectors of the log
+    for (i = 0; i < pKvs->numSectors; i++) {
+
+        pKvs->erased[i] = 0;
+        if (pKvs->read(pKvs->pDevice, (unsigned char *) &header,
+                       sizeof(header), KVS_SECTORADDRESS(pKvs, i))) {
+
+            return KVS_ERROR_FLASH;
+        }
+        if (header.magic != KVS_MAGIC) {
+
+            continue;
+        }
+        if (!found || (header.sequence < minSequence)) {
+
+            minSequence = header.sequence;
+            pKvs->tail = i;
+        }
+        if (!found || (header.sequence > pKvs->sequence)) {
+
+            pKvs->sequence = header.sequence;
+            pKvs->head = i;
+        }
+        found = 1;
+    }
+    if (!found) {
+
+        TRACE_INFO("KVS_Mount: Formatting\n\r");
+        return KVS_Format(pKvs);
+    }
+    pKvs->usedSectors = ((pKvs->head + pKvs->numSectors - pKvs->tail)
+                         % pKvs->numSectors) + 1;
+
+    // Replay the log from the oldest record
+    pKvs->numKeys = 0;
+    memset(pKvs->index, 0xFF, sizeof(pKvs->index));
+    sector = pKvs->tail;
+    while (1) {
+
+        offset = KVS_HEADERSIZE;
+        while ((error = KVS_NextRecord(pKvs, sector, &offset, &address)) == 0) {
+
+            memcpy(&record, pKvs->pBuffer, KVS_HEADERSIZE);
+            if (record.size == 0) {
+
+                KVS_IndexRemove(pKvs, record.key);
+            }
+            else if (KVS_IndexSet(pKvs, record.key, address)) {
+
+                return KVS_ERROR_FULL;
+            }
+        }
+        if (error == KVS_ERROR_FLASH) {
+
+            return error;
+        }
+        if (sector == pKvs->head) {
+
+            // Do not append after a corrupted record
+            pKvs->offset = (error == KVS_ERROR_CRC) ? pKvs->sectorSize : offset;
+            break;
+        }
+        sector = (sector + 1) % pKvs->numSectors;
+    }
+
+    TRACE_INFO("KVS_Mount: %u keys, %u/%u sectors used\n\r",
+               pKvs->numKeys, pKvs->usedSectors, pKvs->numSectors);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/// Reads the value of a key. Returns 0 if successful; otherwise returns
+/// KVS_ERROR_NOTFOUND, KVS_ERROR_SIZE if the buffer is too small, or
+/// KVS_ERROR_CRC.
+/// \param pKvs  Pointer to a Kvs instance.
+/// \param key  Key of the value.
+/// \param pData  Buffer receiving the value.
+/// \param pSize  Size of the buffer, updated with the size of the value.
+//------------------------------------------------------------------------------
+unsigned char KVS_Read(
+    Kvs *pKvs,
+    unsigned short key,
+    void *pData,
+    unsigned int *pSize)
+{
+    KvsRecordHeader header;
+    KvsEntry *pEntry;
+
+    SANITY_CHECK(pKvs);
+    SANITY_CHECK(pSize);
+
+    pEntry = KVS_Find(pKvs, key);
+    if (!pEntry) {
+
+        return KVS_ERROR_NOTFOUND;
+    }
+
+    if (pKvs->read(pKvs->pDevice, (unsigned char *) &header,
+                   KVS_HEADERSIZE, pEntry->address)) {
+
+        return KVS_ERROR_FLASH;
+    }
+    if ((header.key != key) || (header.size > KVS_MAXVALUESIZE)) {
+
+        return KVS_ERROR_CRC;
+    }
+    if (header.size > *pSize) {
+
+        return KVS_ERROR_SIZE;
+    }
+    if (pKvs->read(pKvs->pDevice, pKvs->pBuffer + KVS_HEADERSIZE,
+                   header.size, pEntry->address + KVS_HEADERSIZE)) {
+
+        return KVS_ERROR_FLASH;
+    }
+    if (KVS_RecordCrc(pKvs, &header) != header.crc) {
+
+        return KVS_ERROR_CRC;
+    }
+    memcpy(pData, pKvs->pBuffer + KVS_HEADERSIZE, header.size);
+    *pSize = header.size;
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/// Writes the value of a key by appending a record to the log. When the log
+/// is full, the oldest sector is compacted first. Returns 0 if successful;
+/// KVS_ERROR_FULL if the live records fill the store; otherwise returns an
+/// error code.
+/// \param pKvs  Pointer to a Kvs instance.
+/// \param key  Key of the value.
+/// \param pData  Value.
+/// \param size  Size of the value in bytes (1 to KVS_MAXVALUESIZE).
+//------------------------------------------------------------------------------
+unsigned char KVS_Write(
+    Kvs *pKvs,
+    unsigned short key,
+    const void *pData,
+    unsigned int size)
+{
+    unsigned int address;
+    unsigned char error;
+
+    SANITY_CHECK(pKvs);
+    SANITY_CHECK(key != KVS_NOKEY);
+
+    if ((size == 0) || (size > KVS_MAXVALUESIZE)) {
+
+        return KVS_ERROR_SIZE;
+    }
+    if (!KVS_Find(pKvs, key) && (pKvs->numKeys >= (KVS_INDEXSIZE - 1))) {
+
+        return KVS_ERROR_FULL;
+    }
+
+    error = KVS_AppendCompact(pKvs, key, pData, size, &address);
+    if (error) {
+
+        return error;
+    }
+    return KVS_IndexSet(pKvs, key, address);
+}
+
+//------------------------------------------------------------------------------
+/// Deletes a key by appending a deletion record to the log. Returns 0 if
+/// successful; otherwise returns an error code.
+/// \param pKvs  Pointer to a Kvs instance.
+/// \param key  Key to delete.
+//------------------------------------------------------------------------------
+unsigned char KVS_Delete(Kvs *pKvs, unsigned short key)
+{
+    unsigned int address;
+    unsigned char error;
+
+    SANITY_CHECK(pKvs);
+
+    if (!KVS_Find(pKvs, key)) {
+
+        return KVS_ERROR_NOTFOUND;
+    }
+
+    error = KVS_AppendCompact(pKvs, key, 0, 0, &address);
+    if (error) {
+
+        return error;
+    }
+    KVS_IndexRemove(pKvs, key);
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+/// Background compaction step, to be called regularly by the application.
+/// Reclaims the oldest sector when few free sectors are left. Returns 0 if
+/// successful or if there was nothing to do; otherwise returns an error code.
+/// \param pKvs  Pointer to a Kvs instance.
+//------------------------------------------------------------------------------
+unsigned char KVS_Compact(Kvs *pKvs)
+{
+    SANITY_CHECK(pKvs);
+
+    if ((pKvs->numSectors - pKvs->usedSectors) > KVS_COMPACTTHRESHOLD) {
+
+        return 0;
+    }
+    if (pKvs->usedSectors <= 1) {
+
+        return 0;
+    }
+    return KVS_CompactSector(pKvs);
+}
+
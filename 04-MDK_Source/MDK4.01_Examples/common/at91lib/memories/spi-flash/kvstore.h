@@ -0,0 +1,211 @@
+/* ----------------------------------------------------------------------------
+ *         ATMEL Microcontroller Software Support 
+ * ----------------------------------------------------------------------------
+ * Copyright (c) 2008, Atmel Corporation
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the disclaimer below.
+ *
+ * Atmel's name may not be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * DISCLAIMER: THIS SOFTWARE IS PROVIDED BY ATMEL "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT ARE
+ * DISCLAIMED. IN NO EVENT SHALL ATMEL BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA,
+ * OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * ----------------------------------------------------------------------------
+ */
+
+//------------------------------------------------------------------------------
+/// \unit
+///
+/// !!!Purpose
+/// 
+/// Append-only key/value store for configuration data and counters, on top
+/// of the AT45 or AT26 serial flash drivers. Values are identified by a 16-bit
+/// key. Every update appends a CRC-protected record to a log made of erase
+/// sectors used as a ring; a value is never erased in place. An index held in
+/// RAM maps each key to its latest record, so that a read is a single flash
+/// access. The index is rebuilt by scanning the log when the store is mounted.
+/// 
+/// Records never cross a page boundary, so an update costs one page program.
+/// When the free sectors run low, the oldest sector is compacted: its live
+/// records are copied to the head of the log and the sector is erased.
+/// 
+/// !!!Usage
+/// 
+/// -# Initialize a Kvs instance on an area of an At45 or At26 device using
+///    KVS_ConfigureAt45() or KVS_ConfigureAt26(). The area must start on an
+///    erase sector boundary.
+/// -# Mount the store using KVS_Mount(). An area which has never been used
+///    is formatted.
+/// -# Read, write and delete values using KVS_Read(), KVS_Write() and
+///    KVS_Delete().
+/// -# Call KVS_Compact() regularly from the application idle loop so that
+///    sectors are reclaimed in the background. KVS_Write() only compacts
+///    by itself when the log is full.
+//------------------------------------------------------------------------------
+
+#ifndef KVSTORE_H
+#define KVSTORE_H
+
+//------------------------------------------------------------------------------
+//         Headers
+//------------------------------------------------------------------------------
+
+#include "at45.h"
+#include "at26.h"
+
+//------------------------------------------------------------------------------
+//         Definitions
+//------------------------------------------------------------------------------
+
+/// The key has no value in the store.
+#define KVS_ERROR_NOTFOUND      1
+/// There is no room left in the store or its index.
+#define KVS_ERROR_FULL          2
+/// A record is corrupted.
+#define KVS_ERROR_CRC           3
+/// Invalid value size, or value larger than the provided buffer.
+#define KVS_ERROR_SIZE          4
+/// The serial flash could not be programmed or erased.
+#define KVS_ERROR_FLASH         5
+
+/// Number of index entries (power of 2), one is always left unused.
+#ifndef KVS_INDEXSIZE
+#define KVS_INDEXSIZE           64
+#endif
+
+/// Maximum size of a value in bytes.
+#ifndef KVS_MAXVALUESIZE
+#define KVS_MAXVALUESIZE        240
+#endif
+
+/// Maximum number of erase sectors in the store area.
+#ifndef KVS_MAXSECTORS
+#define KVS_MAXSECTORS          32
+#endif
+
+/// Key value indicating an empty index entry or an erased record.
+#define KVS_NOKEY               0xFFFF
+
+//------------------------------------------------------------------------------
+//         Types
+//------------------------------------------------------------------------------
+
+/// Reads data from the serial flash device.
+typedef unsigned char (*KvsRead)(void *pDevice,
+                                 unsigned char *pData,
+                                 unsigned int size,
+                                 unsigned int address);
+/// Programs data on the (erased) serial flash device.
+typedef unsigned char (*KvsWrite)(void *pDevice,
+                                  unsigned char *pData,
+                                  unsigned int size,
+                                  unsigned int address);
+/// Erases the sector at the given address of the serial flash device.
+typedef unsigned char (*KvsErase)(void *pDevice, unsigned int address);
+
+//------------------------------------------------------------------------------
+/// Index entry, associating a key with the address of its latest record.
+//------------------------------------------------------------------------------
+typedef struct {
+
+    /// Key, or KVS_NOKEY if the entry is free.
+    unsigned short key;
+    /// Address of the latest record of the key.
+    unsigned int address;
+
+} KvsEntry;
+
+//------------------------------------------------------------------------------
+/// Key/value store instance.
+//------------------------------------------------------------------------------
+typedef struct _Kvs {
+
+    /// Underlying serial flash driver instance.
+    void *pDevice;
+    /// Device read function.
+    KvsRead read;
+    /// Device program function.
+    KvsWrite write;
+    /// Device sector erase function.
+    KvsErase erase;
+    /// Start address of the store area.
+    unsigned int baseAddress;
+    /// Size of an erase sector in bytes.
+    unsigned int sectorSize;
+    /// Size of a program page in bytes.
+    unsigned int pageSize;
+    /// Number of sectors in the store area.
+    unsigned short numSectors;
+    /// Number of sectors holding log data.
+    unsigned short usedSectors;
+    /// Oldest sector of the log.
+    unsigned short tail;
+    /// Sector where records are appended.
+    unsigned short head;
+    /// Offset of the next record in the head sector.
+    unsigned int offset;
+    /// Sequence number of the head sector.
+    unsigned int sequence;
+    /// Indicates which free sectors are known to be erased.
+    unsigned char erased[KVS_MAXSECTORS];
+    /// Number of keys in the index.
+    unsigned short numKeys;
+    /// Index of the store.
+    KvsEntry index[KVS_INDEXSIZE];
+    /// Record buffer (header + value).
+    unsigned char pBuffer[8 + KVS_MAXVALUESIZE + 4];
+
+} Kvs;
+
+//------------------------------------------------------------------------------
+//         Exported functions
+//------------------------------------------------------------------------------
+
+extern void KVS_ConfigureAt45(
+    Kvs *pKvs,
+    At45 *pAt45,
+    unsigned int address,
+    unsigned int size);
+
+extern void KVS_ConfigureAt26(
+    Kvs *pKvs,
+    At26 *pAt26,
+    unsigned int address,
+    unsigned int size);
+
+extern unsigned char KVS_Format(Kvs *pKvs);
+
+extern unsigned char KVS_Mount(Kvs *pKvs);
+
+extern unsigned char KVS_Read(
+    Kvs *pKvs,
+    unsigned short key,
+    void *pData,
+    unsigned int *pSize);
+
+extern unsigned char KVS_Write(
+    Kvs *pKvs,
+    unsigned short key,
+    const void *pData,
+    unsigned int size);
+
+extern unsigned char KVS_Delete(Kvs *pKvs, unsigned short key);
+
+extern unsigned char KVS_Compact(Kvs *pKvs);
+
+#endif //#ifndef KVSTORE_H
+
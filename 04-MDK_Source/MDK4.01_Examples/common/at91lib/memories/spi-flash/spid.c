@@ -33,6 +33,14 @@
 
 #include "spid.h"
 #include <boards/board.h>
+#include <utility/math.h>
+
+//------------------------------------------------------------------------------
+//         Internal definitions
+//------------------------------------------------------------------------------
+
+/// Maximum number of bytes transferred by one PDC buffer.
+#define SPID_PDC_MAXSIZE    0xFFFF
 
 //------------------------------------------------------------------------------
 //         Macros
@@ -65,6 +73,8 @@ unsigned char SPID_Configure(Spid *pSpid, AT91S_SPI *pSpiHw, unsigned char spiId
     pSpid->spiId  = spiId;
     pSpid->semaphore = 1;
     pSpid->pCurrentCommand = 0;
+    pSpid->pNextData = 0;
+    pSpid->nextSize = 0;
 
     // Enable the SPI clock
     WRITE_PMC(AT91C_BASE_PMC, PMC_PCER, (1 << pSpid->spiId));
@@ -113,6 +123,7 @@ unsigned char SPID_SendCommand(Spid *pSpid, SpidCmd *pCommand)
 {
     AT91S_SPI *pSpiHw = pSpid->pSpiHw;
      unsigned int spiMr;
+    unsigned int size;
          
      // Try to get the dataflash semaphore
      if (pSpid->semaphore == 0) {
@@ -139,10 +150,15 @@ unsigned char SPID_SendCommand(Spid *pSpid, SpidCmd *pCommand)
     WRITE_SPI(pSpiHw, SPI_TPR, (int) pCommand->pCmd);
     WRITE_SPI(pSpiHw, SPI_TCR, pCommand->cmdSize);
     
+    size = min(pCommand->dataSize, SPID_PDC_MAXSIZE);
     WRITE_SPI(pSpiHw, SPI_RNPR, (int) pCommand->pData);
-    WRITE_SPI(pSpiHw, SPI_RNCR, pCommand->dataSize);
+    WRITE_SPI(pSpiHw, SPI_RNCR, size);
     WRITE_SPI(pSpiHw, SPI_TNPR, (int) pCommand->pData);
-    WRITE_SPI(pSpiHw, SPI_TNCR, pCommand->dataSize);
+    WRITE_SPI(pSpiHw, SPI_TNCR, size);
+
+    // Remaining data is chained by the handler
+    pSpid->pNextData = pCommand->pData + size;
+    pSpid->nextSize = pCommand->dataSize - size;
 
     // Initialize the callback
     pSpid->pCurrentCommand = pCommand;
@@ -168,7 +184,23 @@ void SPID_Handler(Spid *pSpid)
     SpidCmd *pSpidCmd = pSpid->pCurrentCommand;
     AT91S_SPI *pSpiHw = pSpid->pSpiHw;
     volatile unsigned int spiSr;
+    unsigned int size;
     
+    // Chain the next part of the data once both next buffers have been taken
+    // over, so that the transfer goes on without releasing the chip select
+    if ((pSpid->nextSize > 0)
+        && (READ_SPI(pSpiHw, SPI_RNCR) == 0)
+        && (READ_SPI(pSpiHw, SPI_TNCR) == 0)) {
+
+        size = min(pSpid->nextSize, SPID_PDC_MAXSIZE);
+        WRITE_SPI(pSpiHw, SPI_RNPR, (int) pSpid->pNextData);
+        WRITE_SPI(pSpiHw, SPI_RNCR, size);
+        WRITE_SPI(pSpiHw, SPI_TNPR, (int) pSpid->pNextData);
+        WRITE_SPI(pSpiHw, SPI_TNCR, size);
+        pSpid->pNextData += size;
+        pSpid->nextSize -= size;
+    }
+
     // Read the status register
     spiSr = READ_SPI(pSpiHw, SPI_SR);    
     if (spiSr & AT91C_SPI_RXBUFF) {
@@ -55,6 +55,10 @@
 ///        transfered.(if the data specified in cmd structure)
 ///       - Initialize SPI_RNPR and SPI_RNCR with rest of the data to be 
 ///         received.(if the data specified in cmd structure)
+///       - Data larger than one PDC buffer is chained into SPI_TNPR/SPI_RNPR
+///         by SPID_Handler() as soon as the previous part has been taken
+///         over, so the whole transfer runs as a single command. The handler
+///         must then be polled while the transfer is running.
 ///    -# Initialize the callback function if specified.
 ///    -# Enable transmitter and receiver.
 ///    -# Example for sending a command to the dataflash through the SPI. 
@@ -133,7 +137,7 @@ typedef struct _SpidCmd {
     /// Pointer to the data to be sent.
 	unsigned char *pData;
     /// Data size in bytes.
-	unsigned short dataSize;
+	unsigned int dataSize;
     /// SPI chip select.
 	unsigned char spiCs;
     /// Callback function invoked at the end of transfer.
@@ -157,6 +161,10 @@ typedef struct {
 	SpidCmd *pCurrentCommand;
     /// Mutual exclusion semaphore.
 	volatile char semaphore;
+    /// Data of the current command not yet loaded in the PDC.
+	unsigned char *pNextData;
+    /// Number of bytes not yet loaded in the PDC.
+	unsigned int nextSize;
 
 } Spid;
 
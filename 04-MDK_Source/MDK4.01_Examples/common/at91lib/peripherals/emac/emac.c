@@ -34,6 +34,7 @@
 #include "emac.h"
 #include <utility/trace.h>
 #include <utility/assert.h>
+#include <utility/math.h>
 #include <string.h>
 
 //------------------------------------------------------------------------------
@@ -100,42 +101,25 @@
 //------------------------------------------------------------------------------
 //      Structures
 //------------------------------------------------------------------------------
-#ifdef __ICCARM__          // IAR
-#pragma pack(4)            // IAR
-#define __attribute__(...) // IAR
-#endif                     // IAR
-/// Describes the type and attribute of Receive Transfer descriptor.
-typedef struct _EmacRxTDescriptor {
-    unsigned int addr;
-    unsigned int status;
-} __attribute__((packed, aligned(8))) EmacRxTDescriptor, *PEmacRxTDescriptor;
-
-/// Describes the type and attribute of Transmit Transfer descriptor.
-typedef struct _EmacTxTDescriptor {
-    unsigned int addr;
-    unsigned int status;
-} __attribute__((packed, aligned(8))) EmacTxTDescriptor, *PEmacTxTDescriptor;
-#ifdef __ICCARM__          // IAR
-#pragma pack()             // IAR
-#endif                     // IAR
-
-#ifdef __ICCARM__          // IAR
-#pragma data_alignment=8   // IAR
-#endif                     // IAR
-/// Descriptors for RX (required aligned by 8)
+/// Descriptors for RX
 typedef struct {
-   volatile EmacRxTDescriptor td[RX_BUFFERS];
+   volatile EmacRxTDescriptor *td; /// Descriptor ring
+   unsigned char *pBuffer;  /// Buffers, EMAC_RX_UNITSIZE bytes for each descriptor
+   unsigned short nb;       /// Number of descriptors
    EMAC_RxCallback rxCb; /// Callback function to be invoked once a frame has been received
-   unsigned short idx;
+   EMAC_RxCallback pollCb;  /// Callback scheduling EMAC_RxPoll() in poll mode
+   unsigned short idx;      /// Next descriptor to be processed
+   unsigned short lentIdx;  /// First descriptor of the oldest frame lent to the application
+   unsigned short lent;     /// Number of descriptors lent to the application
 } RxTd;
 
-#ifdef __ICCARM__          // IAR
-#pragma data_alignment=8   // IAR
-#endif                     // IAR
-/// Descriptors for TX (required aligned by 8)
+/// Descriptors for TX
 typedef struct {
-   volatile EmacTxTDescriptor td[TX_BUFFERS];
-   EMAC_TxCallback txCb[TX_BUFFERS];    /// Callback function to be invoked once TD has been processed
+   volatile EmacTxTDescriptor *td;      /// Descriptor ring
+   EmacTxInfo *pInfo;                   /// Callback and frame length of each TD
+   unsigned char *pBuffer;              /// Buffers, unitSize bytes for each descriptor
+   unsigned short nb;                   /// Number of descriptors
+   unsigned short unitSize;             /// Size of a buffer
    EMAC_WakeupCallback wakeupCb;        /// Callback function to be invoked once several TD have been released
    unsigned short wakeupThreshold; /// Number of free TD before wakeupCb is invoked
    unsigned short head;            /// Circular buffer head pointer incremented by the upper layer (buffer to be sent)
@@ -149,22 +133,45 @@ typedef struct {
 static volatile RxTd rxTd; 
 // Transmit Transfer Descriptor buffer
 static volatile TxTd txTd; 
+
+// Default rings, used by EMAC_Init()
+#ifdef __ICCARM__          // IAR
+#pragma data_alignment=8   // IAR
+#endif                     // IAR
+static EmacRxTDescriptor defaultRxTd[RX_BUFFERS];
+#ifdef __ICCARM__          // IAR
+#pragma data_alignment=8   // IAR
+#endif                     // IAR
+static EmacTxTDescriptor defaultTxTd[TX_BUFFERS];
+static EmacTxInfo defaultTxInfo[TX_BUFFERS];
+
 /// Send Buffer
 // Section 3.6 of AMBA 2.0 spec states that burst should not cross 1K Boundaries.
 // Receive buffer manager writes are burst of 2 words => 3 lsb bits of the address shall be set to 0
 #ifdef __ICCARM__          // IAR
 #pragma data_alignment=8   // IAR
 #endif                     // IAR
-static volatile unsigned char pTxBuffer[TX_BUFFERS * EMAC_TX_UNITSIZE] __attribute__((aligned(8)));
+static unsigned char pTxBuffer[TX_BUFFERS * EMAC_TX_UNITSIZE] __attribute__((aligned(8)));
 
 #ifdef __ICCARM__          // IAR
 #pragma data_alignment=8   // IAR
 #endif                     // IAR
 /// Receive Buffer
-static volatile unsigned char pRxBuffer[RX_BUFFERS * EMAC_RX_UNITSIZE] __attribute__((aligned(8)));
+static unsigned char pRxBuffer[RX_BUFFERS * EMAC_RX_UNITSIZE] __attribute__((aligned(8)));
+
+/// Default rings
+static const EmacRings defaultRings = {
+
+    defaultRxTd, pRxBuffer, RX_BUFFERS,
+    defaultTxTd, defaultTxInfo, pTxBuffer, TX_BUFFERS, EMAC_TX_UNITSIZE
+};
+
 /// Statistics
 static volatile EmacStats EmacStatistics;
 
+/// Callback given the frames sent and received, 0 when capture is disabled
+static EMAC_CaptureCallback captureCb;
+
 //-----------------------------------------------------------------------------
 //         Internal functions
 //-----------------------------------------------------------------------------
@@ -211,13 +218,14 @@ static void EMAC_ResetTx(void)
     AT91C_BASE_EMAC->EMAC_NCR &= ~AT91C_EMAC_TE;
     // Setup the TX descriptors.
     CIRC_CLEAR(&txTd);
-    for(Index = 0; Index < TX_BUFFERS; Index++) {
+    for(Index = 0; Index < txTd.nb; Index++) {
 
-        Address = (unsigned int)(&(pTxBuffer[Index * EMAC_TX_UNITSIZE]));
+        Address = (unsigned int)(&(txTd.pBuffer[Index * txTd.unitSize]));
         txTd.td[Index].addr = Address;
         txTd.td[Index].status = EMAC_TX_USED_BIT;
+        txTd.pInfo[Index].nb = 1;
     }
-    txTd.td[TX_BUFFERS - 1].status = EMAC_TX_USED_BIT | EMAC_TX_WRAP_BIT;
+    txTd.td[txTd.nb - 1].status = EMAC_TX_USED_BIT | EMAC_TX_WRAP_BIT;
     // Transmit Buffer Queue Pointer Register
     AT91C_BASE_EMAC->EMAC_TBQP = (unsigned int) (txTd.td);
 }
@@ -234,18 +242,104 @@ static void EMAC_ResetRx(void)
     AT91C_BASE_EMAC->EMAC_NCR &= ~AT91C_EMAC_RE;
     // Setup the RX descriptors.
     rxTd.idx = 0;
-    for(Index = 0; Index < RX_BUFFERS; Index++) {
+    rxTd.lentIdx = 0;
+    rxTd.lent = 0;
+    for(Index = 0; Index < rxTd.nb; Index++) {
 
-        Address = (unsigned int)(&(pRxBuffer[Index * EMAC_RX_UNITSIZE]));
+        Address = (unsigned int)(&(rxTd.pBuffer[Index * EMAC_RX_UNITSIZE]));
         // Remove EMAC_RX_OWNERSHIP_BIT and EMAC_RX_WRAP_BIT
         rxTd.td[Index].addr = Address & EMAC_ADDRESS_MASK;
         rxTd.td[Index].status = 0;
     }
-    rxTd.td[RX_BUFFERS - 1].addr |= EMAC_RX_WRAP_BIT;
+    rxTd.td[rxTd.nb - 1].addr |= EMAC_RX_WRAP_BIT;
     // Receive Buffer Queue Pointer Register
     AT91C_BASE_EMAC->EMAC_RBQP = (unsigned int) (rxTd.td);
 }
 
+//-----------------------------------------------------------------------------
+/// Give back the RX descriptors to the EMAC, from the current one up to the
+/// given one (excluded).
+/// \param end  Index of the first descriptor not to be released
+//-----------------------------------------------------------------------------
+static void EMAC_ReleaseRx(unsigned short end)
+{
+    while (rxTd.idx != end) {
+
+        rxTd.td[rxTd.idx].addr &= ~(EMAC_RX_OWNERSHIP_BIT);
+        CIRC_INC(rxTd.idx, rxTd.nb);
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Look for the next complete frame in the RX descriptors. Fragments which do
+/// not belong to a frame are released. When a frame is found, it starts at
+/// the current descriptor and its descriptors are still owned by software.
+/// Descriptors lent to the application are never scanned.
+/// \param pEnd   Index of the descriptor following the end of the frame
+/// \param pSize  Frame size
+/// \return       OK or no data
+//-----------------------------------------------------------------------------
+static unsigned char EMAC_FindFrame(unsigned short *pEnd, unsigned int *pSize)
+{
+    volatile EmacRxTDescriptor *pRxTd;
+    unsigned short tmpIdx = rxTd.idx;
+    unsigned short count;
+    unsigned char isFrame = 0;
+
+    // Number of descriptors which can be scanned
+    if (rxTd.lent) {
+
+        count = CIRC_CNT(rxTd.lentIdx, rxTd.idx, rxTd.nb);
+    }
+    else {
+
+        count = rxTd.nb;
+    }
+
+    // Every descriptor is lent to the application
+    if (count == 0) {
+
+        return EMAC_RX_NO_DATA;
+    }
+
+    while (count--) {
+
+        pRxTd = rxTd.td + tmpIdx;
+        if ((pRxTd->addr & EMAC_RX_OWNERSHIP_BIT) == 0) {
+
+            return EMAC_RX_NO_DATA;
+        }
+
+        // A start of frame has been received, discard previous fragments
+        if ((pRxTd->status & EMAC_RX_SOF_BIT) == EMAC_RX_SOF_BIT) {
+
+            EMAC_ReleaseRx(tmpIdx);
+            isFrame = 1;
+        }
+
+        CIRC_INC(tmpIdx, rxTd.nb);
+
+        // SOF has not been detected, skip the fragment
+        if (!isFrame) {
+
+            EMAC_ReleaseRx(tmpIdx);
+        }
+        // An end of frame has been received
+        else if ((pRxTd->status & EMAC_RX_EOF_BIT) == EMAC_RX_EOF_BIT) {
+
+            *pEnd = tmpIdx;
+            *pSize = pRxTd->status & EMAC_LENGTH_FRAME;
+            return EMAC_RX_OK;
+        }
+    }
+
+    // All the buffers are used by a single frame
+    TRACE_INFO("no EOF (Invalid of buffers too small)\n\r");
+    EmacStatistics.rx_eof++;
+    EMAC_ReleaseRx(tmpIdx);
+    return EMAC_RX_NO_DATA;
+}
+
 //-----------------------------------------------------------------------------
 //         Exported functions
 //-----------------------------------------------------------------------------
@@ -411,19 +505,25 @@ void EMAC_Handler(void)
     volatile unsigned int tsr;
     unsigned int rxStatusFlag;
     unsigned int txStatusFlag;
+    unsigned int i;
 
     //TRACE_DEBUG("EMAC_Handler\n\r");
     isr = AT91C_BASE_EMAC->EMAC_ISR;
     rsr = AT91C_BASE_EMAC->EMAC_RSR;
     tsr = AT91C_BASE_EMAC->EMAC_TSR;
     isr &= ~(AT91C_BASE_EMAC->EMAC_IMR | 0xFFC300);
+    EmacStatistics.irqs++;
 
-    // RX packet
-    if ((isr & AT91C_EMAC_RCOMP) || (rsr & AT91C_EMAC_REC)) {
-        rxStatusFlag = AT91C_EMAC_REC;
+    // RX packet, or frame lost because of RX overrun or no RX buffer
+    if ((isr & AT91C_EMAC_RCOMP)
+        || (rsr & (AT91C_EMAC_REC | AT91C_EMAC_OVR | AT91C_EMAC_BNA))) {
+        rxStatusFlag = 0;
 
         // Frame received
-        EmacStatistics.rx_packets++;
+        if ((isr & AT91C_EMAC_RCOMP) || (rsr & AT91C_EMAC_REC)) {
+            rxStatusFlag = AT91C_EMAC_REC;
+            EmacStatistics.rx_packets++;
+        }
 
         // Check OVR
         if (rsr & AT91C_EMAC_OVR) {
@@ -442,6 +542,13 @@ void EMAC_Handler(void)
         if (rxTd.rxCb) {
             rxTd.rxCb(rxStatusFlag);
         }
+
+        // Poll mode: no more RX interrupt until the ring has been emptied
+        if ((isr & AT91C_EMAC_RCOMP) && rxTd.pollCb) {
+            AT91C_BASE_EMAC->EMAC_IDR = AT91C_EMAC_RCOMP;
+            EmacStatistics.rx_irqs++;
+            rxTd.pollCb(rxStatusFlag);
+        }
     }
 
     // TX packet
@@ -455,8 +562,8 @@ void EMAC_Handler(void)
         if (tsr & AT91C_EMAC_RLES) {
             // Status RLE & Number of discarded buffers
             txStatusFlag = AT91C_EMAC_RLES
-                         | CIRC_CNT(txTd.head, txTd.tail, TX_BUFFERS);
-            pTxCb = txTd.txCb + txTd.tail;
+                         | CIRC_CNT(txTd.head, txTd.tail, txTd.nb);
+            pTxCb = &(txTd.pInfo[txTd.tail].fCallback);
             EMAC_ResetTx();
             TRACE_INFO("Tx RLE!!\n\r");
             AT91C_BASE_EMAC->EMAC_NCR |= AT91C_EMAC_TE;
@@ -485,7 +592,7 @@ void EMAC_Handler(void)
             // Check the buffers
             do {
                 pTxTd = txTd.td + txTd.tail;
-                pTxCb = txTd.txCb + txTd.tail;
+                pTxCb = &(txTd.pInfo[txTd.tail].fCallback);
                 // Any error?
                 // Exit if buffer has not been sent yet
                 if ((pTxTd->status & EMAC_TX_USED_BIT) == 0) {
@@ -497,8 +604,15 @@ void EMAC_Handler(void)
                     (*pTxCb)(txStatusFlag);
                 }
 
-                CIRC_INC( txTd.tail, TX_BUFFERS );
-            } while (CIRC_CNT(txTd.head, txTd.tail, TX_BUFFERS));
+                // The EMAC only sets the used bit of the first TD of a frame,
+                // set it on the others so that they are not sent again
+                for (i = txTd.pInfo[txTd.tail].nb; i > 1; i--) {
+                    CIRC_INC( txTd.tail, txTd.nb );
+                    txTd.td[txTd.tail].status |= EMAC_TX_USED_BIT;
+                }
+
+                CIRC_INC( txTd.tail, txTd.nb );
+            } while (CIRC_CNT(txTd.head, txTd.tail, txTd.nb));
         }
         
         if (tsr & AT91C_EMAC_RLES) {
@@ -510,7 +624,7 @@ void EMAC_Handler(void)
         
         // If a wakeup has been scheduled, notify upper layer that it can  
         // send other packets, send will be successfull.
-        if( (CIRC_SPACE(txTd.head, txTd.tail, TX_BUFFERS) >=
+        if( (CIRC_SPACE(txTd.head, txTd.tail, txTd.nb) >=
                                             txTd.wakeupThreshold)
          &&  txTd.wakeupCb) {
             txTd.wakeupCb();
@@ -527,10 +641,9 @@ void EMAC_Handler(void)
 }
 
 //-----------------------------------------------------------------------------
-/// Initialize the EMAC with the emac controller address
+/// Initialize the EMAC with the emac controller address, using the driver
+/// default rings of RX_BUFFERS and TX_BUFFERS descriptors.
 /// \param id     HW ID for power management
-/// \param pTxWakeUpfct Thresold TX Wakeup Callback
-/// \param pRxfct       RX Wakeup Callback
 /// \param pMacAddress  Mac Address
 /// \param enableCAF    enable AT91C_EMAC_CAF if needed by application
 /// \param enableNBC    AT91C_EMAC_NBC if needed by application
@@ -538,13 +651,45 @@ void EMAC_Handler(void)
 void EMAC_Init( unsigned char id, const unsigned char *pMacAddress, 
                 unsigned char enableCAF, unsigned char enableNBC )
 {
+    EMAC_InitRings(id, pMacAddress, enableCAF, enableNBC, &defaultRings);
+}
 
+//-----------------------------------------------------------------------------
+/// Initialize the EMAC with the emac controller address and descriptor rings
+/// provided by the application, so that their depth can be sized for the
+/// traffic bursts and their memory placed in DDR.
+/// \param id     HW ID for power management
+/// \param pMacAddress  Mac Address
+/// \param enableCAF    enable AT91C_EMAC_CAF if needed by application
+/// \param enableNBC    AT91C_EMAC_NBC if needed by application
+/// \param pRings       Descriptor rings and buffers
+//-----------------------------------------------------------------------------
+void EMAC_InitRings( unsigned char id, const unsigned char *pMacAddress,
+                     unsigned char enableCAF, unsigned char enableNBC,
+                     const EmacRings *pRings )
+{
     // Check parameters
-    ASSERT(RX_BUFFERS * EMAC_RX_UNITSIZE > EMAC_FRAME_LENTGH_MAX,
+    ASSERT(pRings, "F: EMAC_InitRings\n\r");
+    ASSERT((pRings->rxNb & (pRings->rxNb - 1)) == 0,
+           "E: RX ring size MUST be 2^n\n\r");
+    ASSERT((pRings->txNb & (pRings->txNb - 1)) == 0,
+           "E: TX ring size MUST be 2^n\n\r");
+    ASSERT(pRings->rxNb * EMAC_RX_UNITSIZE > EMAC_FRAME_LENTGH_MAX,
            "E: RX buffers too small\n\r");
+    ASSERT(!pRings->pTxBuffer || (pRings->txUnitSize >= EMAC_TX_UNITSIZE),
+           "E: TX buffers too small\n\r");
 
     TRACE_DEBUG("EMAC_Init\n\r");
 
+    rxTd.td = pRings->pRxTd;
+    rxTd.pBuffer = pRings->pRxBuffer;
+    rxTd.nb = pRings->rxNb;
+    txTd.td = pRings->pTxTd;
+    txTd.pInfo = pRings->pTxInfo;
+    txTd.pBuffer = pRings->pTxBuffer;
+    txTd.nb = pRings->txNb;
+    txTd.unitSize = pRings->txUnitSize;
+
     // Power ON
     AT91C_BASE_PMC->PMC_PCER = 1 << id;
 
@@ -643,6 +788,10 @@ void EMAC_GetStatistics(EmacStats *pStats, unsigned char reset)
     ncrBackup = AT91C_BASE_EMAC->EMAC_NCR & (AT91C_EMAC_TE | AT91C_EMAC_RE);
 
 
+    // Accumulate the frames dropped by the EMAC, registers cleared on read
+    EmacStatistics.rx_resource_errs += AT91C_BASE_EMAC->EMAC_RRE;
+    EmacStatistics.rx_overrun_frames += AT91C_BASE_EMAC->EMAC_ROV;
+
     // Copy the informations
     memcpy(pStats, (void*)&EmacStatistics, sizeof(EmacStats));
 
@@ -673,11 +822,11 @@ unsigned char EMAC_Send(void *pBuffer,
     //TRACE_DEBUG("EMAC_Send\n\r");
 
     // Check parameter
-    if (size > EMAC_TX_UNITSIZE) {
+    if (size > txTd.unitSize) {
 
         TRACE_ERROR("EMAC driver does not split send packets.");
         TRACE_ERROR("%d bytes max in one packet (%d bytes requested)\n\r",
-            EMAC_TX_UNITSIZE, size);
+            txTd.unitSize, size);
         return EMAC_TX_INVALID_PACKET;
     }
 
@@ -685,7 +834,7 @@ unsigned char EMAC_Send(void *pBuffer,
     pTxTd = txTd.td + txTd.head;
 
     // If no free TxTd, buffer can't be sent, schedule the wakeup callback
-    if( CIRC_SPACE(txTd.head, txTd.tail, TX_BUFFERS) == 0) {
+    if( CIRC_SPACE(txTd.head, txTd.tail, txTd.nb) == 0) {
         if ((pTxTd->status & EMAC_TX_USED_BIT) != 0) {
             //EMAC_ResetTx();
             //TRACE_WARNING("Circ Full but FREE TD found\n\r");
@@ -697,10 +846,14 @@ unsigned char EMAC_Send(void *pBuffer,
     }
 
     // Pointers to the current TxTd
-    pTxCb = txTd.txCb + txTd.head;
+    pTxCb = &(txTd.pInfo[txTd.head].fCallback);
 
     // Sanity check
 
+    // The TD may point to a buffer given to EMAC_SendV()
+    pTxTd->addr = (unsigned int)(&(txTd.pBuffer[txTd.head * txTd.unitSize]));
+    txTd.pInfo[txTd.head].nb = 1;
+
     // Setup/Copy data to transmition buffer
     if (pBuffer && size) {
         // Driver manage the ring buffer
@@ -713,7 +866,7 @@ unsigned char EMAC_Send(void *pBuffer,
     // Update TD status
     // The buffer size defined is length of ethernet frame
     // so it's always the last buffer of the frame.
-    if (txTd.head == TX_BUFFERS-1) {
+    if (txTd.head == txTd.nb-1) {
         pTxTd->status = 
             (size & EMAC_LENGTH_FRAME) | EMAC_TX_LAST_BUFFER_BIT | EMAC_TX_WRAP_BIT;
     }
@@ -721,11 +874,116 @@ unsigned char EMAC_Send(void *pBuffer,
         pTxTd->status = (size & EMAC_LENGTH_FRAME) | EMAC_TX_LAST_BUFFER_BIT;
     }
     
-    CIRC_INC(txTd.head, TX_BUFFERS)
+    CIRC_INC(txTd.head, txTd.nb)
 
     // Tx packets count
     EmacStatistics.tx_packets++;
 
+    // Capture before the TD is given to the EMAC, which may then complete it
+    if (captureCb) {
+
+        EmacIoVec iov;
+
+        iov.pBuffer = (void *) pTxTd->addr;
+        iov.size = size;
+        captureCb(&iov, 1, size, EMAC_CAPTURE_TX);
+    }
+
+    // Now start to transmit if it is not already done
+    AT91C_BASE_EMAC->EMAC_NCR |= AT91C_EMAC_TSTART;
+
+    return EMAC_TX_OK;
+}
+
+//-----------------------------------------------------------------------------
+/// Send a packet made of several buffers with EMAC, without copying them.
+/// Each buffer is given to the EMAC through its own TD, so the buffers must
+/// not be modified until the frame has been sent; the callback is invoked
+/// once the whole frame has been processed so that the buffers can be freed.
+/// \param pIov     Array of buffers making up the frame
+/// \param count    Number of buffers in the array
+/// \param fEMAC_TxCallback Callback invoked once the frame has been sent
+/// \return         OK, Busy or invalid packet
+//-----------------------------------------------------------------------------
+unsigned char EMAC_SendV(const EmacIoVec *pIov,
+                         unsigned int count,
+                         EMAC_TxCallback fEMAC_TxCallback)
+{
+    volatile EmacTxTDescriptor *pTxTd;
+    unsigned short idx;
+    unsigned int size = 0;
+    unsigned int status;
+    unsigned int i;
+
+    ASSERT(pIov, "F: EMAC_SendV\n\r");
+
+    // Check parameters
+    for (i = 0; i < count; i++) {
+
+        if (pIov[i].size == 0) {
+
+            return EMAC_TX_INVALID_PACKET;
+        }
+        size += pIov[i].size;
+    }
+    if ((count == 0) || (count >= txTd.nb) || (size > EMAC_TX_UNITSIZE)) {
+
+        TRACE_ERROR("EMAC_SendV: %d buffers, %d bytes\n\r", count, size);
+        return EMAC_TX_INVALID_PACKET;
+    }
+
+    // Enough free TD for the whole frame?
+    if (CIRC_SPACE(txTd.head, txTd.tail, txTd.nb) < count) {
+
+        return EMAC_TX_BUFFER_BUSY;
+    }
+
+    // Setup the TDs following the first one, which is given to the EMAC last
+    // so that a partial frame is never sent
+    idx = txTd.head;
+    for (i = 1; i < count; i++) {
+
+        CIRC_INC(idx, txTd.nb);
+        pTxTd = txTd.td + idx;
+        status = pIov[i].size & EMAC_LENGTH_FRAME;
+        if (i == count - 1) {
+            status |= EMAC_TX_LAST_BUFFER_BIT;
+        }
+        if (idx == txTd.nb-1) {
+            status |= EMAC_TX_WRAP_BIT;
+        }
+        pTxTd->addr = (unsigned int) pIov[i].pBuffer;
+        pTxTd->status = status;
+        txTd.pInfo[idx].fCallback = (EMAC_TxCallback) 0;
+        txTd.pInfo[idx].nb = 1;
+    }
+
+    // First TD of the frame
+    pTxTd = txTd.td + txTd.head;
+    txTd.pInfo[txTd.head].fCallback = fEMAC_TxCallback;
+    txTd.pInfo[txTd.head].nb = count;
+    status = pIov[0].size & EMAC_LENGTH_FRAME;
+    if (count == 1) {
+        status |= EMAC_TX_LAST_BUFFER_BIT;
+    }
+    if (txTd.head == txTd.nb-1) {
+        status |= EMAC_TX_WRAP_BIT;
+    }
+    pTxTd->addr = (unsigned int) pIov[0].pBuffer;
+    pTxTd->status = status;
+
+    CIRC_INC(idx, txTd.nb);
+    txTd.head = idx;
+
+    // Tx packets count
+    EmacStatistics.tx_packets++;
+
+    // Capture before the EMAC is started, the buffers may be freed once sent
+    if (captureCb) {
+
+        captureCb(pIov, count, size, EMAC_CAPTURE_TX);
+    }
+
     // Now start to transmit if it is not already done
     AT91C_BASE_EMAC->EMAC_NCR |= AT91C_EMAC_TSTART;
 
@@ -740,9 +998,9 @@ unsigned int EMAC_TxLoad(void)
     unsigned short head = txTd.head;
     unsigned short tail = txTd.tail;
   #if 1
-    return CIRC_CNT(head, tail, TX_BUFFERS);
+    return CIRC_CNT(head, tail, txTd.nb);
   #else
-    return (TX_BUFFERS - CIRC_SPACE(head, tail, TX_BUFFERS));
+    return (txTd.nb - CIRC_SPACE(head, tail, txTd.nb));
   #endif
 }
 
@@ -759,98 +1017,217 @@ unsigned char EMAC_Poll(unsigned char *pFrame,
                         unsigned int frameSize,
                         unsigned int *pRcvSize)
 {
-    unsigned short bufferLength;
-    unsigned int   tmpFrameSize=0;
-    unsigned char  *pTmpFrame=0;
-    unsigned int   tmpIdx = rxTd.idx;
-    volatile EmacRxTDescriptor *pRxTd = rxTd.td + rxTd.idx;
+    unsigned short end;
+    unsigned int   size;
+    unsigned int   bufferLength;
+    unsigned int   tmpFrameSize = 0;
 
     ASSERT(pFrame, "F: EMAC_Poll\n\r");
 
-    char isFrame = 0;
     // Set the default return value
     *pRcvSize = 0;
 
-    // Process received RxTd
-    while ((pRxTd->addr & EMAC_RX_OWNERSHIP_BIT) == EMAC_RX_OWNERSHIP_BIT) {
+    if (EMAC_FindFrame(&end, &size) != EMAC_RX_OK) {
 
-        // A start of frame has been received, discard previous fragments
-        if ((pRxTd->status & EMAC_RX_SOF_BIT) == EMAC_RX_SOF_BIT) {
-            // Skip previous fragment
-            while (tmpIdx != rxTd.idx) {
-                pRxTd = rxTd.td + rxTd.idx;
-                pRxTd->addr &= ~(EMAC_RX_OWNERSHIP_BIT);
-                CIRC_INC(rxTd.idx, RX_BUFFERS);
-            }
-            // Reset the temporary frame pointer
-            pTmpFrame = pFrame;
-            tmpFrameSize = 0;
-            // Start to gather buffers in a frame
-            isFrame = 1;
-        }
+        return EMAC_RX_NO_DATA;
+    }
+    TRACE_DEBUG("packet %d-%d (%d)\n\r", rxTd.idx, end, size);
+    *pRcvSize = size;
 
-        // Increment the pointer
-        CIRC_INC(tmpIdx, RX_BUFFERS);
+    // Copy the buffers into the application frame, and release them
+    while (rxTd.idx != end) {
 
-        // Copy data in the frame buffer
-        if (isFrame) {
-            if (tmpIdx == rxTd.idx) {
-                TRACE_INFO("no EOF (Invalid of buffers too small)\n\r");
+        bufferLength = min(EMAC_RX_UNITSIZE, frameSize - tmpFrameSize);
+        bufferLength = min(bufferLength, size - tmpFrameSize);
+        memcpy(pFrame + tmpFrameSize,
+               (void *)(rxTd.td[rxTd.idx].addr & EMAC_ADDRESS_MASK),
+               bufferLength);
+        tmpFrameSize += bufferLength;
 
-                do {
+        rxTd.td[rxTd.idx].addr &= ~(EMAC_RX_OWNERSHIP_BIT);
+        CIRC_INC(rxTd.idx, rxTd.nb);
+    }
+    EmacStatistics.rx_packets++;
 
-                    pRxTd = rxTd.td + rxTd.idx;
-                    pRxTd->addr &= ~(EMAC_RX_OWNERSHIP_BIT);
-                    CIRC_INC(rxTd.idx, RX_BUFFERS);
-                } while(tmpIdx != rxTd.idx);
-                return EMAC_RX_NO_DATA;
-            }
-            // Copy the buffer into the application frame
-            bufferLength = EMAC_RX_UNITSIZE;
-            if ((tmpFrameSize + bufferLength) > frameSize) {
-                bufferLength = frameSize - tmpFrameSize;
-            }
+    if (captureCb) {
 
-            memcpy(pTmpFrame, (void*)(pRxTd->addr & EMAC_ADDRESS_MASK), bufferLength);
-            pTmpFrame += bufferLength;
-            tmpFrameSize += bufferLength;
-            
-            // An end of frame has been received, return the data
-            if ((pRxTd->status & EMAC_RX_EOF_BIT) == EMAC_RX_EOF_BIT) {
-                // Frame size from the EMAC
-                *pRcvSize = (pRxTd->status & EMAC_LENGTH_FRAME);
-                
-                // Application frame buffer is too small all data have not been copied
-                if (tmpFrameSize < *pRcvSize) {
-                    printf("size req %d size allocated %d\n\r", *pRcvSize, frameSize);
-                    
-                    return EMAC_RX_FRAME_SIZE_TOO_SMALL;
-                }
-                
-                TRACE_DEBUG("packet %d-%d (%d)\n\r", rxTd.idx, tmpIdx, *pRcvSize);
-                // All data have been copied in the application frame buffer => release TD
-                while (rxTd.idx != tmpIdx) {
-                    pRxTd = rxTd.td + rxTd.idx;
-                    pRxTd->addr &= ~(EMAC_RX_OWNERSHIP_BIT);
-                    CIRC_INC(rxTd.idx, RX_BUFFERS);
-                }
-                EmacStatistics.rx_packets++;
-                return EMAC_RX_OK;
+        EmacIoVec iov;
+
+        // Only what has been copied, with the length of the whole frame
+        iov.pBuffer = pFrame;
+        iov.size = tmpFrameSize;
+        captureCb(&iov, 1, size, EMAC_CAPTURE_RX);
+    }
+
+    // Application frame buffer is too small all data have not been copied
+    if (tmpFrameSize < size) {
+
+        TRACE_WARNING("size req %d size allocated %d\n\r", size, frameSize);
+        return EMAC_RX_FRAME_SIZE_TOO_SMALL;
+    }
+    return EMAC_RX_OK;
+}
+
+//-----------------------------------------------------------------------------
+/// Receive a packet with EMAC without copying it. The frame is left in the
+/// receive buffers, which are lent to the application until the frame is
+/// given back with EMAC_ReleaseFrame(). The receive buffers form a ring, so the
+/// frame data is made of one segment, or two when it wraps at the end of the
+/// ring. The frames must be released in the order they have been received;
+/// while they are lent, the EMAC has less buffers to receive into.
+/// \param pFrame   Pointer to the frame descriptor to fill
+/// \return         OK or no data
+//-----------------------------------------------------------------------------
+unsigned char EMAC_PollFrame(EmacFrame *pFrame)
+{
+    unsigned short end;
+    unsigned int   size;
+    unsigned int   firstSize;
+
+    ASSERT(pFrame, "F: EMAC_PollFrame\n\r");
+
+    if (EMAC_FindFrame(&end, &size) != EMAC_RX_OK) {
+
+        return EMAC_RX_NO_DATA;
+    }
+    TRACE_DEBUG("lent %d-%d (%d)\n\r", rxTd.idx, end, size);
+
+    pFrame->first = rxTd.idx;
+    pFrame->count = CIRC_CNT(end, rxTd.idx, rxTd.nb);
+    pFrame->size = size;
+
+    // Data is contiguous up to the end of the ring
+    firstSize = (rxTd.nb - rxTd.idx) * EMAC_RX_UNITSIZE;
+    pFrame->pData[0] = (unsigned char *)(rxTd.td[rxTd.idx].addr & EMAC_ADDRESS_MASK);
+    if (size <= firstSize) {
+
+        pFrame->length[0] = size;
+        pFrame->pData[1] = 0;
+        pFrame->length[1] = 0;
+    }
+    else {
+
+        pFrame->length[0] = firstSize;
+        pFrame->pData[1] = (unsigned char *)(rxTd.td[0].addr & EMAC_ADDRESS_MASK);
+        pFrame->length[1] = size - firstSize;
+    }
+
+    // Keep the descriptors owned by software
+    if (rxTd.lent == 0) {
+
+        rxTd.lentIdx = rxTd.idx;
+    }
+    rxTd.lent += pFrame->count;
+    rxTd.idx = end;
+
+    EmacStatistics.rx_packets++;
+
+    if (captureCb) {
+
+        EmacIoVec iov[2];
+
+        iov[0].pBuffer = pFrame->pData[0];
+        iov[0].size = pFrame->length[0];
+        iov[1].pBuffer = pFrame->pData[1];
+        iov[1].size = pFrame->length[1];
+        captureCb(iov, pFrame->length[1] ? 2 : 1, size, EMAC_CAPTURE_RX);
+    }
+    return EMAC_RX_OK;
+}
+
+//-----------------------------------------------------------------------------
+/// Give back to the EMAC the receive buffers of a frame returned by
+/// EMAC_PollFrame(). The oldest frame must be released first.
+/// \param pFrame   Pointer to the frame descriptor
+//-----------------------------------------------------------------------------
+void EMAC_ReleaseFrame(const EmacFrame *pFrame)
+{
+    unsigned short count;
+    unsigned short idx;
+
+    ASSERT(pFrame, "F: EMAC_ReleaseFrame\n\r");
+    ASSERT(rxTd.lent && (pFrame->first == rxTd.lentIdx),
+           "E: Frames shall be released in order\n\r");
+
+    idx = pFrame->first;
+    for (count = 0; count < pFrame->count; count++) {
+
+        rxTd.td[idx].addr &= ~(EMAC_RX_OWNERSHIP_BIT);
+        CIRC_INC(idx, rxTd.nb);
+    }
+    rxTd.lentIdx = idx;
+    rxTd.lent -= pFrame->count;
+}
+
+//-----------------------------------------------------------------------------
+/// Enables the budgeted poll mode for reception. On a frame reception, the
+/// RX interrupt is masked and pPollCb() is invoked from the interrupt
+/// handler to schedule EMAC_RxPoll(). The interrupt is enabled again by
+/// EMAC_RxPoll() once the receive ring is empty, so that no interrupt is taken
+/// for the frames received while polling.
+/// \param pPollCb          Pointer to callback function, 0 to disable the mode
+//-----------------------------------------------------------------------------
+void EMAC_Set_RxPollCb(EMAC_RxCallback pPollCb)
+{
+    rxTd.pollCb = pPollCb;
+    if (pPollCb) {
+        AT91C_BASE_EMAC->EMAC_IER = AT91C_EMAC_RCOMP;
+    }
+    else if (!rxTd.rxCb) {
+        AT91C_BASE_EMAC->EMAC_IDR = AT91C_EMAC_RCOMP;
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Processes up to budget received frames in poll mode. Each frame is given
+/// in place to fFrameCb(), then its buffers are released. When the ring is
+/// empty before the budget is exhausted, the RX interrupt is enabled again;
+/// otherwise the caller shall call EMAC_RxPoll() again.
+/// \param fFrameCb         Function processing a received frame
+/// \param budget           Maximum number of frames to process
+/// \return                 Number of frames processed
+//-----------------------------------------------------------------------------
+unsigned int EMAC_RxPoll(EMAC_FrameCallback fFrameCb, unsigned int budget)
+{
+    EmacFrame frame;
+    unsigned int done = 0;
+
+    ASSERT(fFrameCb, "F: EMAC_RxPoll\n\r");
+
+    EmacStatistics.rx_polls++;
+
+    while (done < budget) {
+
+        if (EMAC_PollFrame(&frame) != EMAC_RX_OK) {
+
+            // Ring empty, back to interrupt mode. RCOMP is still latched
+            // for the frames processed while polling: clear it first so that
+            // enabling the interrupt does not raise it at once. A TX
+            // completion read away here is still reported by TSR.
+            AT91C_BASE_EMAC->EMAC_ISR;
+            AT91C_BASE_EMAC->EMAC_IER = AT91C_EMAC_RCOMP;
+
+            // A frame completed before the interrupt was enabled may not
+            // raise it, schedule another poll
+            if ((rxTd.td[rxTd.idx].addr & EMAC_RX_OWNERSHIP_BIT)
+                && rxTd.pollCb) {
+
+                AT91C_BASE_EMAC->EMAC_IDR = AT91C_EMAC_RCOMP;
+                rxTd.pollCb(AT91C_EMAC_REC);
             }
+            break;
         }
-        
-        // SOF has not been detected, skip the fragment
-        else {
-           pRxTd->addr &= ~(EMAC_RX_OWNERSHIP_BIT);
-           rxTd.idx = tmpIdx;
-        }
-       
-        // Process the next buffer
-        pRxTd = rxTd.td + tmpIdx;
+
+        fFrameCb(&frame);
+        EMAC_ReleaseFrame(&frame);
+        done++;
     }
-    
-    //TRACE_DEBUG("E");
-    return EMAC_RX_NO_DATA;
+
+    EmacStatistics.rx_poll_frames += done;
+    if (done == budget) {
+        EmacStatistics.rx_poll_exhausts++;
+    }
+    return done;
 }
 
 //-----------------------------------------------------------------------------
@@ -875,7 +1252,9 @@ void EMAC_Set_RxCb(EMAC_RxCallback pRxCb)
 //-----------------------------------------------------------------------------
 void EMAC_Clear_RxCb(void)
 {
-    AT91C_BASE_EMAC->EMAC_IDR = AT91C_EMAC_RCOMP; 
+    if (!rxTd.pollCb) {
+        AT91C_BASE_EMAC->EMAC_IDR = AT91C_EMAC_RCOMP; 
+    }
     rxTd.rxCb = (EMAC_RxCallback) 0;
 }
 
@@ -893,7 +1272,7 @@ void EMAC_Clear_RxCb(void)
 //-----------------------------------------------------------------------------
 char EMAC_Set_TxWakeUpCb(EMAC_WakeupCallback pTxWakeUpCb, unsigned short threshold)
 {
-    if (threshold <= TX_BUFFERS) {
+    if (threshold <= txTd.nb) {
         txTd.wakeupCb = pTxWakeUpCb;
         txTd.wakeupThreshold = threshold;
         return 0;
@@ -910,5 +1289,17 @@ void EMAC_Clear_TxWakeUpCb(void)
 {
     txTd.wakeupCb = (EMAC_WakeupCallback) 0;
 }
+
+//-----------------------------------------------------------------------------
+/// Registers a callback given every frame sent by EMAC_Send()/EMAC_SendV() and
+/// received by EMAC_Poll()/EMAC_PollFrame(), in the context of these
+/// functions. TX frames are given once queued, RX frames once taken from the
+/// ring. When no callback is registered, the cost is a single test.
+/// \param pCaptureCb    Pointer to callback function, 0 to disable capture
+//-----------------------------------------------------------------------------
+void EMAC_Set_CaptureCb(EMAC_CaptureCallback pCaptureCb)
+{
+    captureCb = pCaptureCb;
+}
     
 
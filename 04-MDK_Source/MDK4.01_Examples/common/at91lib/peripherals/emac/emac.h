@@ -40,13 +40,24 @@
 ///     
 /// !Usage
 ///
-/// -# Initialize EMAC with EMAC_Init with MAC address.
+/// -# Initialize EMAC with EMAC_Init with MAC address, or with EMAC_InitRings
+///    to provide descriptor rings sized by the application.
 /// -# Then the caller application need to initialize the PHY driver before further calling EMAC
 ///      driver.
 /// -# Get a packet from network
 ///      -# Interrupt mode: EMAC_Set_RxCb to register a function to process the frame packet
 ///      -# Polling mode: EMAC_Poll for a data packet from network 
-/// -# Send a packet to network with EMAC_Send.
+///      -# Zero-copy polling mode: EMAC_PollFrame returns a frame left in the
+///         receive buffers, processed in place then given back with
+///         EMAC_ReleaseFrame
+///      -# Budgeted poll mode: EMAC_Set_RxPollCb registers a function called
+///         on the first RX interrupt to schedule EMAC_RxPoll, which processes
+///         a budget of frames per call; the RX interrupt stays masked until
+///         the ring is empty
+/// -# Send a packet to network with EMAC_Send, or with EMAC_SendV when the
+///    packet is made of several buffers which shall not be copied.
+/// -# Optionally, EMAC_Set_CaptureCb registers a function which is given
+///    every frame sent or received, e.g. to record a packet capture.
 ///
 /// Please refer to the list of functions in the #Overview# tab of this unit
 /// for more detailed information.
@@ -73,13 +84,17 @@
     #endif
 #endif
 
-/// Number of buffer for RX, be carreful: MUST be 2^n
+/// Number of buffer for RX used by EMAC_Init, be carreful: MUST be 2^n
+#if !defined(RX_BUFFERS)
 #define RX_BUFFERS  16
-/// Number of buffer for TX, be carreful: MUST be 2^n
+#endif
+/// Number of buffer for TX used by EMAC_Init, be carreful: MUST be 2^n
+#if !defined(TX_BUFFERS)
 #define TX_BUFFERS   8
+#endif
 
 /// Buffer Size
-#define EMAC_RX_UNITSIZE            128     /// Fixed size for RX buffer
+#define EMAC_RX_UNITSIZE            128     /// Fixed size for RX buffer (set by the EMAC)
 #define EMAC_TX_UNITSIZE            1518    /// Size for ETH frame length
 
 // The MAC can support frame lengths up to 1536 bytes.
@@ -107,9 +122,106 @@ typedef struct _EmacStats {
     unsigned int rx_eof;        /// No EOF error
     unsigned int rx_ovrs;       /// Over Run, not able to store to memory
     unsigned int rx_bnas;       /// Buffer is not available
+    unsigned int rx_resource_errs;  /// Frames dropped, no RX buffer available
+    unsigned int rx_overrun_frames; /// Frames dropped, RX DMA overrun
+    // Interrupts and poll mode
+    unsigned int irqs;          /// EMAC interrupts handled
+    unsigned int rx_irqs;       /// RX interrupts which scheduled a poll
+    unsigned int rx_polls;      /// Calls to EMAC_RxPoll
+    unsigned int rx_poll_frames;    /// Frames processed by EMAC_RxPoll
+    unsigned int rx_poll_exhausts;  /// Polls which exhausted their budget
 
 } EmacStats, *PEmacStats;
 
+/// Callback used by send function
+typedef void (*EMAC_TxCallback)(unsigned int status);
+typedef void (*EMAC_RxCallback)(unsigned int status);
+typedef void (*EMAC_WakeupCallback)(void);
+
+#ifdef __ICCARM__          // IAR
+#pragma pack(4)            // IAR
+#define __attribute__(...) // IAR
+#endif                     // IAR
+/// Describes the type and attribute of Receive Transfer descriptor.
+typedef struct _EmacRxTDescriptor {
+    unsigned int addr;
+    unsigned int status;
+} __attribute__((packed, aligned(8))) EmacRxTDescriptor, *PEmacRxTDescriptor;
+
+/// Describes the type and attribute of Transmit Transfer descriptor.
+typedef struct _EmacTxTDescriptor {
+    unsigned int addr;
+    unsigned int status;
+} __attribute__((packed, aligned(8))) EmacTxTDescriptor, *PEmacTxTDescriptor;
+#ifdef __ICCARM__          // IAR
+#pragma pack()             // IAR
+#endif                     // IAR
+
+/// Software information kept by the driver for each TX descriptor.
+typedef struct _EmacTxInfo {
+
+    EMAC_TxCallback fCallback;  /// Callback invoked once the frame is sent
+    unsigned char nb;           /// Number of TD of the frame starting here
+
+} EmacTxInfo;
+
+//-----------------------------------------------------------------------------
+/// Descriptor rings and buffers given to EMAC_InitRings(). The descriptors
+/// and RX buffers shall be aligned on 8 bytes, and the numbers of descriptors
+/// MUST be 2^n. pTxBuffer may be 0 with txUnitSize 0 when only EMAC_SendV()
+/// is used.
+//-----------------------------------------------------------------------------
+typedef struct _EmacRings {
+
+    EmacRxTDescriptor *pRxTd;   /// RX descriptors (rxNb)
+    unsigned char *pRxBuffer;   /// RX buffers (rxNb * EMAC_RX_UNITSIZE bytes)
+    unsigned short rxNb;        /// Number of RX descriptors
+    EmacTxTDescriptor *pTxTd;   /// TX descriptors (txNb)
+    EmacTxInfo *pTxInfo;        /// TX descriptors information (txNb)
+    unsigned char *pTxBuffer;   /// TX buffers (txNb * txUnitSize bytes)
+    unsigned short txNb;        /// Number of TX descriptors
+    unsigned short txUnitSize;  /// Size of a TX buffer, EMAC_TX_UNITSIZE min
+
+} EmacRings;
+
+//-----------------------------------------------------------------------------
+/// Describes a received frame lent to the application by EMAC_PollFrame().
+/// The frame data is one segment, or two when the frame wraps at the end of
+/// the receive buffer ring.
+//-----------------------------------------------------------------------------
+typedef struct _EmacFrame {
+
+    unsigned char *pData[2];    /// Frame data segments
+    unsigned int length[2];     /// Length of each segment, 0 if unused
+    unsigned int size;          /// Frame size
+    unsigned short first;       /// First RX descriptor of the frame
+    unsigned short count;       /// Number of RX descriptors of the frame
+
+} EmacFrame;
+
+/// Callback processing a frame in poll mode
+typedef void (*EMAC_FrameCallback)(const EmacFrame *pFrame);
+
+//-----------------------------------------------------------------------------
+/// Describes one of the buffers making up a frame sent by EMAC_SendV().
+//-----------------------------------------------------------------------------
+typedef struct _EmacIoVec {
+
+    void *pBuffer;              /// Buffer address
+    unsigned int size;          /// Buffer size
+
+} EmacIoVec;
+
+/// Callback given the buffers of a frame sent or received, and the length of
+/// the frame on the wire, which the buffers may not hold entirely
+typedef void (*EMAC_CaptureCallback)(const EmacIoVec *pIov,
+                                     unsigned int count,
+                                     unsigned int frameLength,
+                                     unsigned char direction);
+/// Direction of a captured frame
+#define EMAC_CAPTURE_RX     0
+#define EMAC_CAPTURE_TX     1
+
 //-----------------------------------------------------------------------------
 //         PHY Exported functions
 //-----------------------------------------------------------------------------
@@ -139,13 +251,12 @@ extern void EMAC_SetLinkSpeed(unsigned char speed,
 //-----------------------------------------------------------------------------
 //         EMAC Exported functions
 //-----------------------------------------------------------------------------
-/// Callback used by send function
-typedef void (*EMAC_TxCallback)(unsigned int status);
-typedef void (*EMAC_RxCallback)(unsigned int status);
-typedef void (*EMAC_WakeupCallback)(void);
-
 extern void EMAC_Init( unsigned char id, const unsigned char *pMacAddress,
                 unsigned char enableCAF, unsigned char enableNBC );
+
+extern void EMAC_InitRings( unsigned char id, const unsigned char *pMacAddress,
+                unsigned char enableCAF, unsigned char enableNBC,
+                const EmacRings *pRings );
 #define EMAC_CAF_DISABLE  0
 #define EMAC_CAF_ENABLE   1
 #define EMAC_NBC_DISABLE  0
@@ -163,6 +274,10 @@ extern unsigned char EMAC_Send(void *pBuffer,
 #define EMAC_TX_BUFFER_BUSY            1
 #define EMAC_TX_INVALID_PACKET         2
 
+extern unsigned char EMAC_SendV(const EmacIoVec *pIov,
+                                unsigned int count,
+                                EMAC_TxCallback fEMAC_TxCallback);
+
 
 extern unsigned char EMAC_Poll(unsigned char *pFrame,
                                unsigned int frameSize,
@@ -172,7 +287,18 @@ extern unsigned char EMAC_Poll(unsigned char *pFrame,
 #define EMAC_RX_NO_DATA              1
 #define EMAC_RX_FRAME_SIZE_TOO_SMALL 2
 
+extern unsigned char EMAC_PollFrame(EmacFrame *pFrame);
+
+extern void EMAC_ReleaseFrame(const EmacFrame *pFrame);
+
+extern void EMAC_Set_RxPollCb(EMAC_RxCallback pPollCb);
+
+extern unsigned int EMAC_RxPoll(EMAC_FrameCallback fFrameCb,
+                                unsigned int budget);
+
 extern void EMAC_GetStatistics(EmacStats *pStats, unsigned char reset);
 
+extern void EMAC_Set_CaptureCb(EMAC_CaptureCallback pCaptureCb);
+
 #endif // #ifndef EMAC_H
 
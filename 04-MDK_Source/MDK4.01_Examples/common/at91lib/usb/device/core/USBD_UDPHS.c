@@ -67,6 +67,13 @@
 /// Max size of the FMA FIFO
 #define DMA_MAX_FIFO_SIZE     65536
 
+/// Number of linked DMA descriptors per endpoint. An IN transfer of up to
+/// UDPHS_DMA_DESCRIPTORS * DMA_MAX_FIFO_SIZE bytes runs as a single chained
+/// DMA job, with one interrupt at its end.
+#ifndef UDPHS_DMA_DESCRIPTORS
+    #define UDPHS_DMA_DESCRIPTORS   8
+#endif
+
 #define EPT_VIRTUAL_SIZE      16384
 
 //------------------------------------------------------------------------------
@@ -131,12 +138,32 @@ typedef struct
     unsigned char  sendZLP;
 } Endpoint;
 
+//------------------------------------------------------------------------------
+/// UDPHS DMA channel transfer descriptor, as fetched by the controller when
+/// LDNXT_DSC is set.
+//------------------------------------------------------------------------------
+typedef struct
+{
+    /// Address of the next descriptor (UDPHS_DMANXTDSC).
+    unsigned int nextDescriptor;
+    /// Address of the data buffer (UDPHS_DMAADDRESS).
+    unsigned int bufferAddress;
+    /// Channel control word (UDPHS_DMACONTROL).
+    unsigned int control;
+    /// Unused, keeps descriptors 16-byte aligned.
+    unsigned int reserved;
+} __attribute__((aligned(16))) UdphsDmaDescriptor;
+
 //------------------------------------------------------------------------------
 //         Internal variables
 //------------------------------------------------------------------------------
 
 /// Holds the internal state for each endpoint of the UDP.
 static Endpoint      endpoints[BOARD_USB_NUMENDPOINTS];
+#ifdef DMA
+/// DMA descriptor list of each endpoint.
+static UdphsDmaDescriptor dmaDescriptors[BOARD_USB_NUMENDPOINTS][UDPHS_DMA_DESCRIPTORS];
+#endif
 /// Device current state.
 static unsigned char deviceState;
 /// Indicates the previous device state
@@ -574,6 +601,97 @@ static void UDPHS_EndpointHandler( unsigned char bEndpoint )
 
 }
 
+#ifdef DMA
+//------------------------------------------------------------------------------
+/// Links the remaining data of the current transfer into the DMA descriptor
+/// list of the endpoint and starts the channel on it.
+/// Every descriptor but the last one moves DMA_MAX_FIFO_SIZE bytes, a
+/// multiple of any packet size, so only the last packet of an IN list is
+/// short. Only the last descriptor raises an interrupt.
+/// OUT transfers use a single descriptor per interrupt: a short packet
+/// closes the buffer but does not stop a linked list, which would load the
+/// next descriptor and lose the count of the closed one.
+/// \param bEndpoint Index of endpoint
+//------------------------------------------------------------------------------
+static void UDPHS_DmaStart( unsigned char bEndpoint )
+{
+    Endpoint           *pEndpoint = &(endpoints[bEndpoint]);
+    Transfer           *pTransfer = &(pEndpoint->transfer);
+    UdphsDmaDescriptor *pDescriptor = dmaDescriptors[bEndpoint];
+    unsigned int        address;
+    int                 size;
+    int                 length;
+
+    // Chain as much data as the descriptor list can hold, or as one
+    // descriptor holds for an OUT transfer
+    size = pTransfer->remaining;
+    if( pEndpoint->state == UDP_ENDPOINT_RECEIVING ) {
+
+        if( size > DMA_MAX_FIFO_SIZE ) {
+
+            size = DMA_MAX_FIFO_SIZE;
+        }
+    }
+    else if( size > (UDPHS_DMA_DESCRIPTORS * DMA_MAX_FIFO_SIZE) ) {
+
+        size = UDPHS_DMA_DESCRIPTORS * DMA_MAX_FIFO_SIZE;
+    }
+    pTransfer->buffered = size;
+    address = (unsigned int)((pTransfer->pData) + (pTransfer->transferred));
+
+    TRACE_DEBUG_WP("\n\r_DMA:%d ", pTransfer->remaining );
+    TRACE_DEBUG_WP("B:%d ", pTransfer->buffered );
+    TRACE_DEBUG_WP("T:%d ", pTransfer->transferred );
+
+    while( 1 ) {
+
+        length = size;
+        if( length > DMA_MAX_FIFO_SIZE ) {
+
+            length = DMA_MAX_FIFO_SIZE;
+        }
+        size -= length;
+
+        // A length of DMA_MAX_FIFO_SIZE is coded as 0
+        pDescriptor->bufferAddress = address;
+        pDescriptor->control = ((length << 16) & AT91C_UDPHS_BUFF_COUNT)
+                               | AT91C_UDPHS_END_B_EN
+                               | AT91C_UDPHS_CHANN_ENB;
+        address += length;
+
+        if( size == 0 ) {
+
+            // Last descriptor: stop the channel and raise the interrupt
+            pDescriptor->nextDescriptor = 0;
+            pDescriptor->control |= AT91C_UDPHS_END_BUFFIT;
+            if( pEndpoint->state == UDP_ENDPOINT_RECEIVING ) {
+
+                // A short packet ends the transfer
+                pDescriptor->control |= AT91C_UDPHS_END_TR_EN
+                                        | AT91C_UDPHS_END_TR_IT;
+            }
+            break;
+        }
+
+        // Link the next descriptor at end of buffer
+        pDescriptor->nextDescriptor = (unsigned int)(pDescriptor + 1);
+        pDescriptor->control |= AT91C_UDPHS_LDNXT_DSC;
+        pDescriptor++;
+    }
+
+    // Clear unwanted interrupts
+    AT91C_BASE_UDPHS->UDPHS_DMA[bEndpoint].UDPHS_DMASTATUS;
+    // Enable DMA endpoint interrupt
+    AT91C_BASE_UDPHS->UDPHS_IEN |= (1 << SHIFT_DMA << bEndpoint);
+
+    // Load the first descriptor now, the list then runs on its own
+    AT91C_BASE_UDPHS->UDPHS_DMA[bEndpoint].UDPHS_DMACONTROL = 0; // raz
+    AT91C_BASE_UDPHS->UDPHS_DMA[bEndpoint].UDPHS_DMANXTDSC =
+        (unsigned int) dmaDescriptors[bEndpoint];
+    AT91C_BASE_UDPHS->UDPHS_DMA[bEndpoint].UDPHS_DMACONTROL = AT91C_UDPHS_LDNXT_DSC;
+}
+#endif
+
 //------------------------------------------------------------------------------
 //      Interrupt service routine
 //------------------------------------------------------------------------------
@@ -588,78 +706,61 @@ static void UDPHS_DmaHandler( unsigned char bEndpoint )
     Endpoint     *pEndpoint = &(endpoints[bEndpoint]);
     Transfer     *pTransfer = &(pEndpoint->transfer);
     int           justTransferred;
+    int           untransferred;
     unsigned int  status;
     unsigned char result = USBD_STATUS_SUCCESS;
 
     status = AT91C_BASE_UDPHS->UDPHS_DMA[bEndpoint].UDPHS_DMASTATUS;
     TRACE_DEBUG_WP("Dma Ept%d ", bEndpoint);
 
-    // Disable DMA interrupt to avoid receiving 2 interrupts (B_EN and TR_EN)
-    AT91C_BASE_UDPHS->UDPHS_DMA[bEndpoint].UDPHS_DMACONTROL &=
-        ~(AT91C_UDPHS_END_TR_EN | AT91C_UDPHS_END_B_EN);
+    // The list or the OUT buffer ended: stop the channel so that it does
+    // not load anything else
+    AT91C_BASE_UDPHS->UDPHS_DMA[bEndpoint].UDPHS_DMACONTROL = 0;
 
     AT91C_BASE_UDPHS->UDPHS_IEN &= ~(1 << SHIFT_DMA << bEndpoint);
 
-    if( AT91C_UDPHS_END_BF_ST == (status & AT91C_UDPHS_END_BF_ST) ) {
+    if( 0 != (status & (AT91C_UDPHS_END_BF_ST | AT91C_UDPHS_END_TR_ST)) ) {
+
+        // An IN list always runs to its end. An OUT buffer holds
+        // BUFF_COUNT untransmitted bytes; a count of 0 for a buffer that
+        // did not end stands for DMA_MAX_FIFO_SIZE, when nothing came.
+        untransferred = 0;
+        if( pEndpoint->state == UDP_ENDPOINT_RECEIVING ) {
 
-        TRACE_DEBUG_WP("EndBuffer ");
+            untransferred = (status & AT91C_UDPHS_BUFF_COUNT) >> 16;
+            if( (untransferred == 0)
+                && ((status & AT91C_UDPHS_END_BF_ST) == 0) ) {
 
-        // BUFF_COUNT holds the number of untransmitted bytes.
-        // BUFF_COUNT is equal to zero in case of good transfer
-        justTransferred = pTransfer->buffered
-                                 - ((status & AT91C_UDPHS_BUFF_COUNT) >> 16);
+                untransferred = pTransfer->buffered;
+            }
+        }
+        justTransferred = pTransfer->buffered - untransferred;
         pTransfer->transferred += justTransferred;
+        pTransfer->remaining -= justTransferred;
+        pTransfer->buffered = 0;
 
-        pTransfer->buffered = ((status & AT91C_UDPHS_BUFF_COUNT) >> 16);
+        if( AT91C_UDPHS_END_TR_ST == (status & AT91C_UDPHS_END_TR_ST) ) {
 
-        pTransfer->remaining -= justTransferred;
+            // Short packet received, the transfer ends here
+            TRACE_DEBUG_WP("EndTransf ");
+            pTransfer->remaining = 0;
+        }
+        else {
+
+            TRACE_DEBUG_WP("EndBuffer ");
+        }
 
         TRACE_DEBUG_WP("\n\r1pTransfer->buffered %d \n\r", pTransfer->buffered);
         TRACE_DEBUG_WP("1pTransfer->transferred %d \n\r", pTransfer->transferred);
         TRACE_DEBUG_WP("1pTransfer->remaining %d \n\r", pTransfer->remaining);
 
-        if( (pTransfer->remaining + pTransfer->buffered) > 0 ) {
-
-            // Prepare an other transfer
-            if( pTransfer->remaining > DMA_MAX_FIFO_SIZE ) {
-
-                pTransfer->buffered = DMA_MAX_FIFO_SIZE;    
-            }
-            else {
-                pTransfer->buffered = pTransfer->remaining;
-            }
-
-            AT91C_BASE_UDPHS->UDPHS_DMA[bEndpoint].UDPHS_DMAADDRESS = 
-                (unsigned int)((pTransfer->pData) + (pTransfer->transferred));
-
-            // Clear unwanted interrupts
-            AT91C_BASE_UDPHS->UDPHS_DMA[bEndpoint].UDPHS_DMASTATUS;
-
-            // Enable DMA endpoint interrupt
-            AT91C_BASE_UDPHS->UDPHS_IEN |= (1 << SHIFT_DMA << bEndpoint);
-            // DMA config for receive the good size of buffer, or an error buffer
+        // Transfer larger than the descriptor list or the OUT buffer:
+        // start the next part
+        if( pTransfer->remaining > 0 ) {
 
-            AT91C_BASE_UDPHS->UDPHS_DMA[bEndpoint].UDPHS_DMACONTROL = 0; // raz
-            AT91C_BASE_UDPHS->UDPHS_DMA[bEndpoint].UDPHS_DMACONTROL =
-                                     ( ((pTransfer->buffered << 16) & AT91C_UDPHS_BUFF_COUNT)
-                                       | AT91C_UDPHS_END_TR_EN
-                                       | AT91C_UDPHS_END_TR_IT
-                                       | AT91C_UDPHS_END_B_EN
-                                       | AT91C_UDPHS_END_BUFFIT
-                                       | AT91C_UDPHS_CHANN_ENB );
+            UDPHS_DmaStart(bEndpoint);
         }
     }
-    else if( AT91C_UDPHS_END_TR_ST == (status & AT91C_UDPHS_END_TR_ST) ) {
-
-        TRACE_DEBUG_WP("EndTransf ");
-
-        pTransfer->transferred = pTransfer->buffered
-                                 - ((status & AT91C_UDPHS_BUFF_COUNT) >> 16);
-        pTransfer->remaining = 0;
-        TRACE_DEBUG_WP("\n\r0pTransfer->buffered %d \n\r", pTransfer->buffered);
-        TRACE_DEBUG_WP("0pTransfer->transferred %d \n\r", pTransfer->transferred);
-        TRACE_DEBUG_WP("0pTransfer->remaining %d \n\r", pTransfer->remaining);
-    }
     else {
 
         TRACE_ERROR("UDPHS_DmaHandler: Error (0x%08X)\n\r", status);
@@ -1060,6 +1161,9 @@ char USBD_Write( unsigned char    bEndpoint,
 
         if( pTransfer->remaining == 0 ) {
             // DMA not handle ZLP
+            // The ZLP is validated here, so the endpoint handler must end
+            // the transfer once it is sent instead of sending another one
+            pEndpoint->sendZLP = 2;
             AT91C_BASE_UDPHS->UDPHS_EPT[bEndpoint].UDPHS_EPTSETSTA = AT91C_UDPHS_TX_PK_RDY;
             // Enable endpoint IT
             AT91C_BASE_UDPHS->UDPHS_IEN |= (1 << SHIFT_INTERUPT << bEndpoint);
@@ -1067,33 +1171,7 @@ char USBD_Write( unsigned char    bEndpoint,
         }
         else {
             // Others endpoints (not control)
-            if( pTransfer->remaining > DMA_MAX_FIFO_SIZE ) {
-
-                // Transfer the max
-                pTransfer->buffered = DMA_MAX_FIFO_SIZE;    
-            }
-            else {
-                // Transfer the good size
-                pTransfer->buffered = pTransfer->remaining;
-            }
-
-            TRACE_DEBUG_WP("\n\r_WR:%d ", pTransfer->remaining );
-            TRACE_DEBUG_WP("B:%d ", pTransfer->buffered );
-            TRACE_DEBUG_WP("T:%d ", pTransfer->transferred );
-
-            AT91C_BASE_UDPHS->UDPHS_DMA[bEndpoint].UDPHS_DMAADDRESS = (unsigned int)(pTransfer->pData);
-
-            // Clear unwanted interrupts
-            AT91C_BASE_UDPHS->UDPHS_DMA[bEndpoint].UDPHS_DMASTATUS;
-            // Enable DMA endpoint interrupt
-            AT91C_BASE_UDPHS->UDPHS_IEN |= (1 << SHIFT_DMA << bEndpoint);
-            // DMA config
-            AT91C_BASE_UDPHS->UDPHS_DMA[bEndpoint].UDPHS_DMACONTROL = 0; // raz
-            AT91C_BASE_UDPHS->UDPHS_DMA[bEndpoint].UDPHS_DMACONTROL =
-                                              ( ((pTransfer->buffered << 16) & AT91C_UDPHS_BUFF_COUNT)
-                                                | AT91C_UDPHS_END_B_EN
-                                                | AT91C_UDPHS_END_BUFFIT
-                                                | AT91C_UDPHS_CHANN_ENB );
+            UDPHS_DmaStart(bEndpoint);
         }
     }
 #endif
@@ -1150,40 +1228,8 @@ char USBD_Read( unsigned char    bEndpoint,
     }
     else {
 
-        TRACE_DEBUG_WP("Read%d(%d) ", bEndpoint, dLength);
-
         // Others endpoints (not control)
-        if( pTransfer->remaining > DMA_MAX_FIFO_SIZE ) {
-
-            // Transfer the max
-            pTransfer->buffered = DMA_MAX_FIFO_SIZE;    
-        }
-        else {
-            // Transfer the good size
-            pTransfer->buffered = pTransfer->remaining;
-        }
-
-        AT91C_BASE_UDPHS->UDPHS_DMA[bEndpoint].UDPHS_DMAADDRESS = (unsigned int)(pTransfer->pData);
-
-        // Clear unwanted interrupts
-        AT91C_BASE_UDPHS->UDPHS_DMA[bEndpoint].UDPHS_DMASTATUS;
-
-        // Enable DMA endpoint interrupt
-        AT91C_BASE_UDPHS->UDPHS_IEN |= (1 << SHIFT_DMA << bEndpoint);
-
-        TRACE_DEBUG_WP("\n\r_RR:%d ", pTransfer->remaining );
-        TRACE_DEBUG_WP("B:%d ", pTransfer->buffered );
-        TRACE_DEBUG_WP("T:%d ", pTransfer->transferred );
-
-        // DMA config
-        AT91C_BASE_UDPHS->UDPHS_DMA[bEndpoint].UDPHS_DMACONTROL = 0; // raz
-        AT91C_BASE_UDPHS->UDPHS_DMA[bEndpoint].UDPHS_DMACONTROL =
-                                 ( ((pTransfer->buffered << 16) & AT91C_UDPHS_BUFF_COUNT)
-                                   | AT91C_UDPHS_END_TR_EN
-                                   | AT91C_UDPHS_END_TR_IT
-                                   | AT91C_UDPHS_END_B_EN
-                                   | AT91C_UDPHS_END_BUFFIT
-                                   | AT91C_UDPHS_CHANN_ENB );
+        UDPHS_DmaStart(bEndpoint);
     }
 #endif
 
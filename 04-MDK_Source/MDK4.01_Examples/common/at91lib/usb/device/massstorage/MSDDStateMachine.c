@@ -420,6 +420,7 @@ void MSDD_StateMachine(MSDDriver * pMsdDriver)
     MSCsw           *csw = &(commandState->csw);
     MSDTransfer     *transfer = &(commandState->transfer);
     unsigned char   status;
+    unsigned char   i;
 
     // Identify current driver state
     switch (pMsdDriver->state) {
@@ -470,6 +471,17 @@ void MSDD_StateMachine(MSDDriver * pMsdDriver)
                 pMsdDriver->state = MSDD_STATE_READ_CBW;
             }
         }
+        // Host idle: write the caches back
+        else {
+
+            for (i = 0; i <= pMsdDriver->maxLun; i++) {
+
+                if (pMsdDriver->luns[i].cache.flushing) {
+
+                    LUN_Flush(&(pMsdDriver->luns[i]));
+                }
+            }
+        }
         break;
 
     //-------------------------
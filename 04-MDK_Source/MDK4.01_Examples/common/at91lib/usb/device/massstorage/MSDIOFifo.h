@@ -58,9 +58,15 @@
 /// FIFO offset before USB transmit start
 //#define MSDIO_FIFO_OFFSET   (4*512)
 
-/// FIFO trunk size (in each transfer, large amount of data)
-#define MSDIO_READ10_CHUNK_SIZE     (4*512)
-#define MSDIO_WRITE10_CHUNK_SIZE    (4*512)
+/// Default chunk size: the most data moved by one media or USB transfer.
+/// The FIFO is a ring of chunks, so that the media transfer of a chunk runs
+/// while the USB transfers the previous one. See LUN_SetPipeline().
+#ifndef MSDIO_READ10_CHUNK_SIZE
+#define MSDIO_READ10_CHUNK_SIZE     (16*512)
+#endif
+#ifndef MSDIO_WRITE10_CHUNK_SIZE
+#define MSDIO_WRITE10_CHUNK_SIZE    (16*512)
+#endif
 
 //------------------------------------------------------------------------------
 //         Types
@@ -90,20 +96,28 @@ typedef struct _MSDIOFifo {
     unsigned int    dataTotal;
     /// The size of the block in bytes
     unsigned short  blockSize;
-#if  defined(MSDIO_READ10_CHUNK_SIZE) || defined(MSDIO_WRITE10_CHUNK_SIZE)
-    /// The size of one chunk
-    /// (1 block, or several blocks for large amount data R/W)
+    /// The size of one chunk, a multiple of the block size; the last chunk
+    /// of a command may be smaller
     unsigned int    chunkSize;
-#endif
+    /// The size of the ring of chunks used by the command
+    unsigned int    ringSize;
     /// State of input & output
     unsigned char   inputState;
     unsigned char   outputState;
 
+    //- Settings, see LUN_SetPipeline()
+    /// Largest chunk for READ10, in bytes
+    unsigned int    readChunkSize;
+    /// Largest chunk for WRITE10, in bytes
+    unsigned int    writeChunkSize;
+    /// Most chunks in the ring, 0 for as many as the buffer holds
+    unsigned char   depth;
+
     //- Statistics
     /// Times when fifo has no data to send
-    unsigned short  nullCnt;
+    unsigned int    nullCnt;
     /// Times when fifo can not load more input data
-    unsigned short  fullCnt;
+    unsigned int    fullCnt;
 } MSDIOFifo, *PMSDIOFifo;
 
 //------------------------------------------------------------------------------
@@ -36,6 +36,8 @@
 #include <utility/trace.h>
 #include <usb/device/core/USBD.h>
 
+#include <string.h>
+
 //------------------------------------------------------------------------------
 //         Constants
 //------------------------------------------------------------------------------
@@ -93,6 +95,256 @@ static SBCInquiryData inquiryData = {
      0, 0} // Reserved
 };
 
+//------------------------------------------------------------------------------
+//         Internal functions
+//------------------------------------------------------------------------------
+
+//------------------------------------------------------------------------------
+//! \brief  Empties the write-back cache of a LUN, the cached data is lost.
+//! \param  cache        Pointer to the cache
+//------------------------------------------------------------------------------
+static void LUNCacheReset(MSDLunCache *cache)
+{
+    cache->usedSlots = 0;
+    cache->numEntries = 0;
+    cache->flushAddress = 0;
+    cache->runLength = 0;
+    cache->runState = LUN_CACHE_IDLE;
+    cache->readPending = 0;
+    cache->flushing = 0;
+    cache->bypass = 0;
+}
+
+//------------------------------------------------------------------------------
+//! \brief  Looks for a block in the write-back cache of a LUN.
+//! \param  cache        Pointer to the cache
+//! \param  blockAddress LUN block address
+//! \return Index of the entry of the block, or when the block is not cached,
+//!         of the first entry after it
+//------------------------------------------------------------------------------
+static unsigned int LUNCacheFind(MSDLunCache *cache, unsigned int blockAddress)
+{
+    unsigned int low = 0, high = cache->numEntries, middle;
+
+    while (low < high) {
+
+        middle = (low + high) / 2;
+        if (cache->pEntries[middle].blockAddress < blockAddress) {
+
+            low = middle + 1;
+        }
+        else {
+
+            high = middle;
+        }
+    }
+    return low;
+}
+
+//------------------------------------------------------------------------------
+//! \brief  Tells if some blocks of an area are in the write-back cache.
+//! \param  cache        Pointer to the cache
+//! \param  blockAddress First LUN block of the area
+//! \param  length       Number of blocks of the area
+//------------------------------------------------------------------------------
+static unsigned char LUNCacheHolds(MSDLunCache  *cache,
+                                   unsigned int blockAddress,
+                                   unsigned int length)
+{
+    unsigned int i;
+
+    if (cache->numEntries == 0) {
+
+        return 0;
+    }
+    i = LUNCacheFind(cache, blockAddress);
+    return (i < cache->numEntries
+            && cache->pEntries[i].blockAddress - blockAddress < length);
+}
+
+//------------------------------------------------------------------------------
+//! \brief  Removes the blocks of an area from the write-back cache.
+//! \param  cache        Pointer to the cache
+//! \param  blockAddress First LUN block of the area
+//! \param  length       Number of blocks of the area
+//------------------------------------------------------------------------------
+static void LUNCacheDrop(MSDLunCache  *cache,
+                         unsigned int blockAddress,
+                         unsigned int length)
+{
+    unsigned int first = LUNCacheFind(cache, blockAddress);
+    unsigned int last = first;
+
+    while (last < cache->numEntries
+           && cache->pEntries[last].blockAddress - blockAddress < length) {
+
+        last++;
+    }
+    memmove(&cache->pEntries[first],
+            &cache->pEntries[last],
+            (cache->numEntries - last) * sizeof(MSDLunCacheEntry));
+    cache->numEntries -= last - first;
+}
+
+//------------------------------------------------------------------------------
+//! \brief  Tells if an area overlaps the run being written back: these
+//!         blocks can not change nor be dropped until the run is released.
+//! \param  cache        Pointer to the cache
+//! \param  blockAddress First LUN block of the area
+//! \param  length       Number of blocks of the area
+//------------------------------------------------------------------------------
+static unsigned char LUNCacheInRun(MSDLunCache  *cache,
+                                   unsigned int blockAddress,
+                                   unsigned int length)
+{
+    return (cache->runState != LUN_CACHE_IDLE
+            && blockAddress < cache->runAddress + cache->runLength
+            && cache->runAddress < blockAddress + length);
+}
+
+//------------------------------------------------------------------------------
+//! \brief  Releases the blocks of the run written back, unless the media
+//!         failed to write them.
+//! \param  cache        Pointer to the cache
+//! \return USBD_STATUS_SUCCESS or USBD_STATUS_ABORTED
+//------------------------------------------------------------------------------
+static unsigned char LUNCacheRelease(MSDLunCache *cache)
+{
+    cache->runState = LUN_CACHE_IDLE;
+    if (cache->runStatus != MED_STATUS_SUCCESS) {
+
+        TRACE_WARNING("LUN: Cannot write cache back\n\r");
+        return USBD_STATUS_ABORTED;
+    }
+    LUNCacheDrop(cache, cache->runAddress, cache->runLength);
+    cache->flushAddress = cache->runAddress + cache->runLength;
+
+    return USBD_STATUS_SUCCESS;
+}
+
+//------------------------------------------------------------------------------
+//! \brief  Invoked when a run of the write-back cache is written.
+//! \param  lun          Pointer to the MSDLun instance
+//! \param  status       Media result code
+//------------------------------------------------------------------------------
+static void LUNCacheCallback(MSDLun        *lun,
+                             unsigned char status,
+                             unsigned int  transferred,
+                             unsigned int  remaining)
+{
+    lun->cache.runStatus = status;
+    lun->cache.runState = LUN_CACHE_DONE;
+}
+
+//------------------------------------------------------------------------------
+//! \brief  Invoked when a read from the media is done: the blocks which are
+//!         in the write-back cache are newer than the media, so they are
+//!         copied over the data read before the caller is notified.
+//! \param  lun          Pointer to the MSDLun instance
+//! \param  status       Media result code
+//! \param  transferred  Number of bytes read
+//! \param  remaining    Number of bytes not read
+//------------------------------------------------------------------------------
+static void LUNCacheReadCallback(MSDLun        *lun,
+                                 unsigned char status,
+                                 unsigned int  transferred,
+                                 unsigned int  remaining)
+{
+    MSDLunCache *cache = &lun->cache;
+    MSDLunCacheEntry *entry;
+    unsigned int i;
+
+    for (i = LUNCacheFind(cache, cache->readAddress);
+         i < cache->numEntries;
+         i++) {
+
+        entry = &cache->pEntries[i];
+        if (entry->blockAddress - cache->readAddress >= cache->readLength) {
+
+            break;
+        }
+        memcpy(&cache->pReadData[(entry->blockAddress - cache->readAddress)
+                                 * cache->slotSize],
+               &cache->pData[entry->slot * cache->slotSize],
+               cache->slotSize);
+    }
+    cache->readPending = 0;
+
+    if (cache->readCallback) {
+
+        cache->readCallback(cache->readArgument, status, transferred, remaining);
+    }
+}
+
+//------------------------------------------------------------------------------
+//! \brief  Copies blocks to the write-back cache of a LUN. A block already
+//!         cached is updated in place, a new one takes the next free slot,
+//!         so that blocks written together stay together for the write back.
+//! \param  lun          Pointer to the MSDLun instance
+//! \param  blockAddress First LUN block to write
+//! \param  data         Pointer to the data to write
+//! \param  length       Number of blocks to write
+//! \return USBD_STATUS_SUCCESS, USBD_STATUS_LOCKED when the blocks can not
+//!         be cached yet, or USBD_STATUS_ABORTED
+//------------------------------------------------------------------------------
+static unsigned char LUNCacheWrite(MSDLun        *lun,
+                                   unsigned int  blockAddress,
+                                   unsigned char *data,
+                                   unsigned int  length)
+{
+    MSDLunCache *cache = &lun->cache;
+    MSDLunCacheEntry *entry;
+    unsigned int i, j, needed = 0;
+
+    // Count the slots needed
+    for (i = 0; i < length; i++) {
+
+        j = LUNCacheFind(cache, blockAddress + i);
+        if (j == cache->numEntries
+            || cache->pEntries[j].blockAddress != blockAddress + i) {
+
+            needed++;
+        }
+    }
+
+    // Cache full: slots are handed out again once it is clean
+    if (cache->usedSlots + needed > cache->numSlots) {
+
+        cache->flushing = 1;
+        if (LUN_Flush(lun) == USBD_STATUS_ABORTED) {
+
+            return USBD_STATUS_ABORTED;
+        }
+        return USBD_STATUS_LOCKED;
+    }
+
+    for (i = 0; i < length; i++) {
+
+        j = LUNCacheFind(cache, blockAddress + i);
+        entry = &cache->pEntries[j];
+        if (j == cache->numEntries
+            || entry->blockAddress != blockAddress + i) {
+
+            memmove(entry + 1,
+                    entry,
+                    (cache->numEntries - j) * sizeof(MSDLunCacheEntry));
+            entry->blockAddress = blockAddress + i;
+            entry->slot = cache->usedSlots++;
+            cache->numEntries++;
+        }
+        memcpy(&cache->pData[entry->slot * cache->slotSize],
+               &data[i * cache->slotSize],
+               cache->slotSize);
+    }
+
+    // Write back while the host is idle
+    if (cache->usedSlots * 100 >= cache->numSlots * LUN_CACHE_FLUSH_PERCENT) {
+
+        cache->flushing = 1;
+    }
+    return USBD_STATUS_SUCCESS;
+}
+
 //------------------------------------------------------------------------------
 //         Exported functions
 //------------------------------------------------------------------------------
@@ -104,7 +356,9 @@ static SBCInquiryData inquiryData = {
 //! \param  media        Media on which the LUN is constructed, set to 0 to
 //!                      disconnect the Media or initialize an ejected LUN.
 //! \param  ioBuffer     Pointer to a buffer used for read/write operation and
-//!                      which must be blockSize bytes long.
+//!                      which must be blockSize bytes long at least, and two
+//!                      chunks long to overlap media and USB transfers.
+//!                      See LUN_SetPipeline().
 //! \param  ioBufferSize Size of the allocated IO buffer.
 //! \param  baseAddress  Base address of the LUN in number of media blocks
 //! \param  size         Total size of the LUN in number of media blocks
@@ -159,6 +413,10 @@ void LUN_Init(MSDLun        *lun,
     STORE_DWORDB(0, lun->readCapacityData.pLogicalBlockAddress);
     STORE_DWORDB(0, lun->readCapacityData.pLogicalBlockLength);
 
+    // No write-back cache
+    lun->cache.numSlots = 0;
+    LUNCacheReset(&lun->cache);
+
     // Initialize LUN
     lun->media = media;
     if (media == 0) {
@@ -200,6 +458,7 @@ void LUN_Init(MSDLun        *lun,
 
     lun->ioFifo.pBuffer = ioBuffer;
     lun->ioFifo.bufferSize = ioBufferSize;
+    LUN_SetPipeline(lun, MSDIO_READ10_CHUNK_SIZE, MSDIO_WRITE10_CHUNK_SIZE, 0);
 
     lun->dataMonitor = dataMonitor;
 
@@ -214,6 +473,200 @@ void LUN_Init(MSDLun        *lun,
     lun->status = LUN_CHANGED;
 }
 
+//------------------------------------------------------------------------------
+//! \brief  Sets how the IO buffer of a LUN is used for READ10 and WRITE10.
+//!
+//!         The buffer is a ring of chunks: a chunk is read from the media,
+//!         or received from the USB, while the previous one is sent to the
+//!         USB, or written to the media. Bigger chunks take less commands
+//!         on the media; more chunks absorb the media latencies. The chunk
+//!         sizes are rounded down to whole LUN blocks, and shrunk to half
+//!         the buffer so that two chunks always fit. New settings apply
+//!         from the next command.
+//! \param  lun            Pointer to the MSDLun instance
+//! \param  readChunkSize  Largest READ10 chunk in bytes
+//! \param  writeChunkSize Largest WRITE10 chunk in bytes
+//! \param  depth          Most chunks in the ring, 0 for as many as fit
+//! \return USBD_STATUS_SUCCESS, or USBD_STATUS_INVALID_PARAMETER when the
+//!         buffer does not hold two blocks
+//------------------------------------------------------------------------------
+unsigned char LUN_SetPipeline(MSDLun        *lun,
+                              unsigned int  readChunkSize,
+                              unsigned int  writeChunkSize,
+                              unsigned char depth)
+{
+    MSDIOFifo *fifo = &lun->ioFifo;
+
+    if (fifo->bufferSize / 2 < readChunkSize) {
+
+        readChunkSize = fifo->bufferSize / 2;
+    }
+    if (fifo->bufferSize / 2 < writeChunkSize) {
+
+        writeChunkSize = fifo->bufferSize / 2;
+    }
+    fifo->readChunkSize = readChunkSize;
+    fifo->writeChunkSize = writeChunkSize;
+    fifo->depth = depth;
+
+    // Without a media, the block size is not known yet
+    if (lun->media
+        && fifo->bufferSize < 2 * lun->blockSize * lun->media->blockSize) {
+
+        TRACE_WARNING("LUN_SetPipeline: Buffer too small\n\r");
+        return USBD_STATUS_INVALID_PARAMETER;
+    }
+    return USBD_STATUS_SUCCESS;
+}
+
+//------------------------------------------------------------------------------
+//! \brief  Gives a LUN a write-back cache, or takes it back.
+//!
+//!         The blocks written by the host are copied to the cache and the
+//!         write is acknowledged at once. They are written back in runs of
+//!         consecutive blocks, in increasing address order: while the host is
+//!         idle once the cache is LUN_CACHE_FLUSH_PERCENT full, when it is
+//!         full, and on SYNCHRONIZE CACHE, FUA writes and LUN_Eject.
+//!         Each cached block takes one LUN block plus 8 bytes of the buffer,
+//!         which is best placed in DDRAM. LUN_Init disables the cache; media
+//!         mapped to memory are written straight from the USB and can not be
+//!         cached.
+//! \param  lun          Pointer to the MSDLun instance
+//! \param  buffer       Word aligned buffer, 0 to disable the cache
+//! \param  size         Size of the buffer in bytes
+//! \return USBD_STATUS_SUCCESS, USBD_STATUS_LOCKED while the cache still
+//!         holds data (see LUN_Flush), or USBD_STATUS_INVALID_PARAMETER
+//------------------------------------------------------------------------------
+unsigned char LUN_SetCache(MSDLun        *lun,
+                           unsigned char *buffer,
+                           unsigned int  size)
+{
+    MSDLunCache *cache = &lun->cache;
+    unsigned char status;
+
+    // Data acknowledged to the host must reach the media first
+    status = LUN_Flush(lun);
+    if (status != USBD_STATUS_SUCCESS) {
+
+        return status;
+    }
+    cache->numSlots = 0;
+    LUNCacheReset(cache);
+    if (buffer == 0 || size == 0) {
+
+        return USBD_STATUS_SUCCESS;
+    }
+
+    if (lun->media == 0 || lun->media->mappedWR) {
+
+        TRACE_WARNING("LUN_SetCache: Media can not be cached\n\r");
+        return USBD_STATUS_INVALID_PARAMETER;
+    }
+    cache->slotSize = lun->blockSize * lun->media->blockSize;
+    if (size < cache->slotSize + sizeof(MSDLunCacheEntry)) {
+
+        TRACE_WARNING("LUN_SetCache: Buffer too small\n\r");
+        return USBD_STATUS_INVALID_PARAMETER;
+    }
+
+    // Slots first, the entries follow
+    cache->pData = buffer;
+    cache->numSlots = size / (cache->slotSize + sizeof(MSDLunCacheEntry));
+    cache->pEntries = (MSDLunCacheEntry *)
+                      &buffer[cache->numSlots * cache->slotSize];
+    TRACE_INFO("LUN: cache %d blocks\n\r", cache->numSlots);
+
+    return USBD_STATUS_SUCCESS;
+}
+
+//------------------------------------------------------------------------------
+//! \brief  Writes the write-back cache of a LUN back to the media.
+//!
+//!         This function does not block: each call releases the run written
+//!         since the previous call and starts writing the next one. It must
+//!         be called until it returns USBD_STATUS_SUCCESS.
+//! \param  lun          Pointer to the MSDLun instance
+//! \return USBD_STATUS_SUCCESS when the cache is clean, USBD_STATUS_LOCKED
+//!         while it is not, USBD_STATUS_ABORTED when the media fails
+//------------------------------------------------------------------------------
+unsigned char LUN_Flush(MSDLun *lun)
+{
+    MSDLunCache *cache = &lun->cache;
+    MSDLunCacheEntry *entry;
+    unsigned int i, length;
+    unsigned char status;
+
+    if (cache->numSlots == 0) {
+
+        return USBD_STATUS_SUCCESS;
+    }
+
+    // The entries are in use
+    if (cache->runState == LUN_CACHE_BUSY || cache->readPending) {
+
+        return USBD_STATUS_LOCKED;
+    }
+
+    // Release the run written
+    if (cache->runState == LUN_CACHE_DONE
+        && LUNCacheRelease(cache) != USBD_STATUS_SUCCESS) {
+
+        cache->flushing = 0;
+        return USBD_STATUS_ABORTED;
+    }
+
+    // Clean
+    if (cache->numEntries == 0) {
+
+        LUNCacheReset(cache);
+        return USBD_STATUS_SUCCESS;
+    }
+    if (lun->media == 0) {
+
+        return USBD_STATUS_ABORTED;
+    }
+
+    // Next run from the flush address, the slots of its blocks must follow
+    // each other too
+    i = LUNCacheFind(cache, cache->flushAddress);
+    if (i == cache->numEntries) {
+
+        i = 0;
+    }
+    entry = &cache->pEntries[i];
+    length = 1;
+    while (i + length < cache->numEntries
+           && entry[length].blockAddress == entry->blockAddress + length
+           && entry[length].slot == entry->slot + length) {
+
+        length++;
+    }
+
+    TRACE_INFO_WP("LUNFlush(%u,%u) ", entry->blockAddress, length);
+    cache->runAddress = entry->blockAddress;
+    cache->runLength = length;
+    cache->runState = LUN_CACHE_BUSY;
+    status = MED_Write(lun->media,
+                       lun->baseAddress + entry->blockAddress * lun->blockSize,
+                       &cache->pData[entry->slot * cache->slotSize],
+                       length * lun->blockSize,
+                       (MediaCallback) LUNCacheCallback,
+                       lun);
+    if (status == MED_STATUS_BUSY) {
+
+        cache->runState = LUN_CACHE_IDLE;
+    }
+    else if (status != MED_STATUS_SUCCESS) {
+
+        TRACE_WARNING("LUN_Flush: Cannot write media\n\r");
+        cache->runState = LUN_CACHE_IDLE;
+        cache->flushing = 0;
+        return USBD_STATUS_ABORTED;
+    }
+
+    return USBD_STATUS_LOCKED;
+}
+
 //------------------------------------------------------------------------------
 //! \brief  Eject the media from a LUN
 //! \param  lun          Pointer to the MSDLun instance to initialize
@@ -221,8 +674,21 @@ void LUN_Init(MSDLun        *lun,
 //------------------------------------------------------------------------------
 unsigned char LUN_Eject(MSDLun *lun)
 {
+    unsigned char status;
+
     if (lun->media) {
 
+        // Write the cached data back first
+        status = LUN_Flush(lun);
+        if (status == USBD_STATUS_LOCKED) {
+
+            return USBD_STATUS_LOCKED;
+        }
+        else if (status != USBD_STATUS_SUCCESS) {
+
+            TRACE_WARNING("LUN_Eject: Cached data lost\n\r");
+        }
+
         // Avoid any LUN R/W in progress
         if (lun->media->state == MED_STATE_BUSY) {
 
@@ -232,6 +698,7 @@ unsigned char LUN_Eject(MSDLun *lun)
         // Remove the link of the media
         lun->media = 0;
     }
+    LUNCacheReset(&lun->cache);
     // LUN is removed
     lun->status = LUN_NOT_PRESENT;
 
@@ -259,6 +726,12 @@ unsigned char LUN_Write(MSDLun        *lun,
 
     TRACE_INFO_WP("LUNWrite(%u) ", blockAddress);
 
+    // Release the run written back, its blocks may be written again
+    if (lun->cache.runState == LUN_CACHE_DONE && !lun->cache.readPending) {
+
+        LUNCacheRelease(&lun->cache);
+    }
+
     // Check that the data is not too big
     if ((length + blockAddress) * lun->blockSize > lun->size) {
 
@@ -274,6 +747,27 @@ unsigned char LUN_Write(MSDLun        *lun,
         TRACE_WARNING("LUN_Write: LUN is readonly\n\r");
         status = USBD_STATUS_ABORTED;
     }
+    // The cache entries are in use
+    else if (lun->cache.numSlots
+             && (LUNCacheInRun(&lun->cache, blockAddress, length)
+                 || lun->cache.readPending)) {
+
+        status = USBD_STATUS_LOCKED;
+    }
+    // Chunk of a small write command: acknowledged once cached
+    else if (lun->cache.numSlots
+             && !lun->cache.bypass
+             && length <= lun->cache.numSlots) {
+
+        status = LUNCacheWrite(lun, blockAddress, data, length);
+        if (status == USBD_STATUS_SUCCESS && callback) {
+
+            callback(argument,
+                     MED_STATUS_SUCCESS,
+                     length * lun->cache.slotSize,
+                     0);
+        }
+    }
     else {
 
         // Compute write start address
@@ -291,8 +785,18 @@ unsigned char LUN_Write(MSDLun        *lun,
         // Check operation result code
         if (status == MED_STATUS_SUCCESS) {
 
+            // Cached copies of the blocks are older now
+            if (lun->cache.numSlots) {
+
+                LUNCacheDrop(&lun->cache, blockAddress, length);
+            }
             status = USBD_STATUS_SUCCESS;
         }
+        else if (status == MED_STATUS_BUSY) {
+
+            // Media busy writing the cache back, try again
+            status = USBD_STATUS_LOCKED;
+        }
         else {
 
             TRACE_WARNING("LUN_Write: Cannot write media\n\r");
@@ -342,19 +846,47 @@ unsigned char LUN_Read(MSDLun        *lun,
         medBlk = lun->baseAddress + (blockAddress * lun->blockSize);
         medLen = length * lun->blockSize;
 
-        // Start write operation
-        status = MED_Read(lun->media,
-                          medBlk,
-                          data,
-                          medLen,
-                          (MediaCallback) callback,
-                          argument);
+        // Start read operation, completed with the cached blocks if any
+        if (lun->cache.numSlots
+            && LUNCacheHolds(&lun->cache, blockAddress, length)) {
+
+            lun->cache.pReadData = data;
+            lun->cache.readAddress = blockAddress;
+            lun->cache.readLength = length;
+            lun->cache.readCallback = callback;
+            lun->cache.readArgument = argument;
+            lun->cache.readPending = 1;
+            status = MED_Read(lun->media,
+                              medBlk,
+                              data,
+                              medLen,
+                              (MediaCallback) LUNCacheReadCallback,
+                              lun);
+            if (status != MED_STATUS_SUCCESS) {
+
+                lun->cache.readPending = 0;
+            }
+        }
+        else {
+
+            status = MED_Read(lun->media,
+                              medBlk,
+                              data,
+                              medLen,
+                              (MediaCallback) callback,
+                              argument);
+        }
 
         // Check result code
         if (status == MED_STATUS_SUCCESS) {
 
             status = USBD_STATUS_SUCCESS;
         }
+        else if (status == MED_STATUS_BUSY) {
+
+            // Media busy writing the cache back, try again
+            status = USBD_STATUS_LOCKED;
+        }
         else {
 
             TRACE_WARNING("LUN_Read: Cannot read media\n\r");
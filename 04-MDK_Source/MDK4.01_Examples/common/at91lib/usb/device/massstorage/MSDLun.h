@@ -40,6 +40,8 @@
 /// -# Initlalize the LUN with LUN_Init, and link to the initialized Media.
 /// -# To read data from the LUN linked media, uses LUN_Read.
 /// -# To write data to the LUN linked media, uses LUN_Write.
+/// -# To cache the writes of the host, give the LUN a buffer with
+///    LUN_SetCache; LUN_Flush writes the cached data back to the media.
 /// -# To unlink the media, uses LUN_Eject.
 //------------------------------------------------------------------------------
 
@@ -75,10 +77,80 @@
 /// Media of LUN is ready
 #define LUN_READY                   0x11
 
+/// Write-back cache: no run of blocks being written back
+#define LUN_CACHE_IDLE              0
+/// Write-back cache: a run of blocks is being written to the media
+#define LUN_CACHE_BUSY              1
+/// Write-back cache: the run is written, its blocks can be released
+#define LUN_CACHE_DONE              2
+
+/// Filling of the write-back cache, in percent of its slots, from which the
+/// cached blocks are written back while the host is idle
+#ifndef LUN_CACHE_FLUSH_PERCENT
+#define LUN_CACHE_FLUSH_PERCENT     50
+#endif
+
+/// WRITE(10) commands of at least this size in bytes bypass the write-back
+/// cache: they gain nothing from it and would only flush it sooner. The
+/// decision covers the whole command, whatever the chunks it is written in
+#ifndef LUN_CACHE_BYPASS_SIZE
+#define LUN_CACHE_BYPASS_SIZE       (16*512)
+#endif
+
 //------------------------------------------------------------------------------
 //      Structures
 //------------------------------------------------------------------------------
 
+/// Block held by the write-back cache
+typedef struct {
+
+    /// LUN block address of the block
+    unsigned int          blockAddress;
+    /// Index of the cache slot which holds the block data
+    unsigned int          slot;
+
+} MSDLunCacheEntry;
+
+/// Write-back cache of a LUN
+typedef struct {
+
+    /// Data of the cached blocks, one LUN block per slot
+    unsigned char         *pData;
+    /// Cached blocks, sorted by block address
+    MSDLunCacheEntry      *pEntries;
+    /// Size of a slot in bytes
+    unsigned int          slotSize;
+    /// Number of slots, 0 when the cache is disabled
+    unsigned int          numSlots;
+    /// Number of slots handed out since the cache was last clean
+    unsigned int          usedSlots;
+    /// Number of cached blocks
+    unsigned int          numEntries;
+    /// Block address from which the next run to write back is searched
+    unsigned int          flushAddress;
+    /// First block of the run being written back
+    unsigned int          runAddress;
+    /// Number of blocks of the run being written back
+    unsigned int          runLength;
+    /// Read being completed with cached blocks
+    unsigned char         *pReadData;
+    unsigned int          readAddress;
+    unsigned int          readLength;
+    TransferCallback      readCallback;
+    void                  *readArgument;
+    /// State of the run being written back (LUN_CACHE_IDLE/BUSY/DONE)
+    volatile unsigned char runState;
+    /// Media result code of the run
+    volatile unsigned char runStatus;
+    /// A read is waiting to be completed with cached blocks
+    volatile unsigned char readPending;
+    /// Cached blocks are being written back in the background
+    unsigned char         flushing;
+    /// The current write command goes straight to the media
+    unsigned char         bypass;
+
+} MSDLunCache;
+
 /// LUN structure
 typedef struct {
 
@@ -114,6 +186,9 @@ typedef struct {
     /// Data for the ReadCapacity command.
     SBCReadCapacity10Data readCapacityData;
 
+    /// Write-back cache, see LUN_SetCache.
+    MSDLunCache           cache;
+
 } MSDLun;
 
 //------------------------------------------------------------------------------
@@ -132,6 +207,17 @@ extern void LUN_Init(MSDLun        *lun,
                                          unsigned int  fifoNullCount,
                                          unsigned int  fifoFullCount));
 
+extern unsigned char LUN_SetPipeline(MSDLun        *lun,
+                                     unsigned int  readChunkSize,
+                                     unsigned int  writeChunkSize,
+                                     unsigned char depth);
+
+extern unsigned char LUN_SetCache(MSDLun        *lun,
+                                  unsigned char *buffer,
+                                  unsigned int  size);
+
+extern unsigned char LUN_Flush(MSDLun *lun);
+
 extern unsigned char LUN_Eject(MSDLun *lun);
 
 extern unsigned char LUN_Write(MSDLun *lun,
@@ -71,6 +71,9 @@
 /// - SBC_MODE_SENSE_6
 /// - SBC_VERIFY_10
 /// - SBC_READ_FORMAT_CAPACITIES
+///
+/// !Optional Codes for the write-back cache
+/// - SBC_SYNCHRONIZE_CACHE_10
 
 /// Request information regarding parameters of the target and Logical Unit.
 #define SBC_INQUIRY                                     0x12
@@ -94,6 +97,9 @@
 #define SBC_VERIFY_10                                   0x2F
 /// Request a list of the possible capacities that can be formatted on medium
 #define SBC_READ_FORMAT_CAPACITIES                      0x23
+
+/// Request that the cached data of the %device be written to the medium.
+#define SBC_SYNCHRONIZE_CACHE_10                        0x35
 //------------------------------------------------------------------------------
 
 //------------------------------------------------------------------------------
@@ -254,6 +260,7 @@
 ///
 /// !Additional Codes
 /// - SBC_ASC_LOGICAL_UNIT_NOT_READY
+/// - SBC_ASC_WRITE_ERROR
 /// - SBC_ASC_LOGICAL_BLOCK_ADDRESS_OUT_OF_RANGE
 /// - SBC_ASC_INVALID_FIELD_IN_CDB
 /// - SBC_ASC_WRITE_PROTECTED
@@ -264,6 +271,7 @@
 /// - SBC_ASC_MEDIUM_NOT_PRESENT
 
 #define SBC_ASC_LOGICAL_UNIT_NOT_READY                0x04
+#define SBC_ASC_WRITE_ERROR                           0x0C
 #define SBC_ASC_LOGICAL_BLOCK_ADDRESS_OUT_OF_RANGE    0x21
 #define SBC_ASC_INVALID_FIELD_IN_CDB                  0x24
 #define SBC_ASC_WRITE_PROTECTED                       0x27
@@ -296,11 +304,21 @@
 /// \brief  Supported mode pages
 /// \see    sbc3r06.pdf - Section 6.3.1 - Table 115
 #define SBC_PAGE_READ_WRITE_ERROR_RECOVERY            0x01
+#define SBC_PAGE_CACHING                              0x08
 #define SBC_PAGE_INFORMATIONAL_EXCEPTIONS_CONTROL     0x1C
 #define SBC_PAGE_RETURN_ALL                           0x3F
 #define SBC_PAGE_VENDOR_SPECIFIC                      0x00
 //------------------------------------------------------------------------------
 
+//------------------------------------------------------------------------------
+/// \brief  PC field values of the MODE SENSE commands
+/// \see    spc4r06.pdf - Section 6.9.1 - Table 99
+#define SBC_PC_CURRENT_VALUES                         0x0
+#define SBC_PC_CHANGEABLE_VALUES                      0x1
+#define SBC_PC_DEFAULT_VALUES                         0x2
+#define SBC_PC_SAVED_VALUES                           0x3
+//------------------------------------------------------------------------------
+
 //------------------------------------------------------------------------------
 /// \page "MSD Endian Macros"
 /// This page lists the macros for endianness conversion.
@@ -620,6 +638,62 @@ typedef struct {
 
 } __attribute__ ((packed)) SBCReadWriteErrorRecovery; // GCC
 
+//------------------------------------------------------------------------------
+/// \brief  Caching mode page
+/// \see    sbc3r07.pdf - Section 6.3.3 - Table 118
+//------------------------------------------------------------------------------
+typedef struct {
+
+    unsigned char bPageCode:6,                 //!< 0x08 : SBC_PAGE_CACHING
+                  isSPF:1,                     //!< Page or subpage data format
+                  isPS:1;                      //!< Parameters saveable ?
+    unsigned char bPageLength;                 //!< Length of page data (0x12)
+    unsigned char isRCD:1,                     //!< Read cache disable bit
+                  isMF:1,                      //!< Multiplication factor bit
+                  isWCE:1,                     //!< Write cache enable bit
+                  isSIZE:1,                    //!< Size enable bit
+                  isDISC:1,                    //!< Discontinuity bit
+                  isCAP:1,                     //!< Caching analysis permitted bit
+                  isABPF:1,                    //!< Abort pre-fetch bit
+                  isIC:1;                      //!< Initiator control bit
+    unsigned char bWriteRetentionPriority:4,   //!< Write retention priority
+                  bDemandReadRetentionPriority:4; //!< Read retention priority
+    unsigned char pDisablePrefetchLength[2];   //!< Disable pre-fetch length
+    unsigned char pMinimumPrefetch[2];         //!< Minimum pre-fetch
+    unsigned char pMaximumPrefetch[2];         //!< Maximum pre-fetch
+    unsigned char pMaximumPrefetchCeiling[2];  //!< Maximum pre-fetch ceiling
+    unsigned char isNV_DIS:1,                  //!< Non-volatile cache disable
+                  bReserved1:2,                //!< Reserved bits
+                  bVendorSpecific:2,           //!< Vendor-specific bits
+                  isDRA:1,                     //!< Disable read-ahead bit
+                  isLBCSS:1,                   //!< Logical block cache segment size
+                  isFSW:1;                     //!< Force sequential write bit
+    unsigned char bNumberOfCacheSegments;      //!< Number of cache segments
+    unsigned char pCacheSegmentSize[2];        //!< Cache segment size
+    unsigned char bReserved2;                  //!< Reserved byte
+    unsigned char pObsolete1[3];               //!< Obsolete bytes
+
+} __attribute__ ((packed)) SBCCachingModePage; // GCC
+
+//------------------------------------------------------------------------------
+/// \brief  Structure for the SYNCHRONIZE CACHE (10) command
+/// \see    sbc3r07.pdf - Section 5.18 - Table 61
+//------------------------------------------------------------------------------
+typedef struct {
+
+    unsigned char bOperationCode;          //!< 0x35 : SBC_SYNCHRONIZE_CACHE_10
+    unsigned char bObsolete1:1,            //!< Obsolete bit
+                  isIMMED:1,               //!< Return before the end ?
+                  isSYNC_NV:1,             //!< Obsolete bit
+                  bReserved1:5;            //!< Reserved bits
+    unsigned char pLogicalBlockAddress[4]; //!< First block to synchronize
+    unsigned char bGroupNumber:5,          //!< Information grouping
+                  bReserved2:3;            //!< Reserved bits
+    unsigned char pNumberOfBlocks[2];      //!< Number of blocks, 0 for all
+    unsigned char bControl;                //!< 0x00
+
+} __attribute__ ((packed)) SBCSynchronizeCache10; // GCC
+
 //------------------------------------------------------------------------------
 /// \brief  Generic structure for holding information about SBC commands
 /// \see    SBCInquiry
@@ -630,6 +704,7 @@ typedef struct {
 /// \see    SBCWrite10
 /// \see    SBCMediumRemoval
 /// \see    SBCModeSense6
+/// \see    SBCSynchronizeCache10
 //------------------------------------------------------------------------------
 typedef union {
 
@@ -642,6 +717,7 @@ typedef union {
     SBCWrite10        write10;        //!< WRITE (10) command
     SBCMediumRemoval  mediumRemoval;  //!< PREVENT/ALLOW MEDIUM REMOVAL command
     SBCModeSense6     modeSense6;     //!< MODE SENSE (6) command
+    SBCSynchronizeCache10 synchronizeCache10; //!< SYNCHRONIZE CACHE (10)
 
 } SBCCommand;
 
@@ -37,6 +37,8 @@
 
 #include "MSDIOFifo.h"
 
+#include <string.h>
+
 //------------------------------------------------------------------------------
 //      Global variables
 //------------------------------------------------------------------------------
@@ -45,49 +47,25 @@
 //      Macros
 //------------------------------------------------------------------------------
 
-#ifdef MSDIO_READ10_CHUNK_SIZE
-/// READ10 - Read data from specific LUN to FIFO
-#define SBC_READ_CHUNK(pLun, lba, pFifo, pCb, pArg) \
-    LUN_Read((pLun), (lba), \
-            &(pFifo)->pBuffer[(pFifo)->inputNdx], \
-             ((pFifo)->chunkSize/(pFifo)->blockSize), \
-             (TransferCallback)(pCb), (void*)pArg)
-/// READ10 - Transfer data from FIFO to USB
-#define SBC_TX_CHUNK(pFifo, pCb, pArg) \
-    MSDD_Write(&(pFifo)->pBuffer[(pFifo)->outputNdx], \
-                (pFifo)->chunkSize, \
-                (TransferCallback)(pCb), (void*)(pArg))
-#endif
-
-#ifdef MSDIO_WRITE10_CHUNK_SIZE
-/// WRITE10 - Read data from USB to FIFO
-#define SBC_RX_CHUNK(pFifo,pCb,pArg) \
-    MSDD_Read(&(pFifo)->pBuffer[(pFifo)->inputNdx], \
-               (pFifo)->chunkSize, \
-               (TransferCallback)(pCb), (void*)(pArg))
-/// WRITE10 - Write data from FIFO to LUN
-#define SBC_WRITE_CHUNK(pLun, lba, pFifo, pCb, pArg) \
-    LUN_Write((pLun), (lba), \
-             &(pFifo)->pBuffer[(pFifo)->outputNdx], \
-              ((pFifo)->chunkSize/(pFifo)->blockSize), \
-              (TransferCallback)(pCb), (void*)(pArg))
-#endif
+/// Length of the chunk of the FIFO data starting at the given offset: a whole
+/// chunk, or what is left at the end of the data
+#define SBC_CHUNK_LENGTH(pFifo, offset) \
+    (((pFifo)->dataTotal - (offset) < (pFifo)->chunkSize) \
+     ? ((pFifo)->dataTotal - (offset)) : (pFifo)->chunkSize)
 
 
 //------------------------------------------------------------------------------
-//! \brief  Header for the mode pages data
+//! \brief  Mode data returned by MODE SENSE (6): the header and the caching
+//!         page, filled for the LUN addressed
 //! \see    SBCModeParameterHeader6
+//! \see    SBCCachingModePage
 //------------------------------------------------------------------------------
-static const SBCModeParameterHeader6 modeParameterHeader6 = {
+static struct {
+
+    SBCModeParameterHeader6 header;
+    SBCCachingModePage      caching;
 
-    sizeof(SBCModeParameterHeader6) - 1,        //! Length is 0x03
-    SBC_MEDIUM_TYPE_DIRECT_ACCESS_BLOCK_DEVICE, //! Direct-access block device
-    0,                                          //! Reserved bits
-    0,                                          //! DPO/FUA not supported
-    0,                                          //! Reserved bits
-    0,                                          //! not write-protected
-    0                                           //! No block descriptor
-};
+} modeSenseData;
 
 //------------------------------------------------------------------------------
 //      Internal functions
@@ -156,6 +134,43 @@ static unsigned char SBCLunCanBeWritten(MSDLun *lun)
     return canBeWritten;
 }
 
+//------------------------------------------------------------------------------
+//! \brief  Prepares the FIFO of a LUN for a READ10 or WRITE10 command: the
+//!         chunks are as big as allowed, and the ring holds as many of them
+//!         as the buffer and the depth setting allow.
+//! \param  lun          Pointer to the LUN affected by the command
+//! \param  length       Length of the data of the command in bytes
+//! \param  chunkSize    Largest chunk in bytes
+//------------------------------------------------------------------------------
+static void SBCFifoInit(MSDLun *lun, unsigned int length, unsigned int chunkSize)
+{
+    MSDIOFifo *fifo = &lun->ioFifo;
+    unsigned int chunks;
+
+    fifo->dataTotal = length;
+    fifo->blockSize = lun->blockSize * lun->media->blockSize;
+
+    // Whole blocks, one at least
+    fifo->chunkSize = chunkSize - chunkSize % fifo->blockSize;
+    if (fifo->chunkSize == 0) {
+
+        fifo->chunkSize = fifo->blockSize;
+    }
+    chunks = fifo->bufferSize / fifo->chunkSize;
+    if (fifo->depth && chunks > fifo->depth) {
+
+        chunks = fifo->depth;
+    }
+    fifo->ringSize = chunks * fifo->chunkSize;
+
+    fifo->fullCnt = 0;
+    fifo->nullCnt = 0;
+    fifo->inputNdx = 0;
+    fifo->inputTotal = 0;
+    fifo->outputNdx = 0;
+    fifo->outputTotal = 0;
+}
+
 //------------------------------------------------------------------------------
 //! \brief  Performs a WRITE (10) command on the specified LUN.
 //!
@@ -175,6 +190,7 @@ static unsigned char SBC_Write10(MSDLun          *lun,
 {
     unsigned char status;
     unsigned char result = MSDD_STATUS_INCOMPLETE;
+    unsigned int length;
     SBCRead10 *command = (SBCRead10 *) commandState->cbw.pCommand;
     MSDTransfer *transfer = &(commandState->transfer);
     MSDTransfer *disktransfer = &(commandState->disktransfer);
@@ -194,27 +210,17 @@ static unsigned char SBC_Write10(MSDLun          *lun,
 
 
             // Initialize FIFO
-            fifo->dataTotal = commandState->length;
-            fifo->blockSize = lun->blockSize * lun->media->blockSize;
-          #ifdef MSDIO_WRITE10_CHUNK_SIZE
-            if (   fifo->dataTotal >= 64 * 1024
-                && fifo->blockSize < MSDIO_WRITE10_CHUNK_SIZE)
-                fifo->chunkSize = MSDIO_WRITE10_CHUNK_SIZE;
-            else
-                fifo->chunkSize = fifo->blockSize;
-          #endif
-            fifo->fullCnt = 0;
-            fifo->nullCnt = 0;
+            SBCFifoInit(lun, commandState->length, fifo->writeChunkSize);
+
+            // Large writes go straight to the media, all their chunks
+            lun->cache.bypass =
+                (commandState->length >= LUN_CACHE_BYPASS_SIZE);
 
             // Initialize FIFO output (Disk)
-            fifo->outputNdx = 0;
-            fifo->outputTotal = 0;
             fifo->outputState = MSDIO_IDLE;
             transfer->semaphore = 0;
 
             // Initialize FIFO input (USB)
-            fifo->inputNdx = 0;
-            fifo->inputTotal = 0;
             fifo->inputState = MSDIO_START;
             disktransfer->semaphore = 0;
         }
@@ -223,6 +229,24 @@ static unsigned char SBC_Write10(MSDLun          *lun,
 
     if (commandState->length == 0) {
 
+        // FUA: the data must be on the media before the status is sent
+        if (command->isFUA) {
+
+            status = LUN_Flush(lun);
+            if (status == USBD_STATUS_LOCKED) {
+
+                return MSDD_STATUS_INCOMPLETE;
+            }
+            else if (status != USBD_STATUS_SUCCESS) {
+
+                SBC_UpdateSenseData(&(lun->requestSenseData),
+                                    SBC_SENSE_KEY_MEDIUM_ERROR,
+                                    SBC_ASC_WRITE_ERROR,
+                                    0);
+                return MSDD_STATUS_RW;
+            }
+        }
+
         // Perform the callback!
         if (lun->dataMonitor) {
 
@@ -238,7 +262,7 @@ static unsigned char SBC_Write10(MSDLun          *lun,
     case MSDIO_IDLE:
     //------------------
         if (fifo->inputTotal < fifo->dataTotal &&
-            fifo->inputTotal - fifo->outputTotal < fifo->bufferSize) {
+            fifo->inputTotal - fifo->outputTotal < fifo->ringSize) {
 
             fifo->inputState = MSDIO_START;
         }
@@ -272,15 +296,12 @@ static unsigned char SBC_Write10(MSDLun          *lun,
                                 (void *) transfer);
         }
         else {
-          #ifdef MSDIO_WRITE10_CHUNK_SIZE
-            status = SBC_RX_CHUNK(fifo, MSDDriver_Callback, transfer);
-          #else
-            // Read block to buffer
+
+            // Read the next chunk to the buffer
             status = MSDD_Read((void*)&fifo->pBuffer[fifo->inputNdx],
-                               fifo->blockSize,
+                               SBC_CHUNK_LENGTH(fifo, fifo->inputTotal),
                                (TransferCallback) MSDDriver_Callback,
                                (void *) transfer);
-          #endif
         }
 
         // Check operation result code
@@ -343,17 +364,10 @@ static unsigned char SBC_Write10(MSDLun          *lun,
             else {
 
                 // Update input index
-              #ifdef MSDIO_WRITE10_CHUNK_SIZE
+                fifo->inputTotal += SBC_CHUNK_LENGTH(fifo, fifo->inputTotal);
                 MSDIOFifo_IncNdx(fifo->inputNdx,
                                  fifo->chunkSize,
-                                 fifo->bufferSize);
-                fifo->inputTotal += fifo->chunkSize;
-              #else
-                MSDIOFifo_IncNdx(fifo->inputNdx,
-                                 fifo->blockSize,
-                                 fifo->bufferSize);
-                fifo->inputTotal += fifo->blockSize;
-              #endif
+                                 fifo->ringSize);
 
                 // Start Next block
                 // - All Data done?
@@ -362,7 +376,8 @@ static unsigned char SBC_Write10(MSDLun          *lun,
                     fifo->inputState = MSDIO_IDLE;
                 }
                 // - Buffer full?
-                else if (fifo->inputNdx == fifo->outputNdx) {
+                else if (fifo->inputTotal - fifo->outputTotal
+                         >= fifo->ringSize) {
                     fifo->inputState = MSDIO_IDLE;
                     fifo->fullCnt ++;
 
@@ -417,17 +432,21 @@ static unsigned char SBC_Write10(MSDLun          *lun,
             status = LUN_STATUS_SUCCESS;
         }
         else {
-          #ifdef MSDIO_WRITE10_CHUNK_SIZE
-            status = SBC_WRITE_CHUNK(lun, DWORDB(command->pLogicalBlockAddress),
-                                     fifo, MSDDriver_Callback, disktransfer);
-          #else
+
+            // Write the oldest chunk to the media
             status = LUN_Write(lun,
                                DWORDB(command->pLogicalBlockAddress),
                                &fifo->pBuffer[fifo->outputNdx],
-                               1,
+                               SBC_CHUNK_LENGTH(fifo, fifo->outputTotal)
+                                   / fifo->blockSize,
                                (TransferCallback) MSDDriver_Callback,
                                (void *) disktransfer);
-          #endif
+        }
+
+        // Media busy writing the cache back, try again
+        if (status == USBD_STATUS_LOCKED) {
+
+            break;
         }
 
         // Check operation result code
@@ -472,7 +491,7 @@ static unsigned char SBC_Write10(MSDLun          *lun,
     case MSDIO_NEXT:
     //------------------
         // Check operation result code
-        if (transfer->status != USBD_STATUS_SUCCESS) {
+        if (disktransfer->status != USBD_STATUS_SUCCESS) {
 
             TRACE_WARNING(
                 "RBC_Write10: Failed to write\n\r");
@@ -496,23 +515,15 @@ static unsigned char SBC_Write10(MSDLun          *lun,
             }
             else {
 
-                // Update output index
-              #ifdef MSDIO_WRITE10_CHUNK_SIZE
+                // Update block address and output index
+                length = SBC_CHUNK_LENGTH(fifo, fifo->outputTotal);
                 STORE_DWORDB(DWORDB(command->pLogicalBlockAddress)
-                                 + fifo->chunkSize/fifo->blockSize,
+                                 + length / fifo->blockSize,
                              command->pLogicalBlockAddress);
                 MSDIOFifo_IncNdx(fifo->outputNdx,
                                  fifo->chunkSize,
-                                 fifo->bufferSize);
-                fifo->outputTotal += fifo->chunkSize;
-              #else
-                STORE_DWORDB(DWORDB(command->pLogicalBlockAddress) + 1,
-                             command->pLogicalBlockAddress);
-                MSDIOFifo_IncNdx(fifo->outputNdx,
-                                 fifo->blockSize,
-                                 fifo->bufferSize);
-                fifo->outputTotal += fifo->blockSize;
-              #endif
+                                 fifo->ringSize);
+                fifo->outputTotal += length;
 
                 // Start Next block
                 // - All data done?
@@ -566,6 +577,7 @@ static unsigned char SBC_Read10(MSDLun          *lun,
 {
     unsigned char status;
     unsigned char result = MSDD_STATUS_INCOMPLETE;
+    unsigned int length;
     SBCRead10 *command = (SBCRead10 *) commandState->cbw.pCommand;
     MSDTransfer *transfer = &(commandState->transfer);
     MSDTransfer *disktransfer = &(commandState->disktransfer);
@@ -583,17 +595,7 @@ static unsigned char SBC_Read10(MSDLun          *lun,
         else {
 
             // Initialize FIFO
-            fifo->dataTotal = commandState->length;
-            fifo->blockSize = lun->blockSize * lun->media->blockSize;
-          #ifdef MSDIO_READ10_CHUNK_SIZE
-            if (   fifo->dataTotal >= 64*1024
-                && fifo->blockSize < MSDIO_READ10_CHUNK_SIZE)
-                fifo->chunkSize = MSDIO_READ10_CHUNK_SIZE;
-            else
-                fifo->chunkSize = fifo->blockSize;
-          #endif
-            fifo->fullCnt = 0;
-            fifo->nullCnt = 0;
+            SBCFifoInit(lun, commandState->length, fifo->readChunkSize);
 
           #ifdef MSDIO_FIFO_OFFSET
             // Enable offset if total size >= 2*bufferSize
@@ -604,14 +606,10 @@ static unsigned char SBC_Read10(MSDLun          *lun,
           #endif
 
             // Initialize FIFO output (USB)
-            fifo->outputNdx = 0;
-            fifo->outputTotal = 0;
             fifo->outputState = MSDIO_IDLE;
             transfer->semaphore = 0;
 
             // Initialize FIFO input (Disk)
-            fifo->inputNdx = 0;
-            fifo->inputTotal = 0;
             fifo->inputState = MSDIO_START;
             disktransfer->semaphore = 0;
         }
@@ -635,7 +633,7 @@ static unsigned char SBC_Read10(MSDLun          *lun,
     case MSDIO_IDLE:
     //------------------
         if (fifo->inputTotal < fifo->dataTotal &&
-            fifo->inputTotal - fifo->outputTotal < fifo->bufferSize) {
+            fifo->inputTotal - fifo->outputTotal < fifo->ringSize) {
 
             fifo->inputState = MSDIO_START;
         }
@@ -644,7 +642,7 @@ static unsigned char SBC_Read10(MSDLun          *lun,
     //------------------
     case MSDIO_START:
     //------------------
-        // Read one block of data from the media
+        // Read one chunk of data from the media
         if (lun->media->mappedRD) {
 
             // Directly write, no read needed
@@ -652,17 +650,20 @@ static unsigned char SBC_Read10(MSDLun          *lun,
             status = LUN_STATUS_SUCCESS;
         }
         else {
-          #ifdef MSDIO_READ10_CHUNK_SIZE
-            status = SBC_READ_CHUNK(lun, DWORDB(command->pLogicalBlockAddress),
-                                    fifo, MSDDriver_Callback, disktransfer);
-          #else
+
             status = LUN_Read(lun,
                               DWORDB(command->pLogicalBlockAddress),
                               &fifo->pBuffer[fifo->inputNdx],
-                              1,
+                              SBC_CHUNK_LENGTH(fifo, fifo->inputTotal)
+                                  / fifo->blockSize,
                               (TransferCallback) MSDDriver_Callback,
                               (void *)disktransfer);
-          #endif
+        }
+
+        // Media busy writing the cache back, try again
+        if (status == USBD_STATUS_LOCKED) {
+
+            break;
         }
 
         // Check operation result code
@@ -730,27 +731,16 @@ static unsigned char SBC_Read10(MSDLun          *lun,
             else {
 
                 // Update block address
-              #ifdef MSDIO_READ10_CHUNK_SIZE
+                length = SBC_CHUNK_LENGTH(fifo, fifo->inputTotal);
                 STORE_DWORDB(DWORDB(command->pLogicalBlockAddress)
-                                 + fifo->chunkSize/fifo->blockSize,
+                                 + length / fifo->blockSize,
                              command->pLogicalBlockAddress);
 
                 // Update input index
                 MSDIOFifo_IncNdx(fifo->inputNdx,
                                  fifo->chunkSize,
-                                 fifo->bufferSize);
-                fifo->inputTotal += fifo->chunkSize;
-              #else
-                // Update block address
-                STORE_DWORDB(DWORDB(command->pLogicalBlockAddress) + 1,
-                             command->pLogicalBlockAddress);
-
-                // Update input index
-                MSDIOFifo_IncNdx(fifo->inputNdx,
-                                 fifo->blockSize,
-                                 fifo->bufferSize);
-                fifo->inputTotal += fifo->blockSize;
-              #endif
+                                 fifo->ringSize);
+                fifo->inputTotal += length;
 
                 // Start Next block
                 // - All Data done?
@@ -760,7 +750,8 @@ static unsigned char SBC_Read10(MSDLun          *lun,
                     fifo->inputState = MSDIO_IDLE;
                 }
                 // - Buffer full?
-                else if (fifo->inputNdx == fifo->outputNdx) {
+                else if (fifo->inputTotal - fifo->outputTotal
+                         >= fifo->ringSize) {
 
                     TRACE_INFO_WP("dfFull%d ", fifo->inputNdx);
                     fifo->inputState = MSDIO_IDLE;
@@ -831,14 +822,11 @@ static unsigned char SBC_Read10(MSDLun          *lun,
                                 (void *) transfer);
         }
         else {
-          #ifdef MSDIO_READ10_CHUNK_SIZE
-            status = SBC_TX_CHUNK(fifo, MSDDriver_Callback, transfer);
-          #else
+
             status = MSDD_Write(&fifo->pBuffer[fifo->outputNdx],
-                                fifo->blockSize,
+                                SBC_CHUNK_LENGTH(fifo, fifo->outputTotal),
                                 (TransferCallback) MSDDriver_Callback,
                                 (void *) transfer);
-          #endif
         }
         // Check operation result code
         if (status != USBD_STATUS_SUCCESS) {
@@ -899,17 +887,10 @@ static unsigned char SBC_Read10(MSDLun          *lun,
             else {
 
                 // Update output index
-              #ifdef MSDIO_READ10_CHUNK_SIZE
+                fifo->outputTotal += SBC_CHUNK_LENGTH(fifo, fifo->outputTotal);
                 MSDIOFifo_IncNdx(fifo->outputNdx,
                                  fifo->chunkSize,
-                                 fifo->bufferSize);
-                fifo->outputTotal += fifo->chunkSize;
-              #else
-                MSDIOFifo_IncNdx(fifo->outputNdx,
-                                 fifo->blockSize,
-                                 fifo->bufferSize);
-                fifo->outputTotal += fifo->blockSize;
-              #endif
+                                 fifo->ringSize);
 
                 // Start Next block
                 // - All data done?
@@ -920,7 +901,7 @@ static unsigned char SBC_Read10(MSDLun          *lun,
                     TRACE_INFO_WP("uDone ");
                 }
                 // - Buffer Null?
-                else if (fifo->inputNdx == fifo->outputNdx) {
+                else if (fifo->outputTotal == fifo->inputTotal) {
 
                     TRACE_INFO_WP("ufNull%d ", fifo->outputNdx);
                     fifo->outputState = MSDIO_IDLE;
@@ -1221,6 +1202,7 @@ static unsigned char SBC_ModeSense6(MSDLun *lun, MSDCommandState *commandState)
     unsigned char      result = MSDD_STATUS_INCOMPLETE;
     unsigned char      status;
     MSDTransfer     *transfer = &(commandState->transfer);
+    SBCModeSense6   *command = (SBCModeSense6 *) commandState->cbw.pCommand;
 
     if (!SBCLunIsReady(lun)) {
         
@@ -1229,8 +1211,8 @@ static unsigned char SBC_ModeSense6(MSDLun *lun, MSDCommandState *commandState)
     }
 
     // Check if mode page is supported
-    if (((SBCCommand *) commandState->cbw.pCommand)->modeSense6.bPageCode
-        != SBC_PAGE_RETURN_ALL) {
+    if (command->bPageCode != SBC_PAGE_RETURN_ALL
+        && command->bPageCode != SBC_PAGE_CACHING) {
 
         return MSDD_STATUS_PARAMETER;
     }
@@ -1239,6 +1221,20 @@ static unsigned char SBC_ModeSense6(MSDLun *lun, MSDCommandState *commandState)
     if (commandState->state == 0) {
 
         commandState->state = SBC_STATE_WRITE;
+
+        // Fill the mode data, no value can be changed
+        memset(&modeSenseData, 0, sizeof(modeSenseData));
+        modeSenseData.header.bModeDataLength = sizeof(modeSenseData) - 1;
+        modeSenseData.header.bMediumType =
+            SBC_MEDIUM_TYPE_DIRECT_ACCESS_BLOCK_DEVICE;
+        modeSenseData.header.isDPOFUA = (lun->cache.numSlots != 0);
+        modeSenseData.caching.bPageCode = SBC_PAGE_CACHING;
+        modeSenseData.caching.bPageLength = sizeof(SBCCachingModePage) - 2;
+        if (command->bPC != SBC_PC_CHANGEABLE_VALUES) {
+
+            modeSenseData.caching.isRCD = 1;
+            modeSenseData.caching.isWCE = (lun->cache.numSlots != 0);
+        }
     }
 
     // Check current command state
@@ -1247,7 +1243,7 @@ static unsigned char SBC_ModeSense6(MSDLun *lun, MSDCommandState *commandState)
     case SBC_STATE_WRITE:
     //-------------------
         // Start transfer
-        status = MSDD_Write((void *) &modeParameterHeader6,
+        status = MSDD_Write((void *) &modeSenseData,
                             commandState->length,
                             (TransferCallback) MSDDriver_Callback,
                             (void *) transfer);
@@ -1339,6 +1335,13 @@ static unsigned char SBC_TestUnitReady(MSDLun *lun)
         //------------------
         case MED_STATE_BUSY:
         //------------------
+            // Busy writing the cache back, which the host needs not know
+            if (lun->cache.runState == LUN_CACHE_BUSY) {
+
+                TRACE_INFO_WP("Wb ");
+                result = MSDD_STATUS_SUCCESS;
+                break;
+            }
             TRACE_INFO_WP("Bsy ");
             senseKey = SBC_SENSE_KEY_NOT_READY;
             break;
@@ -1360,6 +1363,61 @@ static unsigned char SBC_TestUnitReady(MSDLun *lun)
     return result;
 }
 
+//------------------------------------------------------------------------------
+//! \brief  Performs a SYNCHRONIZE CACHE (10) command: the whole write-back
+//!         cache of the LUN is written to the media, whatever the range.
+//!
+//!         This function operates asynchronously and must be called multiple
+//!         times to complete. A result code of MSDD_STATUS_INCOMPLETE
+//!         indicates that at least another call of the method is necessary.
+//!         With the IMMED bit, the status is returned at once and the cache
+//!         is written back while the host is idle.
+//! \param  lun          Pointer to the LUN affected by the command
+//! \param  commandState Current state of the command
+//! \return Operation result code (SUCCESS, RW or INCOMPLETE)
+//! \see    MSDLun
+//! \see    MSDCommandState
+//------------------------------------------------------------------------------
+static unsigned char SBC_SynchronizeCache10(MSDLun          *lun,
+                                            MSDCommandState *commandState)
+{
+    SBCSynchronizeCache10 *command =
+        (SBCSynchronizeCache10 *) commandState->cbw.pCommand;
+    unsigned char status;
+
+    if (!SBCLunIsReady(lun)) {
+
+        TRACE_INFO("SBC_SynchronizeCache10: Not Ready!\n\r");
+        return MSDD_STATUS_RW;
+    }
+
+    if (command->isIMMED) {
+
+        if (lun->cache.numSlots) {
+
+            lun->cache.flushing = 1;
+        }
+        return MSDD_STATUS_SUCCESS;
+    }
+
+    status = LUN_Flush(lun);
+    if (status == USBD_STATUS_LOCKED) {
+
+        return MSDD_STATUS_INCOMPLETE;
+    }
+    else if (status != USBD_STATUS_SUCCESS) {
+
+        TRACE_WARNING("SBC_SynchronizeCache10: Cannot write media\n\r");
+        SBC_UpdateSenseData(&(lun->requestSenseData),
+                            SBC_SENSE_KEY_MEDIUM_ERROR,
+                            SBC_ASC_WRITE_ERROR,
+                            0);
+        return MSDD_STATUS_RW;
+    }
+
+    return MSDD_STATUS_SUCCESS;
+}
+
 //------------------------------------------------------------------------------
 //      Exported functions
 //------------------------------------------------------------------------------
@@ -1413,9 +1471,9 @@ unsigned char SBC_GetCommandInformation(void          *command,
     //--------------------
         (*type) = MSDD_DEVICE_TO_HOST;
         if (sbcCommand->modeSense6.bAllocationLength >
-            sizeof(SBCModeParameterHeader6)) {
+            sizeof(modeSenseData)) {
 
-            *length = sizeof(SBCModeParameterHeader6);
+            *length = sizeof(modeSenseData);
         }
         else {
 
@@ -1470,6 +1528,12 @@ unsigned char SBC_GetCommandInformation(void          *command,
     //-----------------
         (*type) = MSDD_NO_TRANSFER;
         break;
+
+    //----------------------------
+    case SBC_SYNCHRONIZE_CACHE_10:
+    //----------------------------
+        (*type) = MSDD_NO_TRANSFER;
+        break;
   #if 0
     //---------------------
     case SBC_READ_FORMAT_CAPACITIES:
@@ -1544,6 +1608,15 @@ unsigned char SBC_ProcessCommand(MSDLun               *lun,
         result = MSDD_STATUS_SUCCESS;
         break;
 
+    //----------------------------
+    case SBC_SYNCHRONIZE_CACHE_10:
+    //----------------------------
+        TRACE_INFO_WP("SyncCache(10) ");
+
+        // Write the cache back
+        result = SBC_SynchronizeCache10(lun, commandState);
+        break;
+
     //---------------
     case SBC_INQUIRY:
     //---------------